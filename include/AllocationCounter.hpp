@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+// Counts every call to the global operator new of the program.
+// Used to check that a physics step does not allocate once the buffers reached their size.
+class AllocationCounter
+{
+public:
+	static std::size_t GetCount();
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+// Reference to a body stored in a PhysicsSystem.
+// The generation changes every time a slot is reused, so a handle to a removed body is detected instead of pointing to another one.
+struct BodyHandle
+{
+	static const unsigned int InvalidIndex = 0xFFFFFFFF;
+
+	unsigned int index = InvalidIndex;
+	unsigned int generation = 0;
+
+	bool IsValid() const;
+
+	bool operator==(const BodyHandle& other) const;
+	bool operator!=(const BodyHandle& other) const;
+};
+
+// Slots mapping handles to the current dense index of their body
+class HandleTable
+{
+public:
+	HandleTable() = default;
+
+	BodyHandle Create(unsigned int denseIndex);
+	void Destroy(const BodyHandle& handle);
+	void Clear();
+	void Reserve(std::size_t capacity);
+
+	bool IsAlive(const BodyHandle& handle) const;
+	unsigned int GetDenseIndex(const BodyHandle& handle) const;
+	void SetDenseIndex(const BodyHandle& handle, unsigned int denseIndex);
+
+private:
+	struct Slot
+	{
+		unsigned int denseIndex;
+		unsigned int generation;
+	};
+
+	std::vector<Slot> m_slots;
+	std::vector<unsigned int> m_freeSlots;
+};
+
+// Removes values[index] in constant time by moving the last value into its slot
+template<typename T>
+void SwapRemove(std::vector<T>& values, std::size_t index)
+{
+	if (index + 1 != values.size())
+		values[index] = std::move(values.back());
+
+	values.pop_back();
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "Vector3.hpp"
+#include "BodyHandle.hpp"
+#include "ThreadPool.hpp"
+#include "Collision/BroadPhase.hpp"
+#include "Collision/BoundingSphere.hpp"
+#include "Collision/BoundingBox.hpp"
+
+class Plane;
+
+// Node of a BVH, nodes reference each other by their index in the BVH node array.
+template<typename Volume>
+struct BVHNode
+{
+	bool IsLeaf() const;
+
+	/* Volume encompassing all the children of this node */
+	Volume volume;
+	/* Parent of the node, or next free node while the node is in the free list */
+	int32_t parent;
+	/* Both are BVH::NullNode for a leaf */
+	int32_t children[2];
+	/* 0 for a leaf, -1 for a free node */
+	int32_t height;
+};
+
+static_assert(sizeof(BVHNode<BoundingSphere>) == 32, "BVHNode<BoundingSphere> should stay 32 bytes, two nodes per cache line");
+
+// Bounding volume hierarchy stored as a contiguous array of nodes, over BoundingSphere or BoundingBox volumes.
+// A volume type provides a constructor enclosing two volumes, Overlaps, GetGrowth, GetSurfaceArea, GetCenter,
+// GetHalfSize and GetAtPose, the volumes are stored by value in the nodes.
+// Leaves are identified by the index returned by Insert, which stays valid until the leaf is removed.
+template<typename Volume>
+class BVH : public BroadPhase
+{
+public:
+	static constexpr int32_t NullNode = -1;
+	static constexpr int BuildBinCount = 16;
+
+	BVH();
+
+	// Leaf volumes are given centered on their body and aligned with its axes, they follow its pose when the tree is refitted
+	int32_t Insert(std::shared_ptr<Primitive> primitive, const Volume& volume);
+	int32_t Insert(const BodyHandle& body, const Volume& volume);
+	// Inserts count bodies at once, writing their leaf indices into leaves when it is not null
+	void Insert(const BodyHandle* bodies, const Volume* volumes, std::size_t count, int32_t* leaves = nullptr);
+	void Remove(int32_t leaf);
+	void Remove(const int32_t* leaves, std::size_t count);
+	void Clear();
+	void Reserve(std::size_t leafCount);
+
+	// Replaces the content of the tree with a top-down build, writing the leaf indices into leaves when it is not null.
+	// Every split is chosen with the surface area heuristic over BuildBinCount bins of leaf centers
+	void Build(const std::shared_ptr<Primitive>* primitives, const Volume* volumes, std::size_t count, int32_t* leaves = nullptr);
+	void Build(const BodyHandle* bodies, const Volume* volumes, std::size_t count, int32_t* leaves = nullptr);
+	// Builds the internal nodes again over the current leaves, leaf indices stay valid
+	void Rebuild();
+
+	// Static primitives go to a second tree, built once at the current pose of their body and never refitted.
+	// Pairs between two static primitives are not reported
+	void BuildStatic(const std::shared_ptr<Primitive>* primitives, const Volume* volumes, std::size_t count, const RigidbodyStorage& rigidbodies);
+	// Infinite planes have no bounding volume, the dynamic volumes are tested against the plane itself
+	void AddStaticPlane(std::shared_ptr<Plane> plane);
+	void ClearStatic();
+	std::size_t GetStaticLeafCount() const;
+	std::size_t GetStaticPlaneCount() const;
+
+	// Moves the leaves to the current pose of their body and recomputes the volumes of the internal nodes
+	void Refit(const RigidbodyStorage& rigidbodies);
+	// Also rebuilds the tree once its cost went past the rebuild threshold
+	void Update(const RigidbodyStorage& rigidbodies) override;
+
+	// Update rebuilds the tree when GetCost exceeds the cost right after the last build by this ratio, 0 disables it
+	void SetRebuildThreshold(float ratio);
+	float GetRebuildThreshold() const;
+	// Surface area heuristic cost of the tree: summed area of the internal nodes relative to the area of the root.
+	// The sum is kept up to date as the volumes change, so this is constant time
+	float GetCost() const;
+
+	// Every pair of overlapping leaves, in the same order whatever the thread count
+	unsigned int GetPotentialContact(PotentialContact* contacts, unsigned int limit) const override;
+	unsigned int GetPotentialContactPrimitive(PotentialContactPrimitive* contacts, unsigned int limit) const override;
+
+	// Threads sharing the pair search, including the calling one. 1 searches on the calling thread
+	void SetThreadCount(unsigned int threadCount);
+	unsigned int GetThreadCount() const;
+
+	int32_t GetRoot() const;
+	const BVHNode<Volume>& GetNode(int32_t node) const;
+	const Volume& GetVolume(int32_t node) const;
+	std::size_t GetLeafCount() const;
+	Primitive* GetPrimitive(int32_t leaf) const;
+	BodyHandle GetBody(int32_t leaf) const;
+
+private:
+	// Pair searches are split in about this many tasks, on trees of at least ParallelLeafCount leaves
+	static constexpr std::size_t ParallelTaskCount = 64;
+	static constexpr std::size_t ParallelLeafCount = 1024;
+
+	// Data only read when a leaf is reported or refitted, kept out of the nodes
+	struct Leaf
+	{
+		std::shared_ptr<Primitive> primitive;
+		BodyHandle body;
+		/* Volume as given to Insert, placed at the pose of the body by Refit */
+		Volume volume;
+	};
+
+	// Axis aligned bounds of the leaves of a build bin
+	struct BuildBin
+	{
+		Vector3f min;
+		Vector3f max;
+		unsigned int count;
+	};
+
+	// Leaves of the tree still to be split by BuildTree, and the node they hang from
+	struct BuildRange
+	{
+		std::size_t begin;
+		std::size_t end;
+		int32_t parent;
+		int childIndex;
+	};
+
+	// Subtrees still to search for pairs, nodes[1] is NullNode for the pairs inside nodes[0].
+	// Entries of the search stack, and the tasks of a parallel search
+	struct NodePair
+	{
+		int32_t nodes[2];
+	};
+
+	// Leaf pairs found by one task, kept between searches so the buffers stop allocating once they fit
+	struct PairTaskResult
+	{
+		std::vector<std::array<int32_t, 2>> pairs;
+		std::vector<NodePair> stack;
+		bool isTruncated;
+	};
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t node);
+	int32_t CreateLeaf(const Leaf& leaf, const Volume& volume);
+	int32_t InsertLeaf(const Leaf& leaf, const Volume& volume);
+	// Builds the internal nodes over m_buildLeaves
+	void BuildTree();
+	// Reorders the leaves of [begin, end) around the cheapest split and returns the first leaf of the second half
+	std::size_t PartitionLeaves(std::size_t begin, std::size_t end);
+	static float GetAxisValue(const Vector3f& vector, int axis);
+	static float GetSurfaceArea(const Vector3f& min, const Vector3f& max);
+	// Also keeps m_internalArea up to date
+	void UpdateVolume(int32_t node);
+
+	bool Overlaps(int32_t nodeA, int32_t nodeB) const;
+	static bool IsReported(const Leaf& leafA, const Leaf& leafB, bool primitivesOnly);
+	// Calls report(leafA, leafB) with the Leaf of both sides for every overlapping pair until it returns false:
+	// dynamic pairs first, then dynamic leaves against the static tree and against the static planes.
+	// Leaves without a primitive are skipped when primitivesOnly is set
+	template<typename Report>
+	void QueryAllPairs(const Report& report, unsigned int limit, bool primitivesOnly) const;
+	// Pairs of dynamic leaves, false once report returned false or a task was truncated
+	template<typename Report>
+	bool QueryDynamicPairs(const Report& report, unsigned int limit, bool primitivesOnly) const;
+	// Pairs of leaves under start, its first node in this tree and its second one in treeB, report takes leaf indices.
+	// The search runs on stack, which is sized from the height of both subtrees and only grows past that as a safeguard
+	template<typename Report>
+	bool QueryPairs(const NodePair& start, const BVH& treeB, std::vector<NodePair>& stack, const Report& report) const;
+	// Leaves on the back side of the plane, or touching it
+	template<typename Report>
+	bool QueryHalfSpace(const Vector3f& normal, float offset, std::vector<NodePair>& stack, const Report& report) const;
+	// Splits the search from the root into m_pairTasks, in the order QueryPairs visits them
+	void BuildPairTasks() const;
+
+	std::vector<BVHNode<Volume>> m_nodes;
+	// Same size as m_nodes, only meaningful for leaves
+	std::vector<Leaf> m_leaves;
+	int32_t m_root;
+	int32_t m_freeList;
+	std::size_t m_leafCount;
+
+	float m_rebuildThreshold;
+	float m_builtCost;
+	// Summed surface area of the internal nodes, the numerator of GetCost
+	float m_internalArea;
+	// Kept between builds so a rebuild does not allocate
+	std::vector<int32_t> m_buildLeaves;
+	std::vector<BuildRange> m_buildStack;
+	// Internal nodes in creation order, parents come before their children
+	std::vector<int32_t> m_buildNodes;
+	// Nodes still to refit, kept between steps so Refit does not allocate
+	std::vector<int32_t> m_refitStack;
+
+	// Never refitted, null until BuildStatic is called
+	std::unique_ptr<BVH> m_staticTree;
+	std::vector<Leaf> m_staticPlanes;
+
+	std::unique_ptr<ThreadPool> m_threadPool;
+	mutable std::vector<NodePair> m_pairTasks;
+	mutable std::vector<NodePair> m_nextPairTasks;
+	mutable std::vector<PairTaskResult> m_pairTaskResults;
+	// Search stack of the calling thread
+	mutable std::vector<NodePair> m_searchStack;
+};
+
+#include "Collision/BVH.inl"
\ No newline at end of file
@@ -0,0 +1,941 @@
+#include <algorithm>
+#include <limits>
+#include "Collision/BVH.hpp"
+#include "Collision/Primitives/Primitive.hpp"
+#include "Collision/Primitives/Plane.hpp"
+#include "RigidbodyStorage.hpp"
+
+template<typename Volume>
+bool BVHNode<Volume>::IsLeaf() const
+{
+	return children[0] == BVH<Volume>::NullNode;
+}
+
+template<typename Volume>
+float BVH<Volume>::GetAxisValue(const Vector3f& vector, int axis)
+{
+	return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+}
+
+template<typename Volume>
+float BVH<Volume>::GetSurfaceArea(const Vector3f& min, const Vector3f& max)
+{
+	Vector3f size = max - min;
+	return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+template<typename Volume>
+BVH<Volume>::BVH() :
+	m_root(NullNode),
+	m_freeList(NullNode),
+	m_leafCount(0),
+	m_rebuildThreshold(0.0f),
+	m_builtCost(0.0f),
+	m_internalArea(0.0f)
+{
+}
+
+template<typename Volume>
+int32_t BVH<Volume>::Insert(std::shared_ptr<Primitive> primitive, const Volume& volume)
+{
+	Leaf leaf;
+	leaf.body = primitive->body;
+	leaf.primitive = primitive;
+
+	return InsertLeaf(leaf, volume);
+}
+
+template<typename Volume>
+int32_t BVH<Volume>::Insert(const BodyHandle& body, const Volume& volume)
+{
+	Leaf leaf;
+	leaf.body = body;
+
+	return InsertLeaf(leaf, volume);
+}
+
+template<typename Volume>
+void BVH<Volume>::Insert(const BodyHandle* bodies, const Volume* volumes, std::size_t count, int32_t* leaves /*= nullptr*/)
+{
+	// Grow geometrically so repeated bulk inserts of a few bodies stay amortized
+	std::size_t nodeCount = (m_leafCount + count) * 2;
+	if (nodeCount > m_nodes.capacity())
+		Reserve(std::max(nodeCount, m_nodes.capacity() * 2) / 2);
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		int32_t leaf = Insert(bodies[i], volumes[i]);
+		if (leaves != nullptr)
+			leaves[i] = leaf;
+	}
+}
+
+template<typename Volume>
+void BVH<Volume>::Remove(int32_t leaf)
+{
+	int32_t parent = m_nodes[leaf].parent;
+
+	m_leaves[leaf] = Leaf();
+	FreeNode(leaf);
+	m_leafCount--;
+
+	if (leaf == m_root)
+	{
+		m_root = NullNode;
+		return;
+	}
+
+	// The sibling takes the place of the parent
+	int32_t sibling = m_nodes[parent].children[0] == leaf ? m_nodes[parent].children[1] : m_nodes[parent].children[0];
+	int32_t grandParent = m_nodes[parent].parent;
+
+	m_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NullNode)
+	{
+		m_root = sibling;
+		return;
+	}
+
+	BVHNode<Volume>& grandParentNode = m_nodes[grandParent];
+	grandParentNode.children[grandParentNode.children[0] == parent ? 0 : 1] = sibling;
+
+	for (int32_t node = grandParent; node != NullNode; node = m_nodes[node].parent)
+		UpdateVolume(node);
+}
+
+template<typename Volume>
+void BVH<Volume>::Remove(const int32_t* leaves, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		Remove(leaves[i]);
+}
+
+template<typename Volume>
+void BVH<Volume>::Clear()
+{
+	m_nodes.clear();
+	m_leaves.clear();
+	m_root = NullNode;
+	m_freeList = NullNode;
+	m_leafCount = 0;
+	m_builtCost = 0.0f;
+	m_internalArea = 0.0f;
+}
+
+template<typename Volume>
+void BVH<Volume>::Reserve(std::size_t leafCount)
+{
+	// A binary tree with n leaves has 2n - 1 nodes
+	m_nodes.reserve(leafCount * 2);
+	m_leaves.reserve(leafCount * 2);
+}
+
+template<typename Volume>
+void BVH<Volume>::Build(const std::shared_ptr<Primitive>* primitives, const Volume* volumes, std::size_t count, int32_t* leaves /*= nullptr*/)
+{
+	Clear();
+	Reserve(count);
+
+	m_buildLeaves.clear();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		Leaf leaf;
+		leaf.body = primitives[i]->body;
+		leaf.primitive = primitives[i];
+
+		int32_t node = CreateLeaf(leaf, volumes[i]);
+		m_buildLeaves.push_back(node);
+		if (leaves != nullptr)
+			leaves[i] = node;
+	}
+
+	BuildTree();
+}
+
+template<typename Volume>
+void BVH<Volume>::Build(const BodyHandle* bodies, const Volume* volumes, std::size_t count, int32_t* leaves /*= nullptr*/)
+{
+	Clear();
+	Reserve(count);
+
+	m_buildLeaves.clear();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		Leaf leaf;
+		leaf.body = bodies[i];
+
+		int32_t node = CreateLeaf(leaf, volumes[i]);
+		m_buildLeaves.push_back(node);
+		if (leaves != nullptr)
+			leaves[i] = node;
+	}
+
+	BuildTree();
+}
+
+template<typename Volume>
+void BVH<Volume>::Rebuild()
+{
+	// Leaves keep their node, the internal nodes go back to the free list and are reused by the build
+	m_buildLeaves.clear();
+	for (int32_t node = 0; node < static_cast<int32_t>(m_nodes.size()); ++node)
+	{
+		if (m_nodes[node].height == 0)
+			m_buildLeaves.push_back(node);
+		else if (m_nodes[node].height > 0)
+			FreeNode(node);
+	}
+
+	BuildTree();
+}
+
+template<typename Volume>
+void BVH<Volume>::BuildStatic(const std::shared_ptr<Primitive>* primitives, const Volume* volumes, std::size_t count, const RigidbodyStorage& rigidbodies)
+{
+	if (!m_staticTree)
+		m_staticTree = std::make_unique<BVH>();
+
+	// Placed once here, the static tree is never refitted
+	std::vector<Volume> staticVolumes(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const BodyHandle& body = primitives[i]->body;
+		staticVolumes[i] = rigidbodies.IsValid(body) ? volumes[i].GetAtPose(rigidbodies.transformMatrices[rigidbodies.GetIndex(body)]) : volumes[i];
+	}
+
+	m_staticTree->Build(primitives, staticVolumes.data(), count);
+}
+
+template<typename Volume>
+void BVH<Volume>::AddStaticPlane(std::shared_ptr<Plane> plane)
+{
+	Leaf leaf;
+	leaf.body = plane->body;
+	leaf.primitive = plane;
+
+	m_staticPlanes.push_back(leaf);
+}
+
+template<typename Volume>
+void BVH<Volume>::ClearStatic()
+{
+	m_staticTree.reset();
+	m_staticPlanes.clear();
+}
+
+template<typename Volume>
+std::size_t BVH<Volume>::GetStaticLeafCount() const
+{
+	return m_staticTree ? m_staticTree->GetLeafCount() : 0;
+}
+
+template<typename Volume>
+std::size_t BVH<Volume>::GetStaticPlaneCount() const
+{
+	return m_staticPlanes.size();
+}
+
+template<typename Volume>
+void BVH<Volume>::Refit(const RigidbodyStorage& rigidbodies)
+{
+	if (m_root == NullNode)
+		return;
+
+	// An internal node is pushed once to visit its children, then complemented to update its volume after theirs
+	m_refitStack.clear();
+	m_refitStack.push_back(m_root);
+	while (!m_refitStack.empty())
+	{
+		int32_t node = m_refitStack.back();
+		m_refitStack.pop_back();
+
+		if (node < 0)
+		{
+			UpdateVolume(~node);
+			continue;
+		}
+
+		BVHNode<Volume>& current = m_nodes[node];
+		if (current.IsLeaf())
+		{
+			unsigned int index = rigidbodies.GetIndex(m_leaves[node].body);
+			if (index != BodyHandle::InvalidIndex)
+				current.volume = m_leaves[node].volume.GetAtPose(rigidbodies.transformMatrices[index]);
+			continue;
+		}
+
+		m_refitStack.push_back(~node);
+		m_refitStack.push_back(current.children[1]);
+		m_refitStack.push_back(current.children[0]);
+	}
+}
+
+template<typename Volume>
+void BVH<Volume>::Update(const RigidbodyStorage& rigidbodies)
+{
+	Refit(rigidbodies);
+
+	// A tree only grown by Insert has no reference cost yet, its first check builds it
+	if (m_rebuildThreshold > 0.0f && m_leafCount > 2 && (m_builtCost == 0.0f || GetCost() > m_builtCost * m_rebuildThreshold))
+		Rebuild();
+}
+
+template<typename Volume>
+void BVH<Volume>::SetRebuildThreshold(float ratio)
+{
+	m_rebuildThreshold = ratio;
+}
+
+template<typename Volume>
+float BVH<Volume>::GetRebuildThreshold() const
+{
+	return m_rebuildThreshold;
+}
+
+template<typename Volume>
+float BVH<Volume>::GetCost() const
+{
+	if (m_root == NullNode || m_nodes[m_root].volume.GetSurfaceArea() <= 0.0f)
+		return 0.0f;
+
+	return m_internalArea / m_nodes[m_root].volume.GetSurfaceArea();
+}
+
+template<typename Volume>
+unsigned int BVH<Volume>::GetPotentialContact(PotentialContact* contacts, unsigned int limit) const
+{
+	unsigned int count = 0;
+	m_truncated = false;
+
+	auto report = [&](const Leaf& leafA, const Leaf& leafB)
+	{
+		// One pair past the limit is enough to know some were left out
+		if (count >= limit)
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		contacts[count].bodies[0] = leafA.body;
+		contacts[count].bodies[1] = leafB.body;
+		++count;
+		return true;
+	};
+
+	QueryAllPairs(report, limit, false);
+	return count;
+}
+
+template<typename Volume>
+unsigned int BVH<Volume>::GetPotentialContactPrimitive(PotentialContactPrimitive* contacts, unsigned int limit) const
+{
+	unsigned int count = 0;
+	m_truncated = false;
+
+	auto report = [&](const Leaf& leafA, const Leaf& leafB)
+	{
+		if (count >= limit)
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		contacts[count].primitives[0] = leafA.primitive.get();
+		contacts[count].primitives[1] = leafB.primitive.get();
+		++count;
+		return true;
+	};
+
+	// Leaves inserted without a primitive only take part in body pairs
+	QueryAllPairs(report, limit, true);
+	return count;
+}
+
+template<typename Volume>
+void BVH<Volume>::SetThreadCount(unsigned int threadCount)
+{
+	if (threadCount <= 1)
+		m_threadPool.reset();
+	else if (!m_threadPool || m_threadPool->GetThreadCount() != threadCount)
+		m_threadPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+template<typename Volume>
+unsigned int BVH<Volume>::GetThreadCount() const
+{
+	return m_threadPool ? m_threadPool->GetThreadCount() : 1;
+}
+
+template<typename Volume>
+int32_t BVH<Volume>::GetRoot() const
+{
+	return m_root;
+}
+
+template<typename Volume>
+const BVHNode<Volume>& BVH<Volume>::GetNode(int32_t node) const
+{
+	return m_nodes[node];
+}
+
+template<typename Volume>
+const Volume& BVH<Volume>::GetVolume(int32_t node) const
+{
+	return m_nodes[node].volume;
+}
+
+template<typename Volume>
+std::size_t BVH<Volume>::GetLeafCount() const
+{
+	return m_leafCount;
+}
+
+template<typename Volume>
+Primitive* BVH<Volume>::GetPrimitive(int32_t leaf) const
+{
+	return m_leaves[leaf].primitive.get();
+}
+
+template<typename Volume>
+BodyHandle BVH<Volume>::GetBody(int32_t leaf) const
+{
+	return m_leaves[leaf].body;
+}
+
+template<typename Volume>
+int32_t BVH<Volume>::AllocateNode()
+{
+	int32_t node;
+
+	if (m_freeList != NullNode)
+	{
+		node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+	}
+	else
+	{
+		node = static_cast<int32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_leaves.emplace_back();
+	}
+
+	BVHNode<Volume>& newNode = m_nodes[node];
+	newNode.volume = Volume();
+	newNode.parent = NullNode;
+	newNode.children[0] = NullNode;
+	newNode.children[1] = NullNode;
+	newNode.height = 0;
+
+	return node;
+}
+
+template<typename Volume>
+void BVH<Volume>::FreeNode(int32_t node)
+{
+	if (m_nodes[node].height > 0)
+		m_internalArea -= m_nodes[node].volume.GetSurfaceArea();
+
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+template<typename Volume>
+int32_t BVH<Volume>::CreateLeaf(const Leaf& leaf, const Volume& volume)
+{
+	int32_t newLeaf = AllocateNode();
+	m_nodes[newLeaf].volume = volume;
+	m_leaves[newLeaf] = leaf;
+	m_leaves[newLeaf].volume = volume;
+	m_leafCount++;
+
+	return newLeaf;
+}
+
+template<typename Volume>
+int32_t BVH<Volume>::InsertLeaf(const Leaf& leaf, const Volume& volume)
+{
+	int32_t newLeaf = CreateLeaf(leaf, volume);
+
+	if (m_root == NullNode)
+	{
+		m_root = newLeaf;
+		return newLeaf;
+	}
+
+	// Go down to the leaf whose volume grows the least
+	int32_t sibling = m_root;
+	while (!m_nodes[sibling].IsLeaf())
+	{
+		const BVHNode<Volume>& node = m_nodes[sibling];
+
+		if (m_nodes[node.children[0]].volume.GetGrowth(volume) < m_nodes[node.children[1]].volume.GetGrowth(volume))
+			sibling = node.children[0];
+		else
+			sibling = node.children[1];
+	}
+
+	// A new internal node takes the place of the leaf, with the leaf and the new one as children
+	int32_t oldParent = m_nodes[sibling].parent;
+	int32_t newParent = AllocateNode();
+
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].children[0] = sibling;
+	m_nodes[newParent].children[1] = newLeaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[newLeaf].parent = newParent;
+
+	if (oldParent == NullNode)
+		m_root = newParent;
+	else
+		m_nodes[oldParent].children[m_nodes[oldParent].children[0] == sibling ? 0 : 1] = newParent;
+
+	for (int32_t node = newParent; node != NullNode; node = m_nodes[node].parent)
+		UpdateVolume(node);
+
+	return newLeaf;
+}
+
+template<typename Volume>
+void BVH<Volume>::BuildTree()
+{
+	m_root = NullNode;
+	m_builtCost = 0.0f;
+	// Every internal node was freed before the build, this also drops the rounding the updates accumulated
+	m_internalArea = 0.0f;
+	m_buildNodes.clear();
+	m_buildStack.clear();
+
+	if (m_buildLeaves.empty())
+		return;
+
+	m_buildStack.push_back({ 0, m_buildLeaves.size(), NullNode, 0 });
+	while (!m_buildStack.empty())
+	{
+		BuildRange range = m_buildStack.back();
+		m_buildStack.pop_back();
+
+		int32_t node;
+		if (range.end - range.begin == 1)
+		{
+			node = m_buildLeaves[range.begin];
+		}
+		else
+		{
+			node = AllocateNode();
+			m_buildNodes.push_back(node);
+
+			std::size_t middle = PartitionLeaves(range.begin, range.end);
+			m_buildStack.push_back({ middle, range.end, node, 1 });
+			m_buildStack.push_back({ range.begin, middle, node, 0 });
+		}
+
+		m_nodes[node].parent = range.parent;
+		if (range.parent == NullNode)
+			m_root = node;
+		else
+			m_nodes[range.parent].children[range.childIndex] = node;
+	}
+
+	// Walking the internal nodes backwards computes every volume after the volumes it encloses
+	for (auto node = m_buildNodes.rbegin(); node != m_buildNodes.rend(); ++node)
+		UpdateVolume(*node);
+
+	m_builtCost = GetCost();
+}
+
+template<typename Volume>
+std::size_t BVH<Volume>::PartitionLeaves(std::size_t begin, std::size_t end)
+{
+	// Split along the axis on which the leaf centers are the most spread out
+	Vector3f centerMin = m_nodes[m_buildLeaves[begin]].volume.GetCenter();
+	Vector3f centerMax = centerMin;
+	for (std::size_t i = begin + 1; i < end; ++i)
+	{
+		Vector3f center = m_nodes[m_buildLeaves[i]].volume.GetCenter();
+		centerMin = Vector3f::Min(centerMin, center);
+		centerMax = Vector3f::Max(centerMax, center);
+	}
+
+	Vector3f extent = centerMax - centerMin;
+	int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+	float axisMin = GetAxisValue(centerMin, axis);
+	float axisExtent = GetAxisValue(extent, axis);
+
+	// Every leaf is at the same place, any split is as good as another
+	if (axisExtent <= 0.0f)
+		return begin + (end - begin) / 2;
+
+	const float binScale = BuildBinCount / axisExtent;
+	auto getBin = [&](int32_t leaf)
+	{
+		int bin = static_cast<int>((GetAxisValue(m_nodes[leaf].volume.GetCenter(), axis) - axisMin) * binScale);
+		return std::min(bin, BuildBinCount - 1);
+	};
+
+	const float infinity = std::numeric_limits<float>::infinity();
+	BuildBin bins[BuildBinCount];
+	for (BuildBin& bin : bins)
+	{
+		bin.min = Vector3f(infinity, infinity, infinity);
+		bin.max = Vector3f(-infinity, -infinity, -infinity);
+		bin.count = 0;
+	}
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		const Volume& leaf = m_nodes[m_buildLeaves[i]].volume;
+		BuildBin& bin = bins[getBin(m_buildLeaves[i])];
+
+		bin.min = Vector3f::Min(bin.min, leaf.GetCenter() - leaf.GetHalfSize());
+		bin.max = Vector3f::Max(bin.max, leaf.GetCenter() + leaf.GetHalfSize());
+		bin.count++;
+	}
+
+	// Cost of the bins after every split, swept from the right. Empty bins have inverted bounds and leave the sums unchanged
+	float rightCosts[BuildBinCount];
+	Vector3f boundsMin = bins[BuildBinCount - 1].min;
+	Vector3f boundsMax = bins[BuildBinCount - 1].max;
+	unsigned int count = bins[BuildBinCount - 1].count;
+	for (int bin = BuildBinCount - 2; bin >= 0; --bin)
+	{
+		rightCosts[bin + 1] = GetSurfaceArea(boundsMin, boundsMax) * count;
+		boundsMin = Vector3f::Min(boundsMin, bins[bin].min);
+		boundsMax = Vector3f::Max(boundsMax, bins[bin].max);
+		count += bins[bin].count;
+	}
+
+	// The first and last bins hold the extreme centers, so both halves of every split are non empty
+	int bestSplit = 0;
+	float bestCost = infinity;
+	boundsMin = bins[0].min;
+	boundsMax = bins[0].max;
+	count = bins[0].count;
+	for (int bin = 0; bin < BuildBinCount - 1; ++bin)
+	{
+		if (bin > 0)
+		{
+			boundsMin = Vector3f::Min(boundsMin, bins[bin].min);
+			boundsMax = Vector3f::Max(boundsMax, bins[bin].max);
+			count += bins[bin].count;
+		}
+
+		float cost = GetSurfaceArea(boundsMin, boundsMax) * count + rightCosts[bin + 1];
+		if (cost < bestCost)
+		{
+			bestCost = cost;
+			bestSplit = bin;
+		}
+	}
+
+	auto middle = std::partition(m_buildLeaves.begin() + begin, m_buildLeaves.begin() + end, [&](int32_t leaf) { return getBin(leaf) <= bestSplit; });
+	return static_cast<std::size_t>(middle - m_buildLeaves.begin());
+}
+
+template<typename Volume>
+void BVH<Volume>::UpdateVolume(int32_t node)
+{
+	BVHNode<Volume>& current = m_nodes[node];
+
+	// A node allocated for the build or an insertion has a height of 0 until its first update
+	if (current.height > 0)
+		m_internalArea -= current.volume.GetSurfaceArea();
+
+	current.volume = Volume(m_nodes[current.children[0]].volume, m_nodes[current.children[1]].volume);
+	current.height = 1 + std::max(m_nodes[current.children[0]].height, m_nodes[current.children[1]].height);
+	m_internalArea += current.volume.GetSurfaceArea();
+}
+
+template<typename Volume>
+bool BVH<Volume>::Overlaps(int32_t nodeA, int32_t nodeB) const
+{
+	return m_nodes[nodeA].volume.Overlaps(m_nodes[nodeB].volume);
+}
+
+template<typename Volume>
+bool BVH<Volume>::IsReported(const Leaf& leafA, const Leaf& leafB, bool primitivesOnly)
+{
+	return !primitivesOnly || (leafA.primitive != nullptr && leafB.primitive != nullptr);
+}
+
+template<typename Volume>
+template<typename Report>
+void BVH<Volume>::QueryAllPairs(const Report& report, unsigned int limit, bool primitivesOnly) const
+{
+	if (m_root == NullNode || !QueryDynamicPairs(report, limit, primitivesOnly))
+		return;
+
+	// One traversal of both trees, the static leaves are never compared with each other
+	if (m_staticTree && m_staticTree->m_root != NullNode)
+	{
+		bool isComplete = QueryPairs({ { m_root, m_staticTree->m_root } }, *m_staticTree, m_searchStack, [&](int32_t leafA, int32_t leafB)
+			{
+				const Leaf& leaf = m_leaves[leafA];
+				const Leaf& staticLeaf = m_staticTree->m_leaves[leafB];
+				return !IsReported(leaf, staticLeaf, primitivesOnly) || report(leaf, staticLeaf);
+			});
+
+		if (!isComplete)
+			return;
+	}
+
+	for (const Leaf& planeLeaf : m_staticPlanes)
+	{
+		const Plane& plane = static_cast<const Plane&>(*planeLeaf.primitive);
+
+		bool isComplete = QueryHalfSpace(plane.normal, plane.offset, m_searchStack, [&](int32_t leaf)
+			{
+				return !IsReported(m_leaves[leaf], planeLeaf, primitivesOnly) || report(m_leaves[leaf], planeLeaf);
+			});
+
+		if (!isComplete)
+			return;
+	}
+}
+
+template<typename Volume>
+template<typename Report>
+bool BVH<Volume>::QueryDynamicPairs(const Report& report, unsigned int limit, bool primitivesOnly) const
+{
+	if (!m_threadPool || m_leafCount < ParallelLeafCount)
+	{
+		return QueryPairs({ { m_root, NullNode } }, *this, m_searchStack, [&](int32_t leafA, int32_t leafB)
+			{
+				return !IsReported(m_leaves[leafA], m_leaves[leafB], primitivesOnly) || report(m_leaves[leafA], m_leaves[leafB]);
+			});
+	}
+
+	// Every task only reads the tree and fills its own buffer, the buffers are then reported in task order.
+	// The tasks come in the order of the search from the root, so the pairs are the same as on a single thread.
+	BuildPairTasks();
+	if (m_pairTaskResults.size() < m_pairTasks.size())
+		m_pairTaskResults.resize(m_pairTasks.size());
+
+	m_threadPool->ParallelFor(m_pairTasks.size(), 1, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				const NodePair& task = m_pairTasks[i];
+				PairTaskResult& result = m_pairTaskResults[i];
+				result.pairs.clear();
+				result.isTruncated = false;
+
+				// No task can add more than limit pairs to the result
+				auto collect = [&](int32_t leafA, int32_t leafB)
+				{
+					if (!IsReported(m_leaves[leafA], m_leaves[leafB], primitivesOnly))
+						return true;
+
+					if (result.pairs.size() >= limit)
+					{
+						result.isTruncated = true;
+						return false;
+					}
+
+					result.pairs.push_back({ leafA, leafB });
+					return true;
+				};
+
+				QueryPairs(task, *this, result.stack, collect);
+			}
+		});
+
+	for (std::size_t i = 0; i < m_pairTasks.size(); ++i)
+	{
+		const PairTaskResult& result = m_pairTaskResults[i];
+
+		for (const std::array<int32_t, 2>& pair : result.pairs)
+		{
+			if (!report(m_leaves[pair[0]], m_leaves[pair[1]]))
+				return false;
+		}
+
+		// All its pairs were reported, so the limit is reached and the rest is left out
+		if (result.isTruncated)
+		{
+			m_truncated = true;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename Volume>
+template<typename Report>
+bool BVH<Volume>::QueryPairs(const NodePair& start, const BVH& treeB, std::vector<NodePair>& stack, const Report& report) const
+{
+	// A pair search keeps at most one pending pair per level of both subtrees. A search inside a subtree also keeps
+	// two entries per level on its way down, then at most the pending pairs of the search between two children
+	int32_t heightA = m_nodes[start.nodes[0]].height;
+	int32_t heightB = start.nodes[1] == NullNode ? heightA : treeB.m_nodes[start.nodes[1]].height;
+	std::size_t stackSize = 2 * static_cast<std::size_t>(heightA + heightB) + 2;
+	if (stack.size() < stackSize)
+		stack.resize(stackSize);
+
+	const BVHNode<Volume>* const nodesA = m_nodes.data();
+	const BVHNode<Volume>* const nodesB = treeB.m_nodes.data();
+
+	if (start.nodes[1] != NullNode && !nodesA[start.nodes[0]].volume.Overlaps(nodesB[start.nodes[1]].volume))
+		return true;
+
+	NodePair* bottom = stack.data();
+	NodePair* top = bottom;
+	*top++ = start;
+
+	// Entries are pushed in reverse so they come out in the order of a depth first search.
+	// Pairs of nodes are only pushed when their volumes overlap
+	while (top != bottom)
+	{
+		// Popping an entry pushes at most three, the stack grows if the bound from the heights ever falls short
+		if (static_cast<std::size_t>(top - bottom) + 2 > stack.size())
+		{
+			const std::ptrdiff_t count = top - bottom;
+			stack.resize(stack.size() * 2);
+			bottom = stack.data();
+			top = bottom + count;
+		}
+
+		const NodePair pair = *--top;
+		const BVHNode<Volume>& a = nodesA[pair.nodes[0]];
+
+		if (pair.nodes[1] == NullNode)
+		{
+			// A leaf has no pair inside it
+			if (a.IsLeaf())
+				continue;
+
+			if (nodesA[a.children[0]].volume.Overlaps(nodesA[a.children[1]].volume))
+				*top++ = { { a.children[0], a.children[1] } };
+			*top++ = { { a.children[1], NullNode } };
+			*top++ = { { a.children[0], NullNode } };
+			continue;
+		}
+
+		const BVHNode<Volume>& b = nodesB[pair.nodes[1]];
+
+		if (a.IsLeaf() && b.IsLeaf())
+		{
+			if (!report(pair.nodes[0], pair.nodes[1]))
+				return false;
+			continue;
+		}
+
+		// Descend into the larger volume
+		if (b.IsLeaf() || (!a.IsLeaf() && a.volume.GetSurfaceArea() >= b.volume.GetSurfaceArea()))
+		{
+			if (nodesA[a.children[1]].volume.Overlaps(b.volume))
+				*top++ = { { a.children[1], pair.nodes[1] } };
+			if (nodesA[a.children[0]].volume.Overlaps(b.volume))
+				*top++ = { { a.children[0], pair.nodes[1] } };
+		}
+		else
+		{
+			if (a.volume.Overlaps(nodesB[b.children[1]].volume))
+				*top++ = { { pair.nodes[0], b.children[1] } };
+			if (a.volume.Overlaps(nodesB[b.children[0]].volume))
+				*top++ = { { pair.nodes[0], b.children[0] } };
+		}
+	}
+
+	return true;
+}
+
+template<typename Volume>
+template<typename Report>
+bool BVH<Volume>::QueryHalfSpace(const Vector3f& normal, float offset, std::vector<NodePair>& stack, const Report& report) const
+{
+	// One pending sibling per level
+	std::size_t stackSize = static_cast<std::size_t>(m_nodes[m_root].height) + 1;
+	if (stack.size() < stackSize)
+		stack.resize(stackSize);
+
+	NodePair* const bottom = stack.data();
+	NodePair* top = bottom;
+	*top++ = { { m_root, NullNode } };
+
+	while (top != bottom)
+	{
+		int32_t node = (--top)->nodes[0];
+		const BVHNode<Volume>& n = m_nodes[node];
+
+		if (!n.volume.OverlapsHalfSpace(normal, offset))
+			continue;
+
+		if (n.IsLeaf())
+		{
+			if (!report(node))
+				return false;
+			continue;
+		}
+
+		*top++ = { { n.children[1], NullNode } };
+		*top++ = { { n.children[0], NullNode } };
+	}
+
+	return true;
+}
+
+template<typename Volume>
+void BVH<Volume>::BuildPairTasks() const
+{
+	m_pairTasks.clear();
+	m_pairTasks.push_back({ { m_root, NullNode } });
+
+	// Each pass replaces every task by the entries QueryPairs would push for it, in the order it pops them
+	bool isSplit = true;
+	while (isSplit && m_pairTasks.size() < ParallelTaskCount)
+	{
+		isSplit = false;
+		m_nextPairTasks.clear();
+
+		for (const NodePair& task : m_pairTasks)
+		{
+			const BVHNode<Volume>& a = m_nodes[task.nodes[0]];
+
+			if (task.nodes[1] == NullNode)
+			{
+				// A leaf has no pair inside it
+				if (a.IsLeaf())
+					continue;
+
+				m_nextPairTasks.push_back({ { a.children[0], NullNode } });
+				m_nextPairTasks.push_back({ { a.children[1], NullNode } });
+				if (Overlaps(a.children[0], a.children[1]))
+					m_nextPairTasks.push_back({ { a.children[0], a.children[1] } });
+				isSplit = true;
+				continue;
+			}
+
+			const BVHNode<Volume>& b = m_nodes[task.nodes[1]];
+
+			if (a.IsLeaf() && b.IsLeaf())
+			{
+				m_nextPairTasks.push_back(task);
+				continue;
+			}
+
+			if (b.IsLeaf() || (!a.IsLeaf() && a.volume.GetSurfaceArea() >= b.volume.GetSurfaceArea()))
+			{
+				for (int32_t child : a.children)
+				{
+					if (Overlaps(child, task.nodes[1]))
+						m_nextPairTasks.push_back({ { child, task.nodes[1] } });
+				}
+			}
+			else
+			{
+				for (int32_t child : b.children)
+				{
+					if (Overlaps(task.nodes[0], child))
+						m_nextPairTasks.push_back({ { task.nodes[0], child } });
+				}
+			}
+			isSplit = true;
+		}
+
+		std::swap(m_pairTasks, m_nextPairTasks);
+	}
+}
\ No newline at end of file
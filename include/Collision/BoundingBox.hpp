@@ -1,9 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <Vector3.hpp>
-#include <Collision/BoundingVolume.hpp>
+#include <Matrix4.hpp>
 
-class BoundingBox : public BoundingVolume
+// Axis aligned box
+class BoundingBox
 {
 public:
 	BoundingBox();
@@ -12,12 +14,19 @@ public:
 
 	Vector3f GetHalfSize() const;
 	bool Overlaps(std::shared_ptr<BoundingBox> other) const;
+	bool Overlaps(const BoundingBox& other) const;
+
+	Vector3f GetCenter() const;
+	float GetSize() const;
+	float GetSurfaceArea() const;
+	float GetGrowth(std::shared_ptr<BoundingBox> other) const;
+	float GetGrowth(const BoundingBox& other) const;
+	// Box around a body with the pose of transform, for a box centered on the body and aligned with its axes
+	BoundingBox GetAtPose(const Matrix4f& transform) const;
+	// True when part of the box is on the back side of the plane normal * x = offset, normal being of unit length
+	bool OverlapsHalfSpace(const Vector3f& normal, float offset) const;
 
-	Vector3f GetCenter() const override;
-	float GetSize() const override;
-	float GetGrowth(std::shared_ptr<BoundingVolume> other) const override;
 private:
 	Vector3f m_center;
 	Vector3f m_halfSize;
-	std::shared_ptr<BoundingVolume> m_other;
 };
\ No newline at end of file
@@ -1,27 +1,37 @@
 #pragma once
 
+#include <memory>
 #include <Vector3.hpp>
-#include <Collision/BoundingVolume.hpp>
+#include <Matrix4.hpp>
 
 class Rigidbody;
 
-class BoundingSphere : public BoundingVolume
+class BoundingSphere
 {
 public:
 	BoundingSphere();
 	BoundingSphere(std::shared_ptr<Rigidbody> rigidbody);
 	BoundingSphere(const Vector3f& center, float radius);
 	BoundingSphere(std::shared_ptr<BoundingSphere> one, std::shared_ptr<BoundingSphere> two);
+	BoundingSphere(const BoundingSphere& one, const BoundingSphere& two);
 
 	float GetRadius() const;
 	bool Overlaps(std::shared_ptr<BoundingSphere> other) const;
+	bool Overlaps(const BoundingSphere& other) const;
 
-	Vector3f GetCenter() const override;
-	float GetSize() const override;
+	Vector3f GetCenter() const;
+	// Half size of the box around the sphere
+	Vector3f GetHalfSize() const;
+	float GetSize() const;
+	float GetSurfaceArea() const;
 	float GetGrowth(std::shared_ptr<BoundingSphere> other) const;
+	float GetGrowth(const BoundingSphere& other) const;
+	// Sphere around a body with the pose of transform, for a sphere centered on the body
+	BoundingSphere GetAtPose(const Matrix4f& transform) const;
+	// True when part of the sphere is on the back side of the plane normal * x = offset, normal being of unit length
+	bool OverlapsHalfSpace(const Vector3f& normal, float offset) const;
 	Vector3f m_center;
 
 private:
 	float m_radius;
-	std::shared_ptr<BoundingSphere> m_other;
 };
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include "BodyHandle.hpp"
+
+class Primitive;
+class RigidbodyStorage;
+
+struct PotentialContact
+{
+public:
+	/* Bodies that might be in contact */
+	std::array<BodyHandle, 2> bodies;
+};
+
+struct PotentialContactPrimitive
+{
+	std::array<Primitive*, 2> primitives;
+};
+
+// Finds the pairs whose bounding volumes overlap, so the narrow phase only tests those.
+// A PhysicsSystem uses the one given to SetBroadPhase.
+class BroadPhase
+{
+public:
+	virtual ~BroadPhase() = default;
+
+	// Moves the volumes to the current position of their body
+	virtual void Update(const RigidbodyStorage& rigidbodies) = 0;
+
+	// Write at most limit pairs and return how many were written
+	virtual unsigned int GetPotentialContact(PotentialContact* contacts, unsigned int limit) const = 0;
+	virtual unsigned int GetPotentialContactPrimitive(PotentialContactPrimitive* contacts, unsigned int limit) const = 0;
+
+	// True when the last GetPotentialContact or GetPotentialContactPrimitive call left out pairs because of its limit
+	bool IsTruncated() const;
+
+protected:
+	mutable bool m_truncated = false;
+};
\ No newline at end of file
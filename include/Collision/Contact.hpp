@@ -1,24 +1,27 @@
 #pragma once
 #include <memory>
-#include <vector>
+#include <array>
 #include "Vector3.hpp"
 #include "Matrix3.hpp"
+#include "BodyHandle.hpp"
 
 class Rigidbody;
+class RigidbodyStorage;
 
 class Contact
 {
 public:
 	Contact() = default;
-	Contact(std::vector<std::shared_ptr<Rigidbody>>& rigidbodies, Vector3f contactPoint, Vector3f contactNormal, float penetration);
+	Contact(const BodyHandle& first, const BodyHandle& second, Vector3f contactPoint, Vector3f contactNormal, float penetration);
 
-	void PreCalculation(float duration);
+	void PreCalculation(RigidbodyStorage& rigidbodies, float duration);
 	void CalculateContactBasis();
-	void CalculateDeltaVelocity(float duration);
-	Vector3f CalculateLocalVelocity(int index, float duration);
+	void CalculateDeltaVelocity(RigidbodyStorage& rigidbodies, float duration);
+	Vector3f CalculateLocalVelocity(RigidbodyStorage& rigidbodies, int index, float duration);
 
 public:
-	std::vector<std::shared_ptr<Rigidbody>> rigidbodies;
+	// Second body is invalid for a contact against the world
+	std::array<BodyHandle, 2> bodies;
 
 	Vector3f contactPoint;
 	Vector3f contactNormal;
@@ -31,4 +34,8 @@ public:
 	Vector3f contactVelocity;
 
 	Vector3f relativeContactPosition[2];
+
+	// Impulse applied on the contact in contact space, x along the normal. Starts at the impulse its ContactManifold
+	// point kept from the last step, which the solver applies before iterating
+	Vector3f accumulatedImpulse;
 };
\ No newline at end of file
@@ -3,38 +3,128 @@
 #include <memory>
 
 #include "Vector3.hpp"
+#include "Collision/Contact.hpp"
+#include "Collision/GJK.hpp"
+#include "Collision/Primitives/Primitive.hpp"
 
-class Contact;
-class Primitive;
 class Sphere;
 class Plane;
 class Box;
+class RigidbodyStorage;
+struct CachedPair;
+
+// Axis of least penetration between two overlapping boxes
+struct BoxAxis
+{
+	/* 0-2 face of box A, 3-5 face of box B, 6-14 edge of box A crossed with an edge of box B (6 + 3 * edgeA + edgeB) */
+	int index;
+	/* Unit axis in world space, pointing from box A towards box B */
+	Vector3f normal;
+	float penetration;
+};
+
+// Pair of spheres queued for DetectSandSBatch
+struct SpherePair
+{
+	const Sphere* sphereA;
+	const Sphere* sphereB;
+	/* State kept for the primitives between steps, nullptr when they are not tested through the PairCache */
+	CachedPair* pair;
+};
+
+// Sphere and plane queued for DetectSandPBatch
+struct SpherePlanePair
+{
+	const Sphere* sphere;
+	const Plane* plane;
+	/* State kept for the primitives between steps, nullptr when they are not tested through the PairCache */
+	CachedPair* pair;
+};
 
 class ContactGenerator
 {
 public:
-	ContactGenerator(float maxContacts);
+	// Generates the contacts between two primitives of the types it was registered with.
+	// pair holds the state kept for the primitives between steps, nullptr when they are not tested through the PairCache
+	using CollisionFunction = void(*)(ContactGenerator& generator, const Primitive& primitiveA, const Primitive& primitiveB, CachedPair* pair);
+
+	// Registers the pairs of every primitive type
+	ContactGenerator(unsigned int maxContacts, RigidbodyStorage& rigidbodies);
+
+	// Calls function for the pairs of typeA and typeB, the reversed pair is swapped before the call.
+	// Replaces the function previously registered for the pair
+	void RegisterCollision(PrimitiveType typeA, PrimitiveType typeB, CollisionFunction function);
+	// Generates the contacts between two primitives, does nothing if no function is registered for their types
+	void Detect(const Primitive& primitiveA, const Primitive& primitiveB, CachedPair* pair = nullptr);
 
-	std::vector<std::shared_ptr<Contact>>& GetContacts();
+	// Contacts generated since the last Reset, GetCurrentContacts() of them are valid
+	Contact* GetContacts();
 
 	void SetCurrentContacts(const int newContacts);
 	int GetCurrentContacts();
+	unsigned int GetMaxContacts() const;
+	// Reallocates the buffer, the contacts past the new size are lost
+	void SetMaxContacts(unsigned int maxContacts);
+	// True when the buffer filled up since the last Reset while primitives were still tested, some contacts may be missing
+	bool IsTruncated() const;
+	// Forgets the contacts of the previous step, the memory is kept for the next one
+	void Reset();
 
 	void DetectSandS(const Sphere& sphereA, const Sphere& sphereB);
 	void DetectSandHS(const Sphere& sphere, const Plane& plane);
 	void DetectSandP(const Sphere& sphere, const Plane& plane);
 	void DetectSandB(const Sphere& sphere, const Box& box);
 
+	// Same contacts as DetectSandS and DetectSandP for count pairs, tested eight at a time with AVX2.
+	// The contact of each touching pair is appended in the order of the pairs and hitPairs receives the index of the pair.
+	// Returns the number of contacts appended, the pairs left once the buffer is full are not tested
+	unsigned int DetectSandSBatch(const SpherePair* pairs, unsigned int count, unsigned int* hitPairs);
+	unsigned int DetectSandPBatch(const SpherePlanePair* pairs, unsigned int count, unsigned int* hitPairs);
+
 	void DetectBandP(const Box& box, const Plane& plane);
 	void DetectBandB(const Box& boxA, const Box& boxB);
 
-	bool SAT(const Box& boxA, const Box& boxB, const Vector3f& axis);
-	bool SATBandB(const Box& boxA, const Box& boxB);
-	float AxisPenetrationBandB(float boxAProjection, float boxBProjection, const Vector3f& center, const Vector3f& axis);
+	// Any pair of spheres, boxes, tetrahedra and convex hulls with GJK, and EPA when their cores overlap.
+	// The simplex left in cache by the last test of the pair starts the next one
+	void DetectConvex(const Primitive& primitiveA, const Primitive& primitiveB, SimplexCache* cache = nullptr);
+	// Vertices of a tetrahedron or convex hull under the plane
+	void DetectCandP(const Primitive& convex, const Plane& plane);
+
+	// Tests the 15 separating axes of two boxes, returns false on the first one separating them.
+	// Otherwise fills the axis of least penetration, face axes are preferred over nearly as good edge axes
+	bool SATBandB(const Box& boxA, const Box& boxB, BoxAxis& axis) const;
 
 private:
-	std::vector<std::shared_ptr<Contact>> contacts;
+	struct CollisionEntry
+	{
+		/* nullptr if the pair has no collision */
+		CollisionFunction function = nullptr;
+		/* The function takes the primitives in the other order */
+		bool isSwapped = false;
+	};
+
+	// Next free slot of the buffer, the caller checked that one is left
+	Contact* GetNextContact();
+	// True when no slot is left, the contacts about to be generated are dropped and IsTruncated reports it
+	bool IsFull();
+
+	// Clips the face of the incident box most facing the reference face against the sides of the reference face
+	void DetectBandBFace(const Box& boxA, const Box& boxB, const Box& reference, const Box& incident, const BoxAxis& axis);
+	// Single contact between the closest points of the two edges crossed by the axis
+	void DetectBandBEdge(const Box& boxA, const Box& boxB, const BoxAxis& axis);
+	// Support shape of a sphere, box, tetrahedron or convex hull at the pose of its body, boxVertices receives the corners of a box
+	ConvexShape GetConvexShape(const Primitive& primitive, Vector3f* boxVertices) const;
+
+	// Indexed by the types of both primitives
+	CollisionEntry m_collisions[PrimitiveTypeCount][PrimitiveTypeCount];
+
+	// Allocated once with maxContacts slots
+	std::vector<Contact> contacts;
 
 	unsigned int maxContacts;
 	unsigned int currentContacts;
+	bool isTruncated;
+
+	// Bodies referenced by the primitives
+	RigidbodyStorage& m_rigidbodies;
 };
\ No newline at end of file
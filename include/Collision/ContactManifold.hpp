@@ -0,0 +1,39 @@
+#pragma once
+#include "Vector3.hpp"
+
+class Contact;
+class RigidbodyStorage;
+
+// Point of a ContactManifold, followed from one step to the next in the space of both bodies
+struct ManifoldPoint
+{
+	/* Contact point in the space of each body, in world space when the second body is missing */
+	Vector3f localPoints[2];
+	/* Impulse the solver accumulated on the point, in contact space with x along the normal */
+	Vector3f impulse;
+};
+
+// Contact points of a pair of primitives kept between steps. The contacts generated each step are reduced to at most
+// MaxPoints spanning the largest area, and a point found again at the same place on both bodies keeps its impulse
+class ContactManifold
+{
+public:
+	static constexpr unsigned int MaxPoints = 4;
+
+	// Reduces in place the contacts generated for the pair this step and matches them with the points of the last step.
+	// Returns the number of contacts kept at the start of the array, a matched contact starts with the impulse of its point
+	unsigned int Update(Contact* contacts, unsigned int count, const RigidbodyStorage& rigidbodies);
+	// Keeps the impulses the solver accumulated on the contacts returned by the last Update
+	void StoreImpulses(const Contact* contacts);
+	void Clear();
+
+	const ManifoldPoint* GetPoints() const;
+	unsigned int GetPointCount() const;
+
+private:
+	// Moves the deepest contact and the ones spanning the largest area with it to the start of the array
+	static unsigned int Reduce(Contact* contacts, unsigned int count);
+
+	ManifoldPoint m_points[MaxPoints];
+	unsigned int m_pointCount = 0;
+};
\ No newline at end of file
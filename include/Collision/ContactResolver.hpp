@@ -4,24 +4,42 @@
 
 #include "Matrix3.hpp"
 #include "State.hpp"
+#include "BodyHandle.hpp"
 
 class Contact;
 class Rigidbody;
+class RigidbodyStorage;
 
 class ContactResolver
 {
 public:
-	ContactResolver(int iterations);
+	ContactResolver(int iterations, RigidbodyStorage& rigidbodies);
 
-	void ResolveContacts(std::vector<std::shared_ptr<Contact>>& contacts, float duration, const State& state);
-	void ResolveVelocity(std::vector<std::shared_ptr<Contact>>& contacts, float duration, const State& state);
-	void ResolveInterpenetration(std::vector<std::shared_ptr<Contact>>& contacts, float duration, const State& state);
+	void ResolveContacts(Contact* contacts, unsigned int contactCount, float duration, const State& state);
+	// Applies the impulses the contacts kept from the last step, so the iterations start close to the solution
+	void WarmStart(Contact* contacts, unsigned int contactCount);
+	void ResolveVelocity(Contact* contacts, unsigned int contactCount, float duration, const State& state);
+	void ResolveInterpenetration(Contact* contacts, unsigned int contactCount, float duration, const State& state);
+
+	// Coulomb friction coefficient of every contact, the tangent impulse is at most friction times the normal one. 0 disables friction
+	void SetFriction(float friction);
+	float GetFriction() const;
 
 private:
-	Vector3f CalculateImpulse(std::shared_ptr<Contact>& contact, Matrix3f* inverseTensor, bool hasFriction);
+	// Body of a contact the resolver moves, nullptr for a static body or the world
+	Rigidbody* GetMovingBody(const BodyHandle& body) const;
+	// Wakes the sleeping bodies touching an awake one, the integrator does not move sleeping bodies
+	void WakeUp(Contact* contacts, unsigned int contactCount);
+	// Velocity the next impulse on the contact would change, the iterations resolve the largest first
+	float CalculateVelocityError(const Contact& contact) const;
+	Vector3f CalculateImpulse(Contact& contact, Matrix3f* inverseTensor, bool hasFriction);
 
 private:
 	int iterations;
 	int iterationsUsed;
+	float m_friction;
+
+	// Bodies referenced by the contacts
+	RigidbodyStorage& m_rigidbodies;
 
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "Vector3.hpp"
+#include "BodyHandle.hpp"
+#include "Collision/BroadPhase.hpp"
+#include "Collision/BoundingSphere.hpp"
+
+// Node of a DynamicTree, nodes reference each other by their index in the tree node array
+struct DynamicTreeNode
+{
+	bool IsLeaf() const;
+	bool Contains(const Vector3f& otherMin, const Vector3f& otherMax) const;
+	bool Overlaps(const DynamicTreeNode& other) const;
+	float GetSurfaceArea() const;
+
+	/* Fat bounds of the body for a leaf, bounds of both children otherwise */
+	Vector3f min;
+	Vector3f max;
+	/* Parent of the node, or next free node while the node is in the free list */
+	int32_t parent;
+	/* Both are DynamicTree::NullNode for a leaf */
+	int32_t children[2];
+	/* 0 for a leaf, -1 for a free node */
+	int32_t height;
+};
+
+// Bounding volume tree of axis aligned boxes kept up to date incrementally, after Box2D's b2DynamicTree.
+// Leaves hold bounds enlarged by a margin, a leaf only moves in the tree once its body leaves them, so the cost of
+// Update grows with the number of bodies that moved significantly. Rotations keep the tree balanced while it changes.
+// Leaves are identified by the index returned by Insert, which stays valid until the leaf is removed.
+class DynamicTree : public BroadPhase
+{
+public:
+	static constexpr int32_t NullNode = -1;
+
+	explicit DynamicTree(float margin = 0.1f);
+
+	// Same as BVH::Insert, the leaves follow the position of their body in Update
+	int32_t Insert(std::shared_ptr<Primitive> primitive, const BoundingSphere& volume);
+	int32_t Insert(const BodyHandle& body, const BoundingSphere& volume);
+	void Remove(int32_t leaf);
+	void Clear();
+	void Reserve(std::size_t leafCount);
+
+	void Update(const RigidbodyStorage& rigidbodies) override;
+
+	// Pairs are tested on the bounding spheres, not the fat bounds, so they are the same as the BVH ones
+	unsigned int GetPotentialContact(PotentialContact* contacts, unsigned int limit) const override;
+	unsigned int GetPotentialContactPrimitive(PotentialContactPrimitive* contacts, unsigned int limit) const override;
+
+	// Distance added around the bounds of every leaf, only affects leaves inserted or moved afterwards
+	void SetMargin(float margin);
+	float GetMargin() const;
+
+	int32_t GetRoot() const;
+	const DynamicTreeNode& GetNode(int32_t node) const;
+	int32_t GetHeight() const;
+	std::size_t GetLeafCount() const;
+	// Leaves moved in the tree by the last Update
+	std::size_t GetMovedLeafCount() const;
+	Primitive* GetPrimitive(int32_t leaf) const;
+	BodyHandle GetBody(int32_t leaf) const;
+
+private:
+	// Data only read when a leaf is updated or reported, kept out of the nodes
+	struct Leaf
+	{
+		std::shared_ptr<Primitive> primitive;
+		BodyHandle body;
+		/* Bounding sphere of the body, the node holds its fat bounds */
+		Vector3f center;
+		float radius;
+	};
+
+	int32_t AllocateNode();
+	void FreeNode(int32_t node);
+	int32_t CreateLeaf(const Leaf& leaf);
+	void SetFatBounds(int32_t leaf);
+	void InsertLeaf(int32_t leaf);
+	void RemoveLeaf(int32_t leaf);
+	// Recomputes the bounds and heights from node up to the root, rotating the unbalanced nodes on the way
+	void UpdateAncestors(int32_t node);
+	// Rotates the higher child of node up when the heights of its children differ by more than one, returns the new subtree root
+	int32_t Balance(int32_t node);
+	void UpdateNode(int32_t node);
+
+	bool Overlaps(int32_t leafA, int32_t leafB) const;
+	// Calls report(leafA, leafB) for every overlapping pair until it returns false
+	template<typename Report>
+	void QueryPairs(Report& report) const;
+
+	std::vector<DynamicTreeNode> m_nodes;
+	// Same size as m_nodes, only meaningful for leaves
+	std::vector<Leaf> m_leaves;
+	int32_t m_root;
+	int32_t m_freeList;
+	std::size_t m_leafCount;
+	std::size_t m_movedLeafCount;
+	float m_margin;
+
+	mutable std::vector<int32_t> m_queryStack;
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+
+#include "Vector3.hpp"
+#include "Matrix4.hpp"
+
+// Convex hull of a few points in the space of a body, grown by a radius. A sphere is its center grown by its radius.
+// The shapes only need a support point, the furthest vertex along a direction, which is searched by brute force
+struct ConvexShape
+{
+	/* Points in the space of the body */
+	const Vector3f* vertices;
+	/* At most 65536 vertices, the SimplexCache stores their indices on 16 bits */
+	unsigned int vertexCount;
+	/* Body to world transform, rigid */
+	const Matrix4f* transform;
+	float radius;
+};
+
+// Vertex indices of the last simplex GJK found for a pair of shapes. Starting the next test from it lets
+// resting pairs converge in one or two iterations
+struct SimplexCache
+{
+	/* 0 when the pair was never tested */
+	unsigned int count = 0;
+	uint16_t indicesA[4];
+	uint16_t indicesB[4];
+};
+
+struct GJKResult
+{
+	/* Closest points of the two cores in world space, only meaningful when the cores do not overlap */
+	Vector3f pointA;
+	Vector3f pointB;
+	/* Distance between the cores without their radii, 0 when they overlap */
+	float distance;
+	/* Support points searched, a warm started resting pair needs one or two */
+	unsigned int iterations;
+	/* Last simplex of the Minkowski difference A - B, a tetrahedron around the origin when the cores overlap */
+	unsigned int simplexCount;
+	Vector3f simplexA[4];
+	Vector3f simplexB[4];
+	uint16_t simplexIndicesA[4];
+	uint16_t simplexIndicesB[4];
+};
+
+struct Penetration
+{
+	/* Unit direction from A towards B, moving B by normal * depth separates the cores */
+	Vector3f normal;
+	float depth;
+	/* Deepest points of the cores in world space */
+	Vector3f pointA;
+	Vector3f pointB;
+};
+
+// Distance between the cores of two convex shapes. Starts from the simplex in cache when there is one and stores the last one in it
+GJKResult GJKDistance(const ConvexShape& shapeA, const ConvexShape& shapeB, SimplexCache* cache = nullptr);
+// True if the two shapes, radii included, overlap
+bool GJKOverlap(const ConvexShape& shapeA, const ConvexShape& shapeB, SimplexCache* cache = nullptr);
+// Depth and normal of the overlap of two cores with the expanding polytope algorithm, from the simplex of a GJKDistance
+// that found them overlapping. False if no polytope could be built around the origin, when one of the shapes is flat
+bool EPAPenetration(const ConvexShape& shapeA, const ConvexShape& shapeB, const GJKResult& gjk, Penetration& penetration);
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "Collision/BroadPhase.hpp"
+#include "Collision/GJK.hpp"
+#include "Collision/ContactManifold.hpp"
+
+class Primitive;
+
+enum PairState
+{
+	StateBegin,
+	StatePersist
+};
+
+// Primitive pair reported by the broad phase, kept by the PairCache as long as the broad phase keeps reporting it
+struct CachedPair
+{
+	/* primitives[0] has the smaller id */
+	std::array<Primitive*, 2> primitives;
+	/* Ids of both primitives, the smaller one in the high bits */
+	uint64_t key;
+	/* StateBegin on the step the pair appears, StatePersist on the following ones */
+	PairState state;
+	/* Step of the cache the pair was last reported on */
+	unsigned int lastStep;
+
+	// Narrow phase state, kept from one step to the next
+	/* Last step the narrow phase tested the pair, it skips pairs whose bodies are all asleep or static */
+	unsigned int testedStep;
+	/* Contacts the narrow phase generated for the pair when it was last tested */
+	unsigned int contactCount;
+	/* Last GJK simplex of a convex pair, starts the next test */
+	SimplexCache simplex;
+	/* At most four points kept from one test to the next with the impulses of the solver */
+	ContactManifold manifold;
+	/* Index of the first contact of the pair in the ContactGenerator when it was last tested */
+	unsigned int firstContact;
+};
+
+// Overlapping primitive pairs kept between steps, so a pair can be told apart as beginning, persisting or ending.
+// Pairs are keyed by the ids of their primitives and stored in a dense array indexed by an open addressing table.
+// A pair keeps its place in the array until it ends and new pairs are added at the end, so the order is deterministic.
+// The buffers are kept between steps, an update does not allocate once the pair count stops growing.
+class PairCache
+{
+public:
+	PairCache();
+
+	// Takes the pairs found by the broad phase this step: unknown pairs begin, known pairs persist, the others end
+	void Update(const PotentialContactPrimitive* pairs, unsigned int count);
+	void Clear();
+
+	// Pairs that began or persisted on the last update
+	CachedPair* GetPairs();
+	const CachedPair* GetPairs() const;
+	unsigned int GetPairCount() const;
+	// Pairs that were not reported again by the last update. Their primitives may have been destroyed since
+	const CachedPair* GetEndedPairs() const;
+	unsigned int GetEndedPairCount() const;
+	unsigned int GetStep() const;
+
+private:
+	static constexpr int32_t EmptySlot = -1;
+
+	static uint64_t GetKey(const Primitive& primitiveA, const Primitive& primitiveB);
+	uint32_t GetSlot(uint64_t key) const;
+	// Sizes the table for pairCount pairs and indexes m_pairs again
+	void RebuildSlots(std::size_t pairCount);
+
+	std::vector<CachedPair> m_pairs;
+	std::vector<CachedPair> m_endedPairs;
+	// Index of a pair in m_pairs for every slot, at most half full
+	std::vector<int32_t> m_slots;
+	uint32_t m_slotMask;
+	unsigned int m_step;
+};
\ No newline at end of file
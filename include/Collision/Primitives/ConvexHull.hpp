@@ -0,0 +1,16 @@
+#pragma once
+#include "Collision/Primitives/Primitive.hpp"
+#include "Vector3.hpp"
+
+#include <vector>
+
+// Convex hull of a set of points, collided with GJK. Points inside the hull are allowed but slow down the support search
+class ConvexHull : public Primitive
+{
+public:
+	ConvexHull(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, std::vector<Vector3f> vertices);
+
+public:
+	/* In the space of the body, at most 65536 */
+	std::vector<Vector3f> vertices;
+};
\ No newline at end of file
@@ -12,6 +12,7 @@ public:
 	Plane(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, const Vector3f normal, const float fOffset);
 	
 public:
+	/* Points x of the plane verify normal * x = offset, in world space */
 	Vector3f normal;
 	float offset;
 };
\ No newline at end of file
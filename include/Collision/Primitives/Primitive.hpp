@@ -1,7 +1,9 @@
 #pragma once
 #include "Matrix4.hpp"
+#include "BodyHandle.hpp"
 
 #include <memory>
+#include <cstdint>
 
 class Rigidbody;
 
@@ -10,18 +12,25 @@ enum PrimitiveType
 	TypeSphere,
 	TypePlane,
 	TypeBox,
-	TypePrimitive
+	TypeConvexHull,
+	TypeTetrahedron,
+	TypePrimitive,
+	/* Number of primitive types, sizes the narrow phase dispatch table */
+	PrimitiveTypeCount
 };
 
 class Primitive
 {
 public:
+	// The rigidbody has to be added to the PhysicsSystem before its primitives are created
 	Primitive(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset);
 	Primitive(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, const PrimitiveType& type);
 	virtual PrimitiveType GetType() const;
 
 public:
-	std::shared_ptr<Rigidbody> rigidbody;
+	BodyHandle body;
 	Matrix4f offset;
 	PrimitiveType type;
+	/* Unique to every primitive created, copies keep it. Identifies the primitive in the PairCache */
+	uint32_t id;
 };
\ No newline at end of file
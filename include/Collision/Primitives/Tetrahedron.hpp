@@ -0,0 +1,17 @@
+#pragma once
+#include "Collision/Primitives/Primitive.hpp"
+#include "Vector3.hpp"
+
+#include <array>
+
+class Tetrahedron : public Primitive
+{
+public:
+	Tetrahedron(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, const std::array<Vector3f, 4>& vertices);
+	// Regular tetrahedron centered on the body, the edge length matches Rigidbody::GetTetrahedronInertiaTensorLocal
+	Tetrahedron(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, const float edgeLength);
+
+public:
+	/* In the space of the body */
+	std::array<Vector3f, 4> vertices;
+};
\ No newline at end of file
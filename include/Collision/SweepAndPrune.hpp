@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "Vector3.hpp"
+#include "BodyHandle.hpp"
+#include "Collision/BroadPhase.hpp"
+#include "Collision/BoundingSphere.hpp"
+
+// Sort and sweep broad phase: the bounds of every volume are kept sorted along one axis between updates.
+// Bodies move little from one step to the next, so the insertion sort of Update is close to linear.
+// The sorted axis is the one along which the volumes are the most spread out.
+class SweepAndPrune : public BroadPhase
+{
+public:
+	static constexpr int32_t NullProxy = -1;
+
+	SweepAndPrune();
+
+	// Same as BVH::Insert, the proxies follow the position of their body in Update
+	int32_t Insert(std::shared_ptr<Primitive> primitive, const BoundingSphere& volume);
+	int32_t Insert(const BodyHandle& body, const BoundingSphere& volume);
+	void Remove(int32_t proxy);
+	void Clear();
+	void Reserve(std::size_t proxyCount);
+
+	// Also sorts the proxies inserted since the last update, the pairs are only reported after it
+	void Update(const RigidbodyStorage& rigidbodies) override;
+
+	unsigned int GetPotentialContact(PotentialContact* contacts, unsigned int limit) const override;
+	unsigned int GetPotentialContactPrimitive(PotentialContactPrimitive* contacts, unsigned int limit) const override;
+
+	std::size_t GetProxyCount() const;
+	int GetSortAxis() const;
+
+private:
+	struct Proxy
+	{
+		Vector3f center;
+		float radius;
+		/* false while the proxy is in the free list */
+		bool alive;
+		std::shared_ptr<Primitive> primitive;
+		BodyHandle body;
+	};
+
+	// Bound of a proxy on the sorted axis
+	struct Endpoint
+	{
+		float value;
+		/* Proxy index shifted left by one, the low bit is set for a max bound */
+		uint32_t data;
+
+		int32_t GetProxy() const;
+		bool IsMax() const;
+	};
+
+	int32_t InsertProxy(const Proxy& proxy);
+	int ChooseSortAxis() const;
+	static float GetAxisValue(const Vector3f& vector, int axis);
+	// Min bounds go first on a tie, so touching volumes are still tested
+	static bool EndpointLess(const Endpoint& a, const Endpoint& b);
+	void RemoveDeadEndpoints();
+	void UpdateEndpointValues();
+	void SortEndpoints();
+	bool Overlaps(int32_t proxyA, int32_t proxyB) const;
+
+	// Calls report(proxyA, proxyB) for every overlapping pair until it returns false
+	template<typename Report>
+	void Sweep(Report& report) const;
+
+	std::vector<Proxy> m_proxies;
+	std::vector<int32_t> m_freeProxies;
+	// Proxies removed since the last update, their endpoints are still in m_endpoints so they are not reused yet
+	std::vector<int32_t> m_removedProxies;
+	std::vector<Endpoint> m_endpoints;
+	// Endpoints sorted by the last update, the ones of newer proxies come after them
+	std::size_t m_sortedEndpointCount;
+	std::size_t m_proxyCount;
+	int m_sortAxis;
+
+	// Proxies whose min bound has been swept but not their max bound yet, and their place in that list
+	mutable std::vector<int32_t> m_active;
+	mutable std::vector<int32_t> m_activeIndices;
+};
\ No newline at end of file
@@ -1,4 +1,6 @@
 #pragma once
 
 const float MIN_MASS = 0.000001f;
-const float GRAVITY = 9.81f;
\ No newline at end of file
+const float GRAVITY = 9.81f;
+// Average squared speed under which a rigidbody falls asleep
+const float SLEEP_MOTION = 0.3f;
\ No newline at end of file
@@ -2,13 +2,16 @@
 
 #include "Vector3.hpp"
 #include "Particle.hpp"
+#include <array>
 #include <memory>
 #include <vector>
 
 class ParticleContact
 {
 public:
+	ParticleContact();
 	ParticleContact(std::vector<std::shared_ptr<Particle>>& particles, float restitution, float penetration, Vector3f contactNormal);
+	ParticleContact(Particle* particle, Particle* otherParticle, float restitution, float penetration, Vector3f contactNormal);
 
 	void Resolve(float duration);
 	float CalculateSeparatingVelocity();
@@ -19,9 +22,11 @@ private:
 
 
 public:
-	std::vector<std::shared_ptr<Particle>> particles;
+	// Views onto the particles, the second one is null for a contact against the scenery
+	std::array<Particle*, 2> particles;
 
 	float restitution;
 	float penetration;
+	/* Points from the second particle towards the first one */
 	Vector3f contactNormal;
 };
\ No newline at end of file
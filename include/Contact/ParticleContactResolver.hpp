@@ -10,6 +10,8 @@ public:
 	ParticleContactResolver(unsigned int iteration);
 
 	void ResolveContacts(std::vector<std::shared_ptr<ParticleContact>>& contactArray, unsigned int numContacts, float duration);
+	// Sweeps the whole buffer once per iteration, linear in the contact count for the large buffers of the spatial hash
+	void ResolveContacts(ParticleContact* contacts, unsigned int numContacts, float duration);
 
 protected:
 	unsigned int iteration;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "Vector3.hpp"
+#include "Contact/ParticleContact.hpp"
+
+class ParticleStorage;
+
+// Broad phase for particles of the same radius: space is cut into cubic cells one particle wide and the cells are
+// hashed into a table sized from the particle count. A pair is only searched from one side: a particle meets its own cell
+// and the 13 neighbouring cells after it, the other 13 see it from their own side.
+// Particles are binned with a counting sort: one pass counts the particles of every bucket, a prefix sum turns the counts
+// into offsets and a last pass writes the particles sorted by bucket. The buffers are kept between steps, a step does
+// not allocate once the particle count stops growing.
+class ParticleSpatialHash
+{
+public:
+	ParticleSpatialHash(float particleRadius, float restitution, unsigned int maxContacts);
+
+	// Writes a sphere-sphere contact for every overlapping pair, up to GetMaxContacts, and returns the number written
+	unsigned int GenerateContacts(const ParticleStorage& particles);
+
+	void SetParticleRadius(float particleRadius);
+	float GetParticleRadius() const;
+	float GetCellSize() const;
+	void SetRestitution(float restitution);
+	float GetRestitution() const;
+
+	ParticleContact* GetContacts();
+	unsigned int GetContactCount() const;
+	unsigned int GetMaxContacts() const;
+	// True when the last step found more overlapping pairs than the contact buffer holds
+	bool IsTruncated() const;
+
+private:
+	struct Cell
+	{
+		int32_t x;
+		int32_t y;
+		int32_t z;
+
+		bool operator==(const Cell& cell) const;
+	};
+
+	void Bin(const ParticleStorage& particles);
+	// Tests the particle of a sorted slot against the particles of cell from firstSlot on, false once the buffer is full
+	bool GenerateContacts(uint32_t slot, const Cell& cell, uint32_t firstSlot);
+	int32_t GetCellCoordinate(float value) const;
+	uint32_t GetBucket(const Cell& cell) const;
+
+	float m_particleRadius;
+	float m_inverseCellSize;
+	float m_restitution;
+
+	uint32_t m_bucketMask;
+	// First sorted particle of every bucket, the last element is the particle count
+	std::vector<uint32_t> m_bucketStarts;
+	std::vector<Cell> m_particleCells;
+	// Particles, positions and cells sorted by bucket, a bucket is contiguous in memory
+	std::vector<Particle*> m_sortedParticles;
+	std::vector<Vector3f> m_sortedPositions;
+	std::vector<Cell> m_sortedCells;
+
+	std::vector<ParticleContact> m_contacts;
+	unsigned int m_contactCount;
+	bool m_truncated;
+};
\ No newline at end of file
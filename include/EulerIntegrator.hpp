@@ -5,9 +5,10 @@
 
 #include "Vector3.hpp"
 #include "Constants/PhysicConstants.hpp"
+#include "ThreadPool.hpp"
 
-class Particle;
-class Rigidbody;
+class ParticleStorage;
+class RigidbodyStorage;
 struct State;
 
 class EulerIntegrator
@@ -15,7 +16,24 @@ class EulerIntegrator
 public:
 	EulerIntegrator() = default;
 
-	void Update(State& current, std::vector<std::shared_ptr<Particle>>& particles, std::vector<std::shared_ptr<Rigidbody>> rigidbodies, const float& deltaTime, bool isGravityEnabled = true);
+	void Update(State& current, ParticleStorage& particles, RigidbodyStorage& rigidbodies, const float& deltaTime, bool isGravityEnabled = true);
+
+	// Threads sharing the integration, including the calling one. 1 integrates everything on the calling thread
+	void SetThreadCount(unsigned int threadCount);
+	unsigned int GetThreadCount() const;
+
 private:
+	// Bodies integrated by a single task, multiples of 8 so the vector loops never stop early
+	static constexpr std::size_t ParticleChunkSize = 8192;
+	static constexpr std::size_t RigidbodyChunkSize = 256;
+
+	template<typename Function>
+	void ParallelFor(std::size_t count, std::size_t chunkSize, const Function& function);
+	// Integrates the particles in [begin, end) component by component, several particles per instruction when possible
+	void IntegrateParticles(ParticleStorage& particles, std::size_t begin, std::size_t end, float deltaTime);
+	// Integrates the bodies in [begin, end) and updates their derived data
+	void IntegrateRigidbodies(RigidbodyStorage& rigidbodies, std::size_t begin, std::size_t end, float deltaTime);
+
 	Vector3<float> g = Vector3<float>(0.0f, -GRAVITY, 0.0f);
+	std::unique_ptr<ThreadPool> m_threadPool;
 };
\ No newline at end of file
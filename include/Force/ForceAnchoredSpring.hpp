@@ -17,8 +17,8 @@ public:
 	ForceAnchoredSpring(Vector3f anchor, Vector3f connectionPoint, float k, float restLength);
 
 	// apply spring force
-	void UpdateForce(std::shared_ptr<Particle> particle, float deltaTime) override;
-	void UpdateForce(std::shared_ptr<Rigidbody> rigidBody, float deltaTime) override;
+	void UpdateForce(Particle& particle, float deltaTime) override;
+	void UpdateForce(Rigidbody& rigidBody, float deltaTime) override;
 	void SetAnchor(Vector3f anchor);
 	Vector3f GetAnchor();
 	void SetSpringConstant(float k);
@@ -14,10 +14,15 @@ private:
 	float m_waterHeight;
 	float m_liquidDensity;
 
+	// false when the body is out of the water
+	bool CalculateForce(float depth, Vector3f& force) const;
+
 public:
 	ForceBuoyancy(float maxDepth, float volume, float waterHeight, float liquidDensity);
 
 	// apply buoyancy force
-	void UpdateForce(std::shared_ptr<Particle> particle, float deltaTime) override;
-	void UpdateForce(std::shared_ptr<Rigidbody> rigidbody, float deltaTime) override;
+	void UpdateForce(Particle& particle, float deltaTime) override;
+	void UpdateForce(Rigidbody& rigidbody, float deltaTime) override;
+	void UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, float deltaTime) override;
+	void UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, float deltaTime) override;
 };
\ No newline at end of file
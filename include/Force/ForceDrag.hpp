@@ -10,12 +10,17 @@ private:
 	float m_k1;		// linear drag coefficient, usually for air resistence
 	float m_k2;		// quadratic drag coefficient, usually for water resistence
 
+	// false when the body is too slow or too light to be dragged
+	bool CalculateForce(const Vector3f& velocity, float mass, Vector3f& force) const;
+
 public:
 	ForceDrag(float k1, float k2);
 
 	// apply simplified drag force
-	void UpdateForce(std::shared_ptr<Particle> particle, float deltaTime) override;
-	void UpdateForce(std::shared_ptr<Rigidbody> rigidBody, float deltaTime) override;
+	void UpdateForce(Particle& particle, float deltaTime) override;
+	void UpdateForce(Rigidbody& rigidBody, float deltaTime) override;
+	void UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, float deltaTime) override;
+	void UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, float deltaTime) override;
 
 	void SetDragCoefficients(float k1, float k2);
 };
\ No newline at end of file
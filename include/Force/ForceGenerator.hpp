@@ -4,11 +4,20 @@
 
 class Particle;
 class Rigidbody;
+class ParticleStorage;
+class RigidbodyStorage;
 
 class ForceGenerator
 {
 public:
-	virtual void UpdateForce(std::shared_ptr<Particle> physicBody, float deltaTime) = 0;
-	virtual void UpdateForce(std::shared_ptr<Rigidbody> physicBody, float deltaTime) = 0;
+	virtual ~ForceGenerator() = default;
+
+	virtual void UpdateForce(Particle& physicBody, float deltaTime) = 0;
+	virtual void UpdateForce(Rigidbody& physicBody, float deltaTime) = 0;
+
+	// Applies the force to the bodies at the given storage indices, with one virtual call for the whole batch.
+	// Falls back to UpdateForce for each body, generators reading only storage data override it with a tight loop.
+	virtual void UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, float deltaTime);
+	virtual void UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, float deltaTime);
 
 }; 
\ No newline at end of file
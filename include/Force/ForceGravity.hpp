@@ -9,6 +9,8 @@ private :
 	Vector3f m_gravity = Vector3f(0.f, -GRAVITY, 0.f);
 
 public :
-	void UpdateForce(std::shared_ptr<Particle> particle, float deltaTime) override;
-	void UpdateForce(std::shared_ptr<Rigidbody> rigidBody, float deltaTime) override;
+	void UpdateForce(Particle& particle, float deltaTime) override;
+	void UpdateForce(Rigidbody& rigidBody, float deltaTime) override;
+	void UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, float deltaTime) override;
+	void UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, float deltaTime) override;
 };
\ No newline at end of file
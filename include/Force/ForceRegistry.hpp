@@ -1,36 +1,56 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include "BodyHandle.hpp"
 
 class ForceGenerator;
 class Particle;
 class Rigidbody;
+class ParticleStorage;
+class RigidbodyStorage;
 
 class ForceRegistry
 {
 private:
-	struct ForceEntry
+	// Every body a generator applies to, so the generator is called once per step for all of them
+	struct Batch
 	{
-		std::shared_ptr<Particle> particle;
 		std::shared_ptr<ForceGenerator> forceGenerator;
+		std::vector<BodyHandle> bodies;
+		// Storage indices of the bodies still alive, rebuilt every step
+		std::vector<unsigned int> indices;
 	};
 
-	struct ForceEntryRigidbody
-	{
-		std::shared_ptr<Rigidbody> rigidbody;
-		std::shared_ptr<ForceGenerator> forceGenerator;
-	};
-
-	using Registry = std::vector<ForceEntry>;
+	// Batches of the same generator type are kept next to each other
+	using Registry = std::vector<Batch>;
 	Registry m_registry;
-	using RegistryRigidbody = std::vector<ForceEntryRigidbody>;
-	RegistryRigidbody m_registryRigidbody;
+	Registry m_registryRigidbody;
+
+	static Batch& GetBatch(Registry& registry, const std::shared_ptr<ForceGenerator>& fg);
+	static void Remove(Registry& registry, const BodyHandle& body, const std::shared_ptr<ForceGenerator>& fg);
+	// handles has to be sorted with HandleLess
+	static void Remove(Registry& registry, const std::vector<BodyHandle>& handles);
+	template<typename Storage>
+	static void UpdateForces(Registry& registry, Storage& storage, float deltaTime);
+
+	static bool HandleLess(const BodyHandle& a, const BodyHandle& b);
+	template<typename T>
+	static std::vector<BodyHandle> SortedHandles(const std::shared_ptr<T>* bodies, std::size_t count);
 
 public:
+	// Bodies have to be added to the PhysicsSystem before being registered
 	void Add(std::shared_ptr<Particle> particle, std::shared_ptr<ForceGenerator> fg);
 	void Add(std::shared_ptr<Rigidbody> rigidbody, std::shared_ptr<ForceGenerator> fg);
+	// Registers the same generator on count bodies
+	void Add(const std::shared_ptr<Particle>* particles, std::size_t count, std::shared_ptr<ForceGenerator> fg);
+	void Add(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count, std::shared_ptr<ForceGenerator> fg);
+	// Removal swaps the last body of the generator into the freed slot
 	void Remove(std::shared_ptr<Particle> physicBody, std::shared_ptr<ForceGenerator> fg);
 	void Remove(std::shared_ptr<Rigidbody> physicBody, std::shared_ptr<ForceGenerator> fg);
+	// Removes every entry of the given bodies in a single pass, call it before removing them from the PhysicsSystem
+	void Remove(const std::shared_ptr<Particle>* particles, std::size_t count);
+	void Remove(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count);
 	void Clear();
-	void UpdateForces(float deltaTime);
+	// Calls each generator once with the storage indices of all its bodies
+	void UpdateForces(ParticleStorage& particles, RigidbodyStorage& rigidbodies, float deltaTime);
 };
\ No newline at end of file
@@ -24,8 +24,8 @@ public:
 	ForceSpring(std::shared_ptr<Rigidbody> otherEnd, Vector3f connectionPoint, Vector3f otherConnectionPoint, float k, float restength);
 
 	// apply spring force
-	void UpdateForce(std::shared_ptr<Particle> particle, float deltaTime) override;
-	void UpdateForce(std::shared_ptr<Rigidbody> rigidBody, float deltaTime) override;
+	void UpdateForce(Particle& particle, float deltaTime) override;
+	void UpdateForce(Rigidbody& rigidBody, float deltaTime) override;
 
 	void SetOtherEnd(std::shared_ptr<Particle> otherEnd);
 	void SetSpringConstant(float k);
@@ -120,7 +120,7 @@ Vector3<T> Matrix3<T>::operator*(const Vector3<T>& vec) const
 	Vector3<T> result;
 	result.x = Value(0, 0) * vec.x + Value(0, 1) * vec.y + Value(0, 2) * vec.z;
 	result.y = Value(1, 0) * vec.x + Value(1, 1) * vec.y + Value(1, 2) * vec.z;
-	result.z = Value(2, 0) * vec.z + Value(2, 1) * vec.y + Value(2, 2) * vec.z;
+	result.z = Value(2, 0) * vec.x + Value(2, 1) * vec.y + Value(2, 2) * vec.z;
 
 	return result;
 }
@@ -131,7 +131,7 @@ Vector4<T> Matrix3<T>::operator*(const Vector4<T>& vec) const
 	Vector4<T> result;
 	result.x = Value(0, 0) * vec.x + Value(0, 1) * vec.y + Value(0, 2) * vec.z;
 	result.y = Value(1, 0) * vec.x + Value(1, 1) * vec.y + Value(1, 2) * vec.z;
-	result.z = Value(2, 0) * vec.z + Value(2, 1) * vec.y + Value(2, 2) * vec.z;
+	result.z = Value(2, 0) * vec.x + Value(2, 1) * vec.y + Value(2, 2) * vec.z;
 
 	return result;
 }
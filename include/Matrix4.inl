@@ -147,7 +147,7 @@ Vector3<T> Matrix4<T>::operator*(const Vector3<T>& vec) const
 	Vector3<T> result;
 	result.x = Value(0, 0) * vec.x + Value(0, 1) * vec.y + Value(0, 2) * vec.z + Value(0, 3);
 	result.y = Value(1, 0) * vec.x + Value(1, 1) * vec.y + Value(1, 2) * vec.z + Value(1, 3);
-	result.z = Value(2, 0) * vec.z + Value(2, 1) * vec.y + Value(2, 2) * vec.z + Value(2, 3);
+	result.z = Value(2, 0) * vec.x + Value(2, 1) * vec.y + Value(2, 2) * vec.z + Value(2, 3);
 
 	return result;
 }
@@ -158,8 +158,8 @@ Vector4<T> Matrix4<T>::operator*(const Vector4<T>& vec) const
 	Vector4<T> result;
 	result.x = Value(0, 0) * vec.x + Value(0, 1) * vec.y + Value(0, 2) * vec.z + Value(0, 3) * vec.w;
 	result.y = Value(1, 0) * vec.x + Value(1, 1) * vec.y + Value(1, 2) * vec.z + Value(1, 3) * vec.w;
-	result.z = Value(2, 0) * vec.z + Value(2, 1) * vec.y + Value(2, 2) * vec.z + Value(2, 3) * vec.w;
-	result.w = Value(3, 0) * vec.w + Value(3, 1) * vec.y + Value(3, 2) * vec.z + Value(3, 3) * vec.w;
+	result.z = Value(2, 0) * vec.x + Value(2, 1) * vec.y + Value(2, 2) * vec.z + Value(2, 3) * vec.w;
+	result.w = Value(3, 0) * vec.x + Value(3, 1) * vec.y + Value(3, 2) * vec.z + Value(3, 3) * vec.w;
 
 	return result;
 }
@@ -2,6 +2,8 @@
 
 #include <string>
 #include "Vector3.hpp"
+#include "BodyHandle.hpp"
+#include "ParticleStorage.hpp"
 
 class Particle
 {
@@ -11,18 +13,22 @@ public:
 	Particle(std::string name, Vector3f position);
 	Particle(std::string name, Vector3f position, float mass);
 
-	Particle(const Particle&) = default;
-	Particle(Particle&&) = default;
-	~Particle() = default;
+	Particle(const Particle& particle);
+	~Particle();
 
-	Particle& operator=(const Particle&) = default;
-	Particle& operator=(Particle&&) = default;
+	Particle& operator=(const Particle& particle);
 
 	std::string name;
-	Vector3f position;
-	Vector3f velocity;
-	Vector3f force;
-	float mass;
+
+	// Simulation state, read from the PhysicsSystem storage once the particle has been added to it
+	Vector3f GetPosition() const;
+	void SetPosition(const Vector3f& position);
+	Vector3f GetVelocity() const;
+	void SetVelocity(const Vector3f& velocity);
+	Vector3f GetForce() const;
+	float GetMass() const;
+	void SetMass(float mass);
+	float GetInverseMass() const;
 
 	void AddForce(const Vector3f& force);
 	void ClearForce();
@@ -30,6 +36,16 @@ public:
 	Vector3f SetAcceleration(const Vector3f& acceleration);
 	Vector3f const GetAcceleration();
 
+	BodyHandle GetHandle() const;
+
 private:
+	friend class ParticleStorage;
+
+	float m_mass;
 	Vector3f m_acceleration;
-};
\ No newline at end of file
+
+	ParticleStorage* m_storage = nullptr;
+	unsigned int m_storageIndex = 0;
+	BodyHandle m_handle;
+	ParticleState m_state;
+};
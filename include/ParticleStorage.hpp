@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include "Vector3.hpp"
+#include "BodyHandle.hpp"
+
+class Particle;
+
+// Simulation state of a single particle, used while the particle is not stored in a ParticleStorage
+struct ParticleState
+{
+	ParticleState() = default;
+	ParticleState(const Vector3f& position, float inverseMass);
+
+	Vector3f position;
+	Vector3f velocity;
+	Vector3f force;
+	float inverseMass;
+};
+
+// Particles of a PhysicsSystem, stored as one float array per component so they can be integrated several at a time.
+// Index i of every array belongs to the same particle, Particle objects are views on their index.
+// Particles are referenced from the engine internals with a BodyHandle.
+class ParticleStorage
+{
+public:
+	ParticleStorage() = default;
+	ParticleStorage(const ParticleStorage&) = delete;
+	ParticleStorage(ParticleStorage&&) = delete;
+	~ParticleStorage();
+
+	ParticleStorage& operator=(const ParticleStorage&) = delete;
+	ParticleStorage& operator=(ParticleStorage&&) = delete;
+
+	BodyHandle Add(Particle* particle);
+	// Moves the last particle into the freed index, so indices are not stable across removals
+	void Remove(const BodyHandle& handle);
+	void Remove(const BodyHandle* handles, std::size_t count);
+	void Clear();
+	void Reserve(std::size_t capacity);
+
+	std::size_t GetSize() const;
+	bool IsValid(const BodyHandle& handle) const;
+	unsigned int GetIndex(const BodyHandle& handle) const;
+	Particle* GetParticle(const BodyHandle& handle) const;
+	Particle* GetParticle(unsigned int index) const;
+
+	Vector3f GetPosition(unsigned int index) const;
+	void SetPosition(unsigned int index, const Vector3f& position);
+	Vector3f GetVelocity(unsigned int index) const;
+	void SetVelocity(unsigned int index, const Vector3f& velocity);
+	Vector3f GetForce(unsigned int index) const;
+	void AddForce(unsigned int index, const Vector3f& force);
+
+	void ClearAccumulators();
+	// Copies every position into positions, reusing its memory once it is large enough
+	void WriteSnapshot(std::vector<Vector3f>& positions) const;
+	// Copies the positions of [begin, end) into positions + begin
+	void WriteSnapshot(Vector3f* positions, std::size_t begin, std::size_t end) const;
+
+	std::vector<float> positionsX;
+	std::vector<float> positionsY;
+	std::vector<float> positionsZ;
+	std::vector<float> velocitiesX;
+	std::vector<float> velocitiesY;
+	std::vector<float> velocitiesZ;
+	std::vector<float> forcesX;
+	std::vector<float> forcesY;
+	std::vector<float> forcesZ;
+	std::vector<float> inverseMasses;
+	// Read by the force generators
+	std::vector<float> masses;
+
+private:
+	void Detach(unsigned int index);
+
+	std::vector<Particle*> m_particles;
+	std::vector<BodyHandle> m_handles;
+	HandleTable m_handleTable;
+};
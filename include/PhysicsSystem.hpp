@@ -8,12 +8,15 @@
 #include "Collision/ContactGenerator.hpp"
 #include "Collision/ContactResolver.hpp"
 #include "EulerIntegrator.hpp"
+#include "RigidbodyStorage.hpp"
+#include "ParticleStorage.hpp"
+#include "BodyHandle.hpp"
+#include "Collision/BroadPhase.hpp"
 
 class Particle;
 class Rigidbody;
-class BVHNode;
-struct PotentialContact;
-struct PotentialContactPrimitive;
+class ParticleSpatialHash;
+class PairCache;
 struct State;
 
 class PhysicsSystem
@@ -28,46 +31,115 @@ public:
 	PhysicsSystem& operator=(const PhysicsSystem&) = delete;
 
 	void Update(State& current, float deltaTime, bool isGravityEnabled, bool hasToDetectBroadPhase = false, bool hasToDetectNarrowPhase = false, bool hasToResolveContact = false);
-	void AddParticle(std::shared_ptr<Particle> particle);
+	BodyHandle AddParticle(std::shared_ptr<Particle> particle);
+	// Adds count particles at once, writing their handles into handles when it is not null
+	void AddParticles(const std::shared_ptr<Particle>* particles, std::size_t count, BodyHandle* handles = nullptr);
+	// Removal swaps the last particle into the freed slot, the order of GetParticles changes
 	void RemoveParticle(std::shared_ptr<Particle> particle);
+	void RemoveParticles(const std::shared_ptr<Particle>* particles, std::size_t count);
+	void ReserveParticles(std::size_t capacity);
 	std::vector<std::shared_ptr<Particle>> GetParticles();
+	Particle* GetParticle(const BodyHandle& handle) const;
 	void PrintParticles();
 
-	void AddRigidbody(std::shared_ptr<Rigidbody> rigidbody);
+	BodyHandle AddRigidbody(std::shared_ptr<Rigidbody> rigidbody);
+	// Adds count bodies at once, writing their handles into handles when it is not null
+	void AddRigidbodies(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count, BodyHandle* handles = nullptr);
+	// Removal swaps the last body into the freed slot, the order of GetRigidbodies changes
 	void RemoveRigidbody(std::shared_ptr<Rigidbody> rigidbody);
+	void RemoveRigidbodies(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count);
+	void ReserveRigidbodies(std::size_t capacity);
 	std::vector<std::shared_ptr<Rigidbody>> GetRigidbodies();
+	Rigidbody* GetRigidbody(const BodyHandle& handle) const;
+	RigidbodyStorage& GetRigidbodyStorage();
 	void PrintRigidbodies();
 
-	void AddRootBVHNode(std::shared_ptr<BVHNode> node);
-	PotentialContact* GetPotentialContactArray() const;
+	// BVH, SweepAndPrune or DynamicTree, they all report the same pairs
+	void SetBroadPhase(std::shared_ptr<BroadPhase> broadPhase);
+	// The pair buffers double whenever the broad phase fills them, up to this many pairs
+	void SetMaxPotentialContacts(unsigned int maxPotentialContacts);
+	unsigned int GetMaxPotentialContacts() const;
+	const PotentialContact* GetPotentialContactArray() const;
 	unsigned int GetPotentialContactCount() const;
+	unsigned int GetPotentialContactCapacity() const;
+	// True when the last step left out pairs because the buffer was at its maximum
+	bool IsPotentialContactTruncated() const;
+	// Prints the pairs found by the last broad phase, for debugging. Update does not call it
 	void ParsePotentialContacts();
-	PotentialContactPrimitive* GetPotentialContactPrimitiveArray() const;
+	const PotentialContactPrimitive* GetPotentialContactPrimitiveArray() const;
 	unsigned int GetPotentialContactPrimitiveCount() const;
+	unsigned int GetPotentialContactPrimitiveCapacity() const;
+	bool IsPotentialContactPrimitiveTruncated() const;
+	// Prints the primitive pairs found by the last broad phase, for debugging. Update does not call it
 	void ParsePotentialContactsPrimitive();
+	// Primitive pairs of the broad phase kept between steps, with the pairs that began, persisted and ended
+	const PairCache& GetPairCache() const;
 
-	std::vector<std::shared_ptr<Contact>> GetContactsArray();
-	int GetContactCount();
+	// Particles collide with each other while a spatial hash is set, null turns the collisions off
+	void SetParticleSpatialHash(std::shared_ptr<ParticleSpatialHash> spatialHash);
+	unsigned int GetParticleContactCount() const;
+
+	Contact* GetContactsArray() const;
+	int GetContactCount() const;
+	// Contacts the narrow phase can generate in a step, the buffer is allocated here and not during Update
+	void SetMaxContacts(unsigned int maxContacts);
+	unsigned int GetMaxContacts() const;
+	// True when the last narrow phase filled the contact buffer and left out contacts
+	bool IsContactTruncated() const;
+	// Heap allocations made during the last call to Update
+	std::size_t GetStepAllocationCount() const;
 
 	void ClearForces();
+	// Threads used to integrate the bodies, including the calling one. The result does not depend on it
+	void SetThreadCount(unsigned int threadCount);
+	unsigned int GetThreadCount() const;
 
 	void BroadPhaseCollisionDetection();
 	void NarrowPhaseCollisionDetection();
+	void ParticleCollisionDetection(float deltaTime);
 
 private:
+	// False for the bodies neither the integrator nor the solver moves: asleep, with an infinite mass or not in the storage
+	bool CanMove(const BodyHandle& body) const;
+	// Hands the impulses the solver accumulated on the contacts of the pairs tested this step to their manifolds
+	void StoreContactImpulses();
+	// Reduces the contacts generated for a pair from firstContact through its manifold and marks the pair tested.
+	// Returns the number of contacts kept
+	unsigned int UpdatePairContacts(CachedPair& pair, unsigned int firstContact, unsigned int contactCount);
+
+	// Shared pointers keep the bodies alive, the engine internals only use handles to the storages
+	// Same order as m_particleStorage
 	std::vector<std::shared_ptr<Particle>> m_particles;
+	std::unique_ptr<ParticleStorage> m_particleStorage;
 	std::vector<std::shared_ptr<Rigidbody>> m_rigidbodies;
+	// Simulation state of m_rigidbodies, same order
+	std::unique_ptr<RigidbodyStorage> m_rigidbodyStorage;
 	std::shared_ptr<ForceRegistry> m_forceRegistry;
 	std::unique_ptr<EulerIntegrator> m_integrator;
 
+	// Particle Collision Variables
+	std::shared_ptr<ParticleSpatialHash> m_particleSpatialHash;
+	std::unique_ptr<ParticleContactResolver> m_particleContactResolver;
+
 	// Broad Phase Variables
-	std::shared_ptr<BVHNode> m_rootBVHNode;
-	PotentialContact* m_potentialContact;
+	std::shared_ptr<BroadPhase> m_broadPhase;
+	// Reused from one step to the next, their size is the limit given to the broad phase
+	std::vector<PotentialContact> m_potentialContact;
 	unsigned int m_potentialContactCount;
-	PotentialContactPrimitive* m_potentialContactPrimitive;
+	bool m_isPotentialContactTruncated;
+	std::vector<PotentialContactPrimitive> m_potentialContactPrimitive;
 	unsigned int m_potentialContactPrimitiveCount;
+	bool m_isPotentialContactPrimitiveTruncated;
+	unsigned int m_maxPotentialContacts;
+	std::unique_ptr<PairCache> m_pairCache;
+	// Sphere pairs the narrow phase tests in batches, reused from one step to the next
+	std::vector<SpherePair> m_spherePairs;
+	std::vector<SpherePlanePair> m_spherePlanePairs;
+	std::vector<unsigned int> m_hitPairs;
+	bool m_isContactTruncated;
+
+	std::size_t m_stepAllocationCount;
 
-public:
 	// Narrow Phase Variables
 	std::unique_ptr<ContactGenerator> m_contactGenerator;
 	std::unique_ptr<ContactResolver> m_contactResolver;
@@ -42,6 +42,10 @@ public:
 
 	void Normalize();
 
+	// Interpolation along the shortest arc, Nlerp is cheaper but its speed is not constant
+	static Quaternion Nlerp(const Quaternion& a, const Quaternion& b, T t);
+	static Quaternion Slerp(const Quaternion& a, const Quaternion& b, T t);
+
 	void MoveToRightHalfSphere();
 
 	T Norm();
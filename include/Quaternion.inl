@@ -107,6 +107,45 @@ void Quaternion<T>::Normalize()
 
 }
 
+template <typename T>
+Quaternion<T> Quaternion<T>::Nlerp(const Quaternion<T>& a, const Quaternion<T>& b, T t)
+{
+	// q and -q are the same rotation, take the one closest to a
+	T dot = a.s * b.s + a.x * b.x + a.y * b.y + a.z * b.z;
+	T sign = dot < (T)0.0 ? (T)-1.0 : (T)1.0;
+	T oneMinusT = (T)1.0 - t;
+
+	Quaternion<T> w(oneMinusT * a.s + sign * t * b.s, oneMinusT * a.x + sign * t * b.x, oneMinusT * a.y + sign * t * b.y, oneMinusT * a.z + sign * t * b.z);
+
+	if (w.Norm2() > (T)0.0)
+		w.Normalize();
+
+	return w;
+}
+
+template <typename T>
+Quaternion<T> Quaternion<T>::Slerp(const Quaternion<T>& a, const Quaternion<T>& b, T t)
+{
+	T dot = a.s * b.s + a.x * b.x + a.y * b.y + a.z * b.z;
+	T sign = (T)1.0;
+	if (dot < (T)0.0)
+	{
+		dot = -dot;
+		sign = (T)-1.0;
+	}
+
+	// Nearly parallel, the sine below would be too small
+	if (dot > (T)0.9995)
+		return Nlerp(a, b, t);
+
+	T angle = (T)acos(dot);
+	T invSin = (T)1.0 / (T)sin(angle);
+	T weightA = (T)sin(((T)1.0 - t) * angle) * invSin;
+	T weightB = sign * (T)sin(t * angle) * invSin;
+
+	return Quaternion<T>(weightA * a.s + weightB * b.s, weightA * a.x + weightB * b.x, weightA * a.y + weightB * b.y, weightA * a.z + weightB * b.z);
+}
+
 template <typename T>
 T Quaternion<T>::Norm2()
 {
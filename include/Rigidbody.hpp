@@ -2,9 +2,11 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include "Matrix3.hpp"
 #include "Matrix4.hpp"
 #include "Quaternion.hpp"
+#include "RigidbodyStorage.hpp"
 
 class BoundingSphere;
 class BoundingBox;
@@ -29,32 +31,63 @@ public:
 	Rigidbody(std::string name, RigidbodyType type, Vector3f position, Vector3f scale, float mass);
 	Rigidbody(std::string name, RigidbodyType type, Vector3f position, Quaternionf rotation, float mass);
 	Rigidbody(std::string name, RigidbodyType type, Vector3f position, Quaternionf rotation, Vector3f scale, float mass, float linearDamping = 0.0f, float angularDamping = 0.0f);
+	Rigidbody(const Rigidbody& rigidbody);
+	~Rigidbody();
 
-	bool isAwake;
-	
+	Rigidbody& operator=(const Rigidbody&) = delete;
 
+	// Metadata, never read by the integrator or the solvers
 	std::string name;
 	RigidbodyType type;
-	Vector3f position;
-	Quaternionf rotation;
 	Vector3f scale;
-	Vector3f velocity;
-	Vector3f force;
-	Vector3f angularVelocity;
-	Vector3f torque;
-	float linearDamping;
-	float angularDamping;
 
 	Vector3f centerOfMass;
-	float mass;
-	float inverseMass;
 
-	Matrix4f transformMatrix;
-	Matrix3f inertiaTensor;
-	Matrix3f inverseInertiaTensor;
-	Matrix3f inverseInertiaTensorWorld;
-
-	Matrix3f GetInverseInertiaTensorWorld();
+	// Simulation state, read from the PhysicsSystem storage once the body has been added to it
+	Vector3f& GetPosition();
+	const Vector3f& GetPosition() const;
+	void SetPosition(const Vector3f& position);
+	Quaternionf& GetRotation();
+	const Quaternionf& GetRotation() const;
+	void SetRotation(const Quaternionf& rotation);
+	Vector3f& GetVelocity();
+	const Vector3f& GetVelocity() const;
+	void SetVelocity(const Vector3f& velocity);
+	Vector3f& GetAngularVelocity();
+	const Vector3f& GetAngularVelocity() const;
+	void SetAngularVelocity(const Vector3f& angularVelocity);
+	Vector3f& GetForce();
+	const Vector3f& GetForce() const;
+	Vector3f& GetTorque();
+	const Vector3f& GetTorque() const;
+	float GetMass() const;
+	// Also updates the inverse mass and inverse inertia tensor, call CalculateDerivedData to refresh the world one.
+	// A mass of 0 makes the body static, its inverse mass and inverse inertia tensor are 0.
+	// A static body given a mass gets the inertia tensor of its shape
+	void SetMass(float mass);
+	// True when the body has no mass: it is never integrated and contacts never move it
+	bool IsStatic() const;
+	float GetInverseMass() const;
+	const Matrix3f& GetInverseInertiaTensorWorld() const;
+	const Matrix3f& GetInverseInertiaTensor() const;
+	const Matrix3f& GetInertiaTensor() const;
+	// Also updates the inverse inertia tensor, call CalculateDerivedData to refresh the world one
+	void SetInertiaTensor(const Matrix3f& inertiaTensor);
+	const Matrix4f& GetTransformMatrix() const;
+	float GetLinearDamping() const;
+	void SetLinearDamping(float linearDamping);
+	float GetAngularDamping() const;
+	void SetAngularDamping(float angularDamping);
+	bool IsAwake() const;
+	// A sleeping body is not integrated, putting it to sleep also stops it
+	void SetAwake(bool isAwake);
+
+	bool IsInStorage() const;
+	unsigned int GetStorageIndex() const;
+	BodyHandle GetHandle() const;
+
+	// Inertia tensor of the shape given by the type, for the current mass and scale
+	Matrix3f GetInertiaTensorLocal();
 	Matrix3f GetBoxInertiaTensorLocal();
 	Matrix3f GetSphereInertiaTensorLocal();
 	Matrix3f GetTetrahedronInertiaTensorLocal();
@@ -65,7 +98,6 @@ public:
 	void AddForceAtPoint(const Vector3f& force, const Vector3f& point);
 	void AddForceAtBodyPoint(const Vector3f& force, const Vector3f& point);
 
-	void CalculateTransformMatrix();
 	void CalculateDerivedData();
 
 	Vector3f const GetAcceleration();
@@ -79,7 +111,18 @@ public:
 	std::shared_ptr<BoundingSphere> m_boundingSphere;
 
 private:
+	friend class RigidbodyStorage;
+
 	Vector3f m_acceleration;
 	Vector3f m_angularAcceleration;
+	// Copied into the storage with the inverse mass when the body is added to a PhysicsSystem
+	float m_mass;
+	// Local inertia tensor, SetInertiaTensor and SetMass keep its inverse in the storage up to date
+	Matrix3f m_inertiaTensor;
+
+	RigidbodyStorage* m_storage = nullptr;
+	unsigned int m_storageIndex = 0;
+	BodyHandle m_handle;
+	RigidbodyState m_state;
 
 };
\ No newline at end of file
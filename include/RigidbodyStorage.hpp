@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vector>
+#include "Vector3.hpp"
+#include "Quaternion.hpp"
+#include "Matrix3.hpp"
+#include "Matrix4.hpp"
+#include "BodyHandle.hpp"
+
+class Rigidbody;
+
+// Simulation state of a single body, used while the body is not stored in a RigidbodyStorage
+struct RigidbodyState
+{
+	RigidbodyState() = default;
+	RigidbodyState(const Vector3f& position, const Quaternionf& rotation, float inverseMass);
+
+	Vector3f position;
+	Quaternionf rotation;
+	Vector3f velocity;
+	Vector3f angularVelocity;
+	Vector3f force;
+	Vector3f torque;
+	float inverseMass;
+	Matrix3f inverseInertiaTensorWorld;
+	float linearDamping;
+	float angularDamping;
+	bool isAwake;
+	float motion;
+	Matrix3f inverseInertiaTensorLocal;
+	Matrix4f transformMatrix;
+};
+
+// Structure of arrays holding the per-step state of every rigidbody of a PhysicsSystem.
+// Index i of every array belongs to the same body, Rigidbody objects are views on their index.
+// Only the data read by the integrator and the solvers is stored here, the Rigidbody found with GetRigidbody keeps the metadata.
+// Bodies are referenced from outside with a BodyHandle, which stays valid when the dense index changes.
+class RigidbodyStorage
+{
+public:
+	RigidbodyStorage() = default;
+	RigidbodyStorage(const RigidbodyStorage&) = delete;
+	RigidbodyStorage(RigidbodyStorage&&) = delete;
+	~RigidbodyStorage();
+
+	RigidbodyStorage& operator=(const RigidbodyStorage&) = delete;
+	RigidbodyStorage& operator=(RigidbodyStorage&&) = delete;
+
+	BodyHandle Add(Rigidbody* rigidbody);
+	// Moves the last body into the freed index, so indices are not stable across removals
+	void Remove(const BodyHandle& handle);
+	void Remove(const BodyHandle* handles, std::size_t count);
+	void Clear();
+	void Reserve(std::size_t capacity);
+
+	std::size_t GetSize() const;
+	bool IsValid(const BodyHandle& handle) const;
+	unsigned int GetIndex(const BodyHandle& handle) const;
+	BodyHandle GetHandle(unsigned int index) const;
+	Rigidbody* GetRigidbody(const BodyHandle& handle) const;
+	Rigidbody* GetRigidbody(unsigned int index) const;
+
+	void ClearAccumulators();
+	// Normalizes the rotation of a body, then updates its transform matrix and world inverse inertia tensor
+	void CalculateDerivedData(unsigned int index);
+
+	static Matrix4f CalculateTransformMatrix(const Vector3f& position, const Quaternionf& rotation);
+	static Matrix3f CalculateInverseInertiaTensorWorld(const Matrix3f& inverseInertiaTensorLocal, const Matrix4f& transformMatrix);
+
+	std::vector<Vector3f> positions;
+	std::vector<Quaternionf> rotations;
+	std::vector<Vector3f> velocities;
+	std::vector<Vector3f> angularVelocities;
+	std::vector<Vector3f> forces;
+	std::vector<Vector3f> torques;
+	std::vector<float> inverseMasses;
+	// Read by the force generators, Rigidbody::SetMass updates it with the inverse mass
+	std::vector<float> masses;
+	std::vector<Matrix3f> inverseInertiaTensorsWorld;
+	std::vector<float> linearDampings;
+	std::vector<float> angularDampings;
+	std::vector<unsigned char> awake;
+	// Running average of the squared linear and angular speed, the integrator puts the body to sleep under SLEEP_MOTION
+	std::vector<float> motions;
+	std::vector<Matrix3f> inverseInertiaTensorsLocal;
+	std::vector<Matrix4f> transformMatrices;
+
+private:
+	void Detach(unsigned int index);
+
+	// Owner of each index, kept so a body can be told when its index changes
+	std::vector<Rigidbody*> m_rigidbodies;
+	std::vector<BodyHandle> m_handles;
+	HandleTable m_handleTable;
+};
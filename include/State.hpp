@@ -1,5 +1,6 @@
 #pragma once
 #include <vector>
+#include <algorithm>
 #include "Vector3.hpp"
 #include "Quaternion.hpp"
 
@@ -41,4 +42,43 @@ struct State
 
         return { tempParticlePositions, tempRigidbodyPositions, tempRigidbodyRotations };
     }
+
+    // Writes a + (b - a) * t into out, reusing the memory of out
+    static void Lerp(const State& a, const State& b, float t, State& out)
+    {
+        const std::size_t particleCount = std::min(a.m_particlePositions.size(), b.m_particlePositions.size());
+        out.m_particlePositions.resize(particleCount);
+        for (std::size_t i = 0; i < particleCount; ++i)
+            out.m_particlePositions[i] = a.m_particlePositions[i] + (b.m_particlePositions[i] - a.m_particlePositions[i]) * t;
+
+        const std::size_t rigidbodyCount = std::min(a.m_rigidbodyPositions.size(), b.m_rigidbodyPositions.size());
+        out.m_rigidbodyPositions.resize(rigidbodyCount);
+        for (std::size_t i = 0; i < rigidbodyCount; ++i)
+            out.m_rigidbodyPositions[i] = a.m_rigidbodyPositions[i] + (b.m_rigidbodyPositions[i] - a.m_rigidbodyPositions[i]) * t;
+
+        const std::size_t rotationCount = std::min(a.m_rigidbodyRotations.size(), b.m_rigidbodyRotations.size());
+        out.m_rigidbodyRotations.resize(rotationCount);
+        for (std::size_t i = 0; i < rotationCount; ++i)
+            out.m_rigidbodyRotations[i] = Quaternionf::Nlerp(a.m_rigidbodyRotations[i], b.m_rigidbodyRotations[i], t);
+    }
+};
+
+// Previous and current states of a fixed timestep loop.
+// Swap makes the current state the previous one without copying, the next step then overwrites the older state.
+class StateBuffer
+{
+public:
+    State& GetCurrent() { return m_states[m_current]; }
+    const State& GetCurrent() const { return m_states[m_current]; }
+    State& GetPrevious() { return m_states[m_current ^ 1]; }
+    const State& GetPrevious() const { return m_states[m_current ^ 1]; }
+
+    void Swap() { m_current ^= 1; }
+
+    // Blends the previous state into the current one, alpha = 1 gives the current state
+    void Interpolate(float alpha, State& out) const { State::Lerp(GetPrevious(), GetCurrent(), alpha, out); }
+
+private:
+    State m_states[2];
+    unsigned int m_current = 0;
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads sharing the chunks of a ParallelFor with the calling thread.
+// A pool runs one ParallelFor at a time and does not allocate once it is created.
+class ThreadPool
+{
+public:
+	// threadCount includes the calling thread, a pool of 1 thread runs everything on the caller
+	explicit ThreadPool(unsigned int threadCount);
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	~ThreadPool();
+
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+	unsigned int GetThreadCount() const;
+
+	// Calls function(begin, end) on consecutive chunks of [0, count) and returns once every chunk is done.
+	// Chunk boundaries only depend on count and chunkSize, never on the number of threads.
+	template<typename Function>
+	void ParallelFor(std::size_t count, std::size_t chunkSize, const Function& function);
+
+private:
+	using Task = void(*)(const void* context, std::size_t begin, std::size_t end);
+
+	void Run(Task task, const void* context, std::size_t count, std::size_t chunkSize);
+	void RunChunks();
+	void WorkerLoop();
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_jobReady;
+	std::condition_variable m_jobDone;
+	bool m_stop;
+	// Incremented for every job so a worker wakes up only once per job
+	unsigned long long m_jobId;
+	unsigned int m_busyWorkers;
+
+	// Current job, only written while no worker is busy
+	Task m_task;
+	const void* m_context;
+	std::size_t m_count;
+	std::size_t m_chunkSize;
+	std::atomic<std::size_t> m_nextChunk;
+};
+
+template<typename Function>
+void ThreadPool::ParallelFor(std::size_t count, std::size_t chunkSize, const Function& function)
+{
+	Run([](const void* context, std::size_t begin, std::size_t end)
+		{
+			(*static_cast<const Function*>(context))(begin, end);
+		}, &function, count, chunkSize);
+}
\ No newline at end of file
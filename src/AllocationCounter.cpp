@@ -0,0 +1,72 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+#include "AllocationCounter.hpp"
+
+namespace
+{
+	std::atomic<std::size_t> s_allocationCount(0);
+}
+
+std::size_t AllocationCounter::GetCount()
+{
+	return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+// Replacements of the global allocation functions, the array and nothrow versions forward to these.
+// Over-aligned types, such as the SIMD batches, go through the aligned versions instead
+void* operator new(std::size_t size)
+{
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+		throw std::bad_alloc();
+
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	const std::size_t align = static_cast<std::size_t>(alignment);
+	const std::size_t alignedSize = size > 0 ? (size + align - 1) / align * align : align;
+#if defined(_MSC_VER)
+	void* memory = _aligned_malloc(alignedSize, align);
+#else
+	// aligned_alloc needs a size multiple of the alignment
+	void* memory = std::aligned_alloc(align, alignedSize);
+#endif
+	if (memory == nullptr)
+		throw std::bad_alloc();
+
+	return memory;
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+#if defined(_MSC_VER)
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
@@ -0,0 +1,88 @@
+#include "BodyHandle.hpp"
+
+bool BodyHandle::IsValid() const
+{
+	return index != InvalidIndex;
+}
+
+bool BodyHandle::operator==(const BodyHandle& other) const
+{
+	return index == other.index && generation == other.generation;
+}
+
+bool BodyHandle::operator!=(const BodyHandle& other) const
+{
+	return !(*this == other);
+}
+
+BodyHandle HandleTable::Create(unsigned int denseIndex)
+{
+	BodyHandle handle;
+
+	if (!m_freeSlots.empty())
+	{
+		handle.index = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		handle.index = static_cast<unsigned int>(m_slots.size());
+		m_slots.push_back({ BodyHandle::InvalidIndex, 0 });
+	}
+
+	Slot& slot = m_slots[handle.index];
+	slot.denseIndex = denseIndex;
+	handle.generation = slot.generation;
+
+	return handle;
+}
+
+void HandleTable::Destroy(const BodyHandle& handle)
+{
+	if (!IsAlive(handle))
+		return;
+
+	Slot& slot = m_slots[handle.index];
+	slot.denseIndex = BodyHandle::InvalidIndex;
+	slot.generation++;
+	m_freeSlots.push_back(handle.index);
+}
+
+void HandleTable::Clear()
+{
+	// Keep the slots so the generations keep growing and old handles stay invalid
+	m_freeSlots.clear();
+	for (unsigned int i = 0; i < m_slots.size(); ++i)
+	{
+		if (m_slots[i].denseIndex != BodyHandle::InvalidIndex)
+		{
+			m_slots[i].denseIndex = BodyHandle::InvalidIndex;
+			m_slots[i].generation++;
+		}
+		m_freeSlots.push_back(i);
+	}
+}
+
+void HandleTable::Reserve(std::size_t capacity)
+{
+	m_slots.reserve(capacity);
+	m_freeSlots.reserve(capacity);
+}
+
+bool HandleTable::IsAlive(const BodyHandle& handle) const
+{
+	return handle.index < m_slots.size()
+		&& m_slots[handle.index].generation == handle.generation
+		&& m_slots[handle.index].denseIndex != BodyHandle::InvalidIndex;
+}
+
+unsigned int HandleTable::GetDenseIndex(const BodyHandle& handle) const
+{
+	return IsAlive(handle) ? m_slots[handle.index].denseIndex : BodyHandle::InvalidIndex;
+}
+
+void HandleTable::SetDenseIndex(const BodyHandle& handle, unsigned int denseIndex)
+{
+	if (IsAlive(handle))
+		m_slots[handle.index].denseIndex = denseIndex;
+}
@@ -1,3 +1,4 @@
+#include <cmath>
 #include <Collision/BoundingBox.hpp>
 
 BoundingBox::BoundingBox() :
@@ -6,9 +7,9 @@ BoundingBox::BoundingBox() :
 {
 }
 
-BoundingBox::BoundingBox(const Vector3f& m_center, const Vector3f& m_halfSize) :
-	m_center(m_center),
-	m_halfSize(m_halfSize)
+BoundingBox::BoundingBox(const Vector3f& center, const Vector3f& halfSize) :
+	m_center(center),
+	m_halfSize(halfSize)
 {
 }
 
@@ -28,15 +29,20 @@ BoundingBox::BoundingBox(const BoundingBox& one, const BoundingBox& two)
 
 bool BoundingBox::Overlaps(std::shared_ptr<BoundingBox> other) const
 {
-	if (abs(m_center.x - other->m_center.x) > (m_halfSize.x + other->m_halfSize.x))
+	return Overlaps(*other);
+}
+
+bool BoundingBox::Overlaps(const BoundingBox& other) const
+{
+	if (std::abs(m_center.x - other.m_center.x) > (m_halfSize.x + other.m_halfSize.x))
 	{
 		return false;
 	}
-	if (abs(m_center.y - other->m_center.y) > (m_halfSize.y + other->m_halfSize.y))
+	if (std::abs(m_center.y - other.m_center.y) > (m_halfSize.y + other.m_halfSize.y))
 	{
 		return false;
 	}
-	if (abs(m_center.z - other->m_center.z) > (m_halfSize.z + other->m_halfSize.z))
+	if (std::abs(m_center.z - other.m_center.z) > (m_halfSize.z + other.m_halfSize.z))
 	{
 		return false;
 	}
@@ -55,12 +61,38 @@ Vector3f BoundingBox::GetHalfSize() const
 
 float BoundingBox::GetSize() const
 {
-	return m_halfSize.x * 2.0f;
+	return 8.0f * m_halfSize.x * m_halfSize.y * m_halfSize.z;
+}
+
+float BoundingBox::GetSurfaceArea() const
+{
+	return 8.0f * (m_halfSize.x * m_halfSize.y + m_halfSize.y * m_halfSize.z + m_halfSize.z * m_halfSize.x);
+}
+
+float BoundingBox::GetGrowth(std::shared_ptr<BoundingBox> other) const
+{
+	return GetGrowth(*other);
+}
+
+float BoundingBox::GetGrowth(const BoundingBox& other) const
+{
+	return BoundingBox(*this, other).GetSurfaceArea() - GetSurfaceArea();
+}
+
+BoundingBox BoundingBox::GetAtPose(const Matrix4f& transform) const
+{
+	// Every world axis of the box spans the projection of the three body axes on it
+	Vector3f halfSize;
+	halfSize.x = std::abs(transform(0, 0)) * m_halfSize.x + std::abs(transform(0, 1)) * m_halfSize.y + std::abs(transform(0, 2)) * m_halfSize.z;
+	halfSize.y = std::abs(transform(1, 0)) * m_halfSize.x + std::abs(transform(1, 1)) * m_halfSize.y + std::abs(transform(1, 2)) * m_halfSize.z;
+	halfSize.z = std::abs(transform(2, 0)) * m_halfSize.x + std::abs(transform(2, 1)) * m_halfSize.y + std::abs(transform(2, 2)) * m_halfSize.z;
+
+	return BoundingBox(Vector3f(transform(0, 3), transform(1, 3), transform(2, 3)), halfSize);
 }
 
-float BoundingBox::GetGrowth(std::shared_ptr<BoundingVolume> other) const
+bool BoundingBox::OverlapsHalfSpace(const Vector3f& normal, float offset) const
 {
-	auto box = std::dynamic_pointer_cast<BoundingBox>(other);
-	Vector3f newHalf = Vector3f::Max(m_halfSize, box->m_halfSize);
-	return (newHalf.x * 2.0f) - GetSize();
+	// Half extent of the box along the normal
+	float radius = std::abs(normal.x) * m_halfSize.x + std::abs(normal.y) * m_halfSize.y + std::abs(normal.z) * m_halfSize.z;
+	return normal * m_center - radius <= offset;
 }
\ No newline at end of file
@@ -9,7 +9,7 @@ BoundingSphere::BoundingSphere() :
 }
 
 BoundingSphere::BoundingSphere(std::shared_ptr<Rigidbody> rigidbody) :
-	m_center(rigidbody->position),
+	m_center(rigidbody->GetPosition()),
 	m_radius(rigidbody->scale.x)
 {
 }
@@ -20,24 +20,29 @@ BoundingSphere::BoundingSphere(const Vector3f& center, float radius) :
 {
 }
 
-BoundingSphere::BoundingSphere(std::shared_ptr<BoundingSphere> one, std::shared_ptr<BoundingSphere> two)
+BoundingSphere::BoundingSphere(std::shared_ptr<BoundingSphere> one, std::shared_ptr<BoundingSphere> two) :
+	BoundingSphere(*one, *two)
 {
-	Vector3f centerOffset = two->m_center - one->m_center;
-	float distance = centerOffset.GetLength();
-	float radiusDiff = two->m_radius - one->m_radius;
+}
+
+BoundingSphere::BoundingSphere(const BoundingSphere& one, const BoundingSphere& two)
+{
+	Vector3f centerOffset = two.m_center - one.m_center;
+	float distance = centerOffset.GetLengthSquared();
+	float radiusDiff = two.m_radius - one.m_radius;
 
 	// Check if the larger sphere encloses the small one
 	if (radiusDiff * radiusDiff >= distance)
 	{
-		if (one->m_radius > two->m_radius)
+		if (one.m_radius > two.m_radius)
 		{
-			m_center = one->m_center;
-			m_radius = one->m_radius;
+			m_center = one.m_center;
+			m_radius = one.m_radius;
 		}
 		else
 		{
-			m_center = two->m_center;
-			m_radius = two->m_radius;
+			m_center = two.m_center;
+			m_radius = two.m_radius;
 		}
 	}
 	// Otherwise we need to work with partially overlapping spheres
@@ -45,22 +50,27 @@ BoundingSphere::BoundingSphere(std::shared_ptr<BoundingSphere> one, std::shared_
 	{
 		distance = sqrt(distance);
 		// The new radius is a combination of both
-		m_radius = (distance + one->m_radius + two->m_radius) * 0.5f;
+		m_radius = (distance + one.m_radius + two.m_radius) * 0.5f;
 
 		// The new center is an interpolation of both
-		m_center = one->m_center;
+		m_center = one.m_center;
 		if (distance > 0.0f)
 		{
 
-			m_center += centerOffset * ((m_radius - one->m_radius) / distance);
+			m_center += centerOffset * ((m_radius - one.m_radius) / distance);
 		}
 	}
 }
 
 bool BoundingSphere::Overlaps(std::shared_ptr<BoundingSphere> other) const
 {
-	float distanceSquared = (m_center - other->m_center).GetLengthSquared();
-	return distanceSquared < (m_radius + other->m_radius) * (m_radius + other->m_radius);
+	return Overlaps(*other);
+}
+
+bool BoundingSphere::Overlaps(const BoundingSphere& other) const
+{
+	float distanceSquared = (m_center - other.m_center).GetLengthSquared();
+	return distanceSquared < (m_radius + other.m_radius) * (m_radius + other.m_radius);
 }
 
 Vector3f BoundingSphere::GetCenter() const
@@ -73,15 +83,39 @@ float BoundingSphere::GetRadius() const
 	return m_radius;
 }
 
+Vector3f BoundingSphere::GetHalfSize() const
+{
+	return Vector3f(m_radius, m_radius, m_radius);
+}
+
 float BoundingSphere::GetSize() const
 {
 	return (4.0f / 3.0f) * PI * m_radius * m_radius * m_radius;
 }
 
+float BoundingSphere::GetSurfaceArea() const
+{
+	return 4.0f * PI * m_radius * m_radius;
+}
+
 float BoundingSphere::GetGrowth(std::shared_ptr<BoundingSphere> other) const
 {
-	auto sphere = other;
-	Vector3f centerOffset = m_center - sphere->m_center;
+	return GetGrowth(*other);
+}
+
+float BoundingSphere::GetGrowth(const BoundingSphere& other) const
+{
+	Vector3f centerOffset = m_center - other.m_center;
 	float distance = centerOffset.GetLength();
-	return (distance + m_radius + sphere->m_radius) - m_radius;
+	return (distance + m_radius + other.m_radius) - m_radius;
+}
+
+BoundingSphere BoundingSphere::GetAtPose(const Matrix4f& transform) const
+{
+	return BoundingSphere(Vector3f(transform(0, 3), transform(1, 3), transform(2, 3)), m_radius);
+}
+
+bool BoundingSphere::OverlapsHalfSpace(const Vector3f& normal, float offset) const
+{
+	return normal * m_center - m_radius <= offset;
 }
\ No newline at end of file
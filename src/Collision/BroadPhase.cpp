@@ -0,0 +1,6 @@
+#include <Collision/BroadPhase.hpp>
+
+bool BroadPhase::IsTruncated() const
+{
+	return m_truncated;
+}
\ No newline at end of file
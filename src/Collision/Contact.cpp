@@ -1,29 +1,30 @@
 #include "Collision/Contact.hpp"
 #include "Rigidbody.hpp"
+#include "RigidbodyStorage.hpp"
 #include <array>
 
-Contact::Contact(std::vector<std::shared_ptr<Rigidbody>>& rigidbodies, Vector3f contactPoint, Vector3f contactNormal, float penetration)
+Contact::Contact(const BodyHandle& first, const BodyHandle& second, Vector3f contactPoint, Vector3f contactNormal, float penetration)
 {
-	this->rigidbodies = rigidbodies;
+	this->bodies = { first, second };
 	this->contactPoint = contactPoint;
 	this->contactNormal = contactNormal;
 	this->penetration = penetration;
 }
 
-void Contact::PreCalculation(float duration)
+void Contact::PreCalculation(RigidbodyStorage& rigidbodies, float duration)
 {
     CalculateContactBasis();
 
-    relativeContactPosition[0] = contactPoint - rigidbodies[0]->position;
-    if (rigidbodies[1])
-        relativeContactPosition[1] = contactPoint - rigidbodies[1]->position;
+    relativeContactPosition[0] = contactPoint - rigidbodies.GetRigidbody(bodies[0])->GetPosition();
+    if (bodies[1].IsValid())
+        relativeContactPosition[1] = contactPoint - rigidbodies.GetRigidbody(bodies[1])->GetPosition();
 
-    contactVelocity = CalculateLocalVelocity(0, duration);
+    contactVelocity = CalculateLocalVelocity(rigidbodies, 0, duration);
 
-    if (rigidbodies[1])
-        contactVelocity -= CalculateLocalVelocity(1, duration);
+    if (bodies[1].IsValid())
+        contactVelocity -= CalculateLocalVelocity(rigidbodies, 1, duration);
 
-    CalculateDeltaVelocity(duration);
+    CalculateDeltaVelocity(rigidbodies, duration);
 }
 
 void Contact::CalculateContactBasis()
@@ -62,18 +63,20 @@ void Contact::CalculateContactBasis()
     contactToWorld = Matrix3f(values);
 }
 
-void Contact::CalculateDeltaVelocity(float duration)
+void Contact::CalculateDeltaVelocity(RigidbodyStorage& rigidbodies, float duration)
 {
     float velocityAcceleration = 0;
 
-    if (rigidbodies[0]->isAwake)
+    Rigidbody* rigidbody = rigidbodies.GetRigidbody(bodies[0]);
+    if (rigidbody->IsAwake())
     {
-        velocityAcceleration += rigidbodies[0]->GetAcceleration() * duration * contactNormal;
+        velocityAcceleration += rigidbody->GetAcceleration() * duration * contactNormal;
     }
 
-    if (rigidbodies[1] && rigidbodies[1]->isAwake)
+    Rigidbody* otherRigidbody = rigidbodies.GetRigidbody(bodies[1]);
+    if (otherRigidbody && otherRigidbody->IsAwake())
     {
-        velocityAcceleration -= rigidbodies[1]->GetAcceleration() * duration * contactNormal;
+        velocityAcceleration -= otherRigidbody->GetAcceleration() * duration * contactNormal;
     }
 
     float thisRestitution = 0.f;//restitution
@@ -85,15 +88,18 @@ void Contact::CalculateDeltaVelocity(float duration)
     deltaVelocity = -contactVelocity.x - thisRestitution * (contactVelocity.x - velocityAcceleration);
 }
 
-Vector3f Contact::CalculateLocalVelocity(int index, float duration)
+Vector3f Contact::CalculateLocalVelocity(RigidbodyStorage& rigidbodies, int index, float duration)
 {
-    Vector3 velocity = Vector3f::CrossProduct(rigidbodies[index]->rotation.GetRotation(), relativeContactPosition[index]);
-    velocity += rigidbodies[index]->velocity;
+    Rigidbody* rigidbody = rigidbodies.GetRigidbody(bodies[index]);
 
-    Vector3 contactVelocity = contactToWorld.TransformTranspose(velocity);
+    Vector3 velocity = Vector3f::CrossProduct(rigidbody->GetAngularVelocity(), relativeContactPosition[index]);
+    velocity += rigidbody->GetVelocity();
 
-    Vector3 accelerationVelocity = rigidbodies[index]->GetAcceleration() * duration;
-    accelerationVelocity = contactToWorld.TransformTranspose(accelerationVelocity);
+    // The rows of contactToWorld are the contact axes, multiplying by it goes from world to contact space
+    Vector3 contactVelocity = contactToWorld * velocity;
+
+    Vector3 accelerationVelocity = rigidbody->GetAcceleration() * duration;
+    accelerationVelocity = contactToWorld * accelerationVelocity;
     accelerationVelocity.x = 0;
 
     contactVelocity += accelerationVelocity;
@@ -4,19 +4,121 @@
 #include "Collision/Primitives/Sphere.hpp"
 #include "Collision/Primitives/Plane.hpp"
 #include "Collision/Primitives/Box.hpp"
+#include "Collision/Primitives/ConvexHull.hpp"
+#include "Collision/Primitives/Tetrahedron.hpp"
+#include "Collision/PairCache.hpp"
 #include "Rigidbody.hpp"
+#include "RigidbodyStorage.hpp"
 
 #include <math.h>
+#include <cfloat>
+#include <algorithm>
 
-ContactGenerator::ContactGenerator(float maxContacts)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CONTACT_GENERATOR_SSE
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CONTACT_GENERATOR_AVX2
+#endif
+
+namespace
+{
+	constexpr int BoxAxisCount = 15;
+	// The box axes are tested four at a time, the last lane is padding
+	constexpr int BoxAxisLaneCount = 16;
+	// Below this squared length the cross product of two edges is no axis, the edges are parallel
+	constexpr float ParallelEdgeEpsilon = 1e-6f;
+	// An edge axis has to be clearly better than the best face axis, face contacts are more stable
+	constexpr float EdgeAxisTolerance = 0.95f;
+	constexpr float EdgeAxisOffset = 0.01f;
+	// Pairs tested per iteration of the batched sphere tests, the floats of an AVX register
+	constexpr unsigned int BatchLaneCount = 8;
+
+	// Sutherland-Hodgman clip of a convex polygon, keeps the part where normal * point <= offset
+	int ClipPolygon(const Vector3f* vertices, int count, const Vector3f& normal, float offset, Vector3f* clipped)
+	{
+		int clippedCount = 0;
+		for (int i = 0; i < count; i++)
+		{
+			const Vector3f& start = vertices[i];
+			const Vector3f& end = vertices[(i + 1) % count];
+			float startDistance = normal * start - offset;
+			float endDistance = normal * end - offset;
+
+			if (startDistance <= 0.0f)
+				clipped[clippedCount++] = start;
+			if ((startDistance < 0.0f && endDistance > 0.0f) || (startDistance > 0.0f && endDistance < 0.0f))
+				clipped[clippedCount++] = start + (end - start) * (startDistance / (startDistance - endDistance));
+		}
+
+		return clippedCount;
+	}
+
+	// The core of a sphere is its center
+	const Vector3f SphereCore[1] = { Vector3f(0.0f, 0.0f, 0.0f) };
+
+	// The table only calls it with primitives of types A and B, the casts need no check
+	template<typename A, typename B, void (ContactGenerator::*Detect)(const A&, const B&)>
+	void DetectPair(ContactGenerator& generator, const Primitive& primitiveA, const Primitive& primitiveB, CachedPair* /*pair*/)
+	{
+		(generator.*Detect)(static_cast<const A&>(primitiveA), static_cast<const B&>(primitiveB));
+	}
+
+	void DetectConvexPair(ContactGenerator& generator, const Primitive& primitiveA, const Primitive& primitiveB, CachedPair* pair)
+	{
+		generator.DetectConvex(primitiveA, primitiveB, pair != nullptr ? &pair->simplex : nullptr);
+	}
+}
+
+ContactGenerator::ContactGenerator(unsigned int maxContacts, RigidbodyStorage& rigidbodies) :
+	m_rigidbodies(rigidbodies)
 {
 	this->maxContacts = maxContacts;
 	currentContacts = 0;
+	isTruncated = false;
+	contacts.resize(this->maxContacts);
+
+	RegisterCollision(TypeSphere, TypeSphere, &DetectPair<Sphere, Sphere, &ContactGenerator::DetectSandS>);
+	RegisterCollision(TypeSphere, TypeBox, &DetectPair<Sphere, Box, &ContactGenerator::DetectSandB>);
+	RegisterCollision(TypeSphere, TypePlane, &DetectPair<Sphere, Plane, &ContactGenerator::DetectSandP>);
+	RegisterCollision(TypeBox, TypeBox, &DetectPair<Box, Box, &ContactGenerator::DetectBandB>);
+	RegisterCollision(TypeBox, TypePlane, &DetectPair<Box, Plane, &ContactGenerator::DetectBandP>);
+
+	for (PrimitiveType type : { TypeConvexHull, TypeTetrahedron })
+	{
+		RegisterCollision(type, TypeSphere, &DetectConvexPair);
+		RegisterCollision(type, TypeBox, &DetectConvexPair);
+		RegisterCollision(type, TypeConvexHull, &DetectConvexPair);
+		RegisterCollision(type, TypeTetrahedron, &DetectConvexPair);
+		RegisterCollision(type, TypePlane, &DetectPair<Primitive, Plane, &ContactGenerator::DetectCandP>);
+	}
+}
+
+void ContactGenerator::RegisterCollision(PrimitiveType typeA, PrimitiveType typeB, CollisionFunction function)
+{
+	m_collisions[typeA][typeB] = { function, false };
+	if (typeA != typeB)
+		m_collisions[typeB][typeA] = { function, true };
 }
 
-std::vector<std::shared_ptr<Contact>>& ContactGenerator::GetContacts()
+void ContactGenerator::Detect(const Primitive& primitiveA, const Primitive& primitiveB, CachedPair* pair /*= nullptr*/)
 {
-	return contacts;
+	const CollisionEntry& entry = m_collisions[primitiveA.type][primitiveB.type];
+	if (entry.function == nullptr)
+		return;
+
+	if (entry.isSwapped)
+		entry.function(*this, primitiveB, primitiveA, pair);
+	else
+		entry.function(*this, primitiveA, primitiveB, pair);
+}
+
+Contact* ContactGenerator::GetContacts()
+{
+	return contacts.data();
 }
 
 void ContactGenerator::SetCurrentContacts(const int newContacts)
@@ -29,132 +131,325 @@ int ContactGenerator::GetCurrentContacts()
 	return currentContacts;
 }
 
+unsigned int ContactGenerator::GetMaxContacts() const
+{
+	return maxContacts;
+}
+
+void ContactGenerator::SetMaxContacts(unsigned int maxContacts)
+{
+	this->maxContacts = maxContacts;
+	contacts.resize(maxContacts);
+	currentContacts = std::min(currentContacts, maxContacts);
+}
+
+bool ContactGenerator::IsTruncated() const
+{
+	return isTruncated;
+}
+
+void ContactGenerator::Reset()
+{
+	currentContacts = 0;
+	isTruncated = false;
+}
+
+bool ContactGenerator::IsFull()
+{
+	if (currentContacts < maxContacts)
+		return false;
+
+	isTruncated = true;
+	return true;
+}
+
+Contact* ContactGenerator::GetNextContact()
+{
+	Contact* contact = &contacts[currentContacts++];
+	*contact = Contact();
+
+	return contact;
+}
+
 void ContactGenerator::DetectSandS(const Sphere& sphereA, const Sphere& sphereB)
 {
-	if (currentContacts >= maxContacts) return;
+	if (IsFull()) return;
 
-	Vector3f posA = sphereA.rigidbody->position;
-	Vector3f posB = sphereB.rigidbody->position;
+	Vector3f posA = m_rigidbodies.GetRigidbody(sphereA.body)->GetPosition();
+	Vector3f posB = m_rigidbodies.GetRigidbody(sphereB.body)->GetPosition();
 
 	float distance = (posA - posB).GetLength();
 
 	if (distance <= 0.f || distance >= sphereA.radius + sphereB.radius) return;
 
-	std::shared_ptr<Contact> contact = std::make_shared<Contact>();
+	Contact* contact = GetNextContact();
 	contact->contactNormal = (posA - posB) * (1.f / distance);
-	contact->contactPoint = posA + (posA - posB) * 0.5f;
+	contact->contactPoint = posA - (posA - posB) * 0.5f;
 	contact->penetration = sphereA.radius + sphereB.radius - distance;
 
-	std::vector<std::shared_ptr<Rigidbody>> rbs;
-	rbs.push_back(sphereA.rigidbody);
-	rbs.push_back(sphereB.rigidbody);
-
-	contact->rigidbodies = rbs;
-
-	contacts.push_back(contact);
-
-	currentContacts++;
+	contact->bodies = { sphereA.body, sphereB.body };
 }
 
 void ContactGenerator::DetectSandHS(const Sphere& sphere, const Plane& plane)
 {
-	if (currentContacts >= maxContacts) return;
+	if (IsFull()) return;
 
-	Vector3f sPos = sphere.rigidbody->position;
+	Vector3f sPos = m_rigidbodies.GetRigidbody(sphere.body)->GetPosition();
 
 	float distanceFromPlane = plane.normal * sPos - sphere.radius - plane.offset;
 
 	if (distanceFromPlane >= 0) return; // No collision
 
-	std::shared_ptr<Contact> contact = std::make_shared<Contact>();
+	Contact* contact = GetNextContact();
 	contact->contactNormal = plane.normal;
 	contact->contactPoint = sPos - plane.normal * (distanceFromPlane + sphere.radius);
 	contact->penetration = -distanceFromPlane;
 
-	std::vector<std::shared_ptr<Rigidbody>> rbs;
-	rbs.push_back(sphere.rigidbody);
-	rbs.push_back(plane.rigidbody);
-
-	contact->rigidbodies = rbs;
-
-	contacts.push_back(contact);
-
-	currentContacts++;
+	contact->bodies = { sphere.body, plane.body };
 }
 
 void ContactGenerator::DetectSandP(const Sphere& sphere, const Plane& plane)
 {
-	if (currentContacts >= maxContacts) return;
+	if (IsFull()) return;
 
-	Vector3f sPos = sphere.rigidbody->position;
+	Vector3f sPos = m_rigidbodies.GetRigidbody(sphere.body)->GetPosition();
 
 	float distance = plane.normal * sPos - plane.offset;
 
 	if (distance * distance > sphere.radius * sphere.radius) return;
 
-	std::shared_ptr<Contact> contact = std::make_shared<Contact>();
+	Contact* contact = GetNextContact();
 	contact->contactNormal = distance < 0 ? plane.normal*-1.f : plane.normal;
 	contact->contactPoint = sPos - plane.normal * distance;
-	contact->penetration = distance < 0 ? distance : -distance;
+	contact->penetration = sphere.radius - std::abs(distance);
 
-	std::vector<std::shared_ptr<Rigidbody>> rbs;
-	rbs.push_back(sphere.rigidbody);
-	rbs.push_back(plane.rigidbody);
+	contact->bodies = { sphere.body, plane.body };
+}
 
-	contact->rigidbodies = rbs;
+unsigned int ContactGenerator::DetectSandSBatch(const SpherePair* pairs, unsigned int count, unsigned int* hitPairs)
+{
+	const unsigned int firstContact = currentContacts;
+
+#if defined(CONTACT_GENERATOR_AVX2)
+	// Pair data gathered lane by lane, then loaded as one register per coordinate
+	alignas(32) float positionsA[3][BatchLaneCount];
+	alignas(32) float positionsB[3][BatchLaneCount];
+	alignas(32) float radii[BatchLaneCount];
+	// Results of every lane, only read for the touching ones
+	alignas(32) float normals[3][BatchLaneCount];
+	alignas(32) float points[3][BatchLaneCount];
+	alignas(32) float penetrations[BatchLaneCount];
+
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+
+	for (unsigned int first = 0; first < count && !IsFull(); first += BatchLaneCount)
+	{
+		const unsigned int laneCount = std::min(count - first, BatchLaneCount);
+		for (unsigned int lane = 0; lane < BatchLaneCount; lane++)
+		{
+			// The lanes past the last pair are masked out, they only need to hold numbers
+			const SpherePair* pair = &pairs[first + std::min(lane, laneCount - 1)];
+			const Vector3f& positionA = m_rigidbodies.positions[m_rigidbodies.GetIndex(pair->sphereA->body)];
+			const Vector3f& positionB = m_rigidbodies.positions[m_rigidbodies.GetIndex(pair->sphereB->body)];
+
+			positionsA[0][lane] = positionA.x;
+			positionsA[1][lane] = positionA.y;
+			positionsA[2][lane] = positionA.z;
+			positionsB[0][lane] = positionB.x;
+			positionsB[1][lane] = positionB.y;
+			positionsB[2][lane] = positionB.z;
+			radii[lane] = pair->sphereA->radius + pair->sphereB->radius;
+		}
+
+		const __m256 ax = _mm256_load_ps(positionsA[0]);
+		const __m256 ay = _mm256_load_ps(positionsA[1]);
+		const __m256 az = _mm256_load_ps(positionsA[2]);
+		const __m256 dx = _mm256_sub_ps(ax, _mm256_load_ps(positionsB[0]));
+		const __m256 dy = _mm256_sub_ps(ay, _mm256_load_ps(positionsB[1]));
+		const __m256 dz = _mm256_sub_ps(az, _mm256_load_ps(positionsB[2]));
+		const __m256 radius = _mm256_load_ps(radii);
+
+		const __m256 distance = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+
+		// Same test as DetectSandS, concentric spheres have no normal
+		const __m256 isTouching = _mm256_and_ps(_mm256_cmp_ps(distance, zero, _CMP_GT_OQ), _mm256_cmp_ps(distance, radius, _CMP_LT_OQ));
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(isTouching)) & ((1u << laneCount) - 1);
+		if (mask == 0)
+			continue;
+
+		const __m256 inverseDistance = _mm256_div_ps(one, distance);
+		_mm256_store_ps(normals[0], _mm256_mul_ps(dx, inverseDistance));
+		_mm256_store_ps(normals[1], _mm256_mul_ps(dy, inverseDistance));
+		_mm256_store_ps(normals[2], _mm256_mul_ps(dz, inverseDistance));
+		_mm256_store_ps(points[0], _mm256_sub_ps(ax, _mm256_mul_ps(dx, half)));
+		_mm256_store_ps(points[1], _mm256_sub_ps(ay, _mm256_mul_ps(dy, half)));
+		_mm256_store_ps(points[2], _mm256_sub_ps(az, _mm256_mul_ps(dz, half)));
+		_mm256_store_ps(penetrations, _mm256_sub_ps(radius, distance));
+
+		// Compacts the touching lanes at the end of the contact buffer
+		for (unsigned int lane = 0; mask != 0 && !IsFull(); lane++, mask >>= 1)
+		{
+			if ((mask & 1) == 0)
+				continue;
+
+			hitPairs[currentContacts - firstContact] = first + lane;
+
+			Contact* contact = GetNextContact();
+			contact->contactNormal = Vector3f(normals[0][lane], normals[1][lane], normals[2][lane]);
+			contact->contactPoint = Vector3f(points[0][lane], points[1][lane], points[2][lane]);
+			contact->penetration = penetrations[lane];
+
+			contact->bodies = { pairs[first + lane].sphereA->body, pairs[first + lane].sphereB->body };
+		}
+	}
+#else
+	for (unsigned int i = 0; i < count && !IsFull(); i++)
+	{
+		const unsigned int contactCount = currentContacts;
+		DetectSandS(*pairs[i].sphereA, *pairs[i].sphereB);
 
-	contacts.push_back(contact);
+		if (currentContacts != contactCount)
+			hitPairs[contactCount - firstContact] = i;
+	}
+#endif
 
-	currentContacts++;
+	return currentContacts - firstContact;
+}
+
+unsigned int ContactGenerator::DetectSandPBatch(const SpherePlanePair* pairs, unsigned int count, unsigned int* hitPairs)
+{
+	const unsigned int firstContact = currentContacts;
+
+#if defined(CONTACT_GENERATOR_AVX2)
+	alignas(32) float positions[3][BatchLaneCount];
+	alignas(32) float radii[BatchLaneCount];
+	alignas(32) float planeNormals[3][BatchLaneCount];
+	alignas(32) float planeOffsets[BatchLaneCount];
+	alignas(32) float normals[3][BatchLaneCount];
+	alignas(32) float points[3][BatchLaneCount];
+	alignas(32) float penetrations[BatchLaneCount];
+
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+
+	for (unsigned int first = 0; first < count && !IsFull(); first += BatchLaneCount)
+	{
+		const unsigned int laneCount = std::min(count - first, BatchLaneCount);
+		for (unsigned int lane = 0; lane < BatchLaneCount; lane++)
+		{
+			const SpherePlanePair* pair = &pairs[first + std::min(lane, laneCount - 1)];
+			const Vector3f& position = m_rigidbodies.positions[m_rigidbodies.GetIndex(pair->sphere->body)];
+
+			positions[0][lane] = position.x;
+			positions[1][lane] = position.y;
+			positions[2][lane] = position.z;
+			radii[lane] = pair->sphere->radius;
+			planeNormals[0][lane] = pair->plane->normal.x;
+			planeNormals[1][lane] = pair->plane->normal.y;
+			planeNormals[2][lane] = pair->plane->normal.z;
+			planeOffsets[lane] = pair->plane->offset;
+		}
+
+		const __m256 px = _mm256_load_ps(positions[0]);
+		const __m256 py = _mm256_load_ps(positions[1]);
+		const __m256 pz = _mm256_load_ps(positions[2]);
+		const __m256 nx = _mm256_load_ps(planeNormals[0]);
+		const __m256 ny = _mm256_load_ps(planeNormals[1]);
+		const __m256 nz = _mm256_load_ps(planeNormals[2]);
+		const __m256 radius = _mm256_load_ps(radii);
+
+		const __m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, px), _mm256_mul_ps(ny, py)), _mm256_mul_ps(nz, pz));
+		const __m256 distance = _mm256_sub_ps(dot, _mm256_load_ps(planeOffsets));
+
+		// Same test as DetectSandP, both sides of the plane collide
+		const __m256 isTouching = _mm256_cmp_ps(_mm256_mul_ps(distance, distance), _mm256_mul_ps(radius, radius), _CMP_NGT_UQ);
+		unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(isTouching)) & ((1u << laneCount) - 1);
+		if (mask == 0)
+			continue;
+
+		// Behind the plane the normal is reversed
+		const __m256 isBehind = _mm256_cmp_ps(distance, zero, _CMP_LT_OQ);
+		_mm256_store_ps(normals[0], _mm256_blendv_ps(nx, _mm256_xor_ps(nx, signBit), isBehind));
+		_mm256_store_ps(normals[1], _mm256_blendv_ps(ny, _mm256_xor_ps(ny, signBit), isBehind));
+		_mm256_store_ps(normals[2], _mm256_blendv_ps(nz, _mm256_xor_ps(nz, signBit), isBehind));
+		_mm256_store_ps(points[0], _mm256_sub_ps(px, _mm256_mul_ps(nx, distance)));
+		_mm256_store_ps(points[1], _mm256_sub_ps(py, _mm256_mul_ps(ny, distance)));
+		_mm256_store_ps(points[2], _mm256_sub_ps(pz, _mm256_mul_ps(nz, distance)));
+		_mm256_store_ps(penetrations, _mm256_sub_ps(radius, _mm256_andnot_ps(signBit, distance)));
+
+		for (unsigned int lane = 0; mask != 0 && !IsFull(); lane++, mask >>= 1)
+		{
+			if ((mask & 1) == 0)
+				continue;
+
+			hitPairs[currentContacts - firstContact] = first + lane;
+
+			Contact* contact = GetNextContact();
+			contact->contactNormal = Vector3f(normals[0][lane], normals[1][lane], normals[2][lane]);
+			contact->contactPoint = Vector3f(points[0][lane], points[1][lane], points[2][lane]);
+			contact->penetration = penetrations[lane];
+
+			contact->bodies = { pairs[first + lane].sphere->body, pairs[first + lane].plane->body };
+		}
+	}
+#else
+	for (unsigned int i = 0; i < count && !IsFull(); i++)
+	{
+		const unsigned int contactCount = currentContacts;
+		DetectSandP(*pairs[i].sphere, *pairs[i].plane);
+
+		if (currentContacts != contactCount)
+			hitPairs[contactCount - firstContact] = i;
+	}
+#endif
+
+	return currentContacts - firstContact;
 }
 
 void ContactGenerator::DetectSandB(const Sphere& sphere, const Box& box)
 {
-	if (currentContacts >= maxContacts) return;
+	if (IsFull()) return;
 
-	Vector3f center = sphere.rigidbody->position;
-	Vector3f rCenter = box.rigidbody->transformMatrix.TransformInverse(center);
+	Vector3f center = m_rigidbodies.GetRigidbody(sphere.body)->GetPosition();
+	const Rigidbody* boxRigidbody = m_rigidbodies.GetRigidbody(box.body);
+	Vector3f rCenter = boxRigidbody->GetTransformMatrix().TransformInverse(center - boxRigidbody->GetPosition());
+	// Clamp the center in box space to find the closest point of the box
 	Vector3f closestPoint;
-	float distance = center.x;
+	float distance = rCenter.x;
 
 	if (distance > box.halfSize.x) distance = box.halfSize.x;
 	if (distance < -box.halfSize.x) distance = -box.halfSize.x;
 	closestPoint.x = distance;
 
-	distance = center.y;
+	distance = rCenter.y;
 	if (distance > box.halfSize.y) distance = box.halfSize.y;
 	if (distance < -box.halfSize.y) distance = -box.halfSize.y;
 	closestPoint.y = distance;
 
+	distance = rCenter.z;
 	if (distance > box.halfSize.z) distance = box.halfSize.z;
 	if (distance < -box.halfSize.z) distance = -box.halfSize.z;
-	closestPoint.y = distance;
+	closestPoint.z = distance;
 
 	distance = (closestPoint - rCenter).GetLengthSquared();
 
 	if (distance > sphere.radius * sphere.radius) return;
 
-	Vector3f closestPointWorld = box.rigidbody->transformMatrix * closestPoint;
+	Vector3f closestPointWorld = boxRigidbody->GetTransformMatrix() * closestPoint;
 
-	std::shared_ptr<Contact> contact = std::make_shared<Contact>();
+	Contact* contact = GetNextContact();
 	contact->contactNormal = (closestPointWorld - center).GetNormalized();
 	contact->contactPoint = closestPointWorld;
 	contact->penetration = sphere.radius - std::sqrt(distance);
 
-	std::vector<std::shared_ptr<Rigidbody>> rbs;
-	rbs.push_back(box.rigidbody);
-	rbs.push_back(sphere.rigidbody);
-
-	contact->rigidbodies = rbs;
-
-	contacts.push_back(contact);
-
-	currentContacts++;
+	contact->bodies = { box.body, sphere.body };
 }
 
 void ContactGenerator::DetectBandP(const Box& box, const Plane& plane)
 {
-	if (currentContacts >= maxContacts) return;
+	if (IsFull()) return;
 
 	Vector3f vertices[8] = 
 	{
@@ -168,83 +463,401 @@ void ContactGenerator::DetectBandP(const Box& box, const Plane& plane)
 		Vector3f(box.halfSize.x, box.halfSize.y, box.halfSize.z)
 	};
 
+	// The box is placed by its body, then by its offset on that body
+	const Matrix4f transform = m_rigidbodies.GetRigidbody(box.body)->GetTransformMatrix() * box.offset;
+
 	for (auto i = 0; i < 8; i++)
 	{
-		vertices[i] = box.offset * vertices[i];
+		vertices[i] = transform * vertices[i];
 
 		float distance = vertices[i] * plane.normal;
 
 		if (distance > plane.offset) continue;
 
-		std::shared_ptr<Contact> contact = std::make_shared<Contact>();
+		Contact* contact = GetNextContact();
 		contact->contactNormal = plane.normal;
 		contact->contactPoint = plane.normal * (distance - plane.offset) + vertices[i];
 		contact->penetration = plane.offset - distance;
 
-		std::vector<std::shared_ptr<Rigidbody>> rbs;
-		rbs.push_back(plane.rigidbody);
-		rbs.push_back(nullptr);
+		contact->bodies = { box.body, plane.body };
+
+		if (IsFull()) break;
+	}
+}
+
+void ContactGenerator::DetectBandB(const Box& boxA, const Box& boxB)
+{
+	if (IsFull()) return;
+
+	BoxAxis axis;
+	if (!SATBandB(boxA, boxB, axis)) return;
+
+	if (axis.index < 3)
+		DetectBandBFace(boxA, boxB, boxA, boxB, axis);
+	else if (axis.index < 6)
+		DetectBandBFace(boxA, boxB, boxB, boxA, axis);
+	else
+		DetectBandBEdge(boxA, boxB, axis);
+}
+
+bool ContactGenerator::SATBandB(const Box& boxA, const Box& boxB, BoxAxis& axis) const
+{
+	const Rigidbody* rigidbodyA = m_rigidbodies.GetRigidbody(boxA.body);
+	const Rigidbody* rigidbodyB = m_rigidbodies.GetRigidbody(boxB.body);
+	const Matrix4f& transformA = rigidbodyA->GetTransformMatrix();
+	const Matrix4f& transformB = rigidbodyB->GetTransformMatrix();
+
+	const Vector3f axesA[3] = { transformA.GetAxis(0), transformA.GetAxis(1), transformA.GetAxis(2) };
+	const Vector3f axesB[3] = { transformB.GetAxis(0), transformB.GetAxis(1), transformB.GetAxis(2) };
+
+	// Everything is expressed in the frame of box A, where its axes are the unit axes and the axes of box B are the columns of rotation
+	float rotation[3][3];
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			rotation[i][j] = axesA[i] * axesB[j];
+	}
+
+	const Vector3f offset = rigidbodyB->GetPosition() - rigidbodyA->GetPosition();
+	const Vector3f center(offset * axesA[0], offset * axesA[1], offset * axesA[2]);
+
+	// The 15 axes in the frame of box A as a structure of arrays, the last lane repeats the first axis
+	alignas(16) float axisX[BoxAxisLaneCount];
+	alignas(16) float axisY[BoxAxisLaneCount];
+	alignas(16) float axisZ[BoxAxisLaneCount];
+	alignas(16) float penetrations[BoxAxisLaneCount];
+
+	const float halfSizeB[3] = { boxB.halfSize.x, boxB.halfSize.y, boxB.halfSize.z };
+	const Vector3f columnsB[3] =
+	{
+		Vector3f(rotation[0][0], rotation[1][0], rotation[2][0]),
+		Vector3f(rotation[0][1], rotation[1][1], rotation[2][1]),
+		Vector3f(rotation[0][2], rotation[1][2], rotation[2][2])
+	};
+
+	int lane = 0;
+	auto setAxis = [&](const Vector3f& localAxis)
+		{
+			axisX[lane] = localAxis.x;
+			axisY[lane] = localAxis.y;
+			axisZ[lane] = localAxis.z;
+			lane++;
+		};
+
+	setAxis(Vector3f::Right);
+	setAxis(Vector3f::Up);
+	setAxis(Vector3f::Forward);
+	for (int j = 0; j < 3; j++)
+		setAxis(columnsB[j]);
+	for (int i = 0; i < 3; i++)
+	{
+		for (int j = 0; j < 3; j++)
+			setAxis(Vector3f::CrossProduct(i == 0 ? Vector3f::Right : i == 1 ? Vector3f::Up : Vector3f::Forward, columnsB[j]));
+	}
+	setAxis(Vector3f::Right);
+
+	// On each axis the boxes overlap by the sum of their projected half sizes minus the projected distance between the centers.
+	// The overlap is divided by the length of the axis, edge axes are not unit, and the cross product of two parallel edges is no axis
+#if defined(CONTACT_GENERATOR_SSE)
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 noAxis = _mm_set1_ps(FLT_MAX);
+	const __m128 parallelEpsilon = _mm_set1_ps(ParallelEdgeEpsilon);
 
-		contact->rigidbodies = rbs;
+	for (int i = 0; i < BoxAxisLaneCount; i += 4)
+	{
+		const __m128 x = _mm_load_ps(axisX + i);
+		const __m128 y = _mm_load_ps(axisY + i);
+		const __m128 z = _mm_load_ps(axisZ + i);
+
+		__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(center.x)), _mm_mul_ps(y, _mm_set1_ps(center.y))), _mm_mul_ps(z, _mm_set1_ps(center.z)));
+		distance = _mm_andnot_ps(signMask, distance);
+
+		__m128 radius = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_andnot_ps(signMask, x), _mm_set1_ps(boxA.halfSize.x)),
+			_mm_mul_ps(_mm_andnot_ps(signMask, y), _mm_set1_ps(boxA.halfSize.y))),
+			_mm_mul_ps(_mm_andnot_ps(signMask, z), _mm_set1_ps(boxA.halfSize.z)));
+
+		for (int j = 0; j < 3; j++)
+		{
+			__m128 projection = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(rotation[0][j])), _mm_mul_ps(y, _mm_set1_ps(rotation[1][j]))), _mm_mul_ps(z, _mm_set1_ps(rotation[2][j])));
+			radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, projection), _mm_set1_ps(halfSizeB[j])));
+		}
+
+		const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		const __m128 isAxis = _mm_cmpgt_ps(lengthSquared, parallelEpsilon);
+		const __m128 overlap = _mm_sub_ps(radius, distance);
+
+		if (_mm_movemask_ps(_mm_and_ps(isAxis, _mm_cmple_ps(overlap, zero))) != 0)
+			return false;
+
+		const __m128 penetration = _mm_div_ps(overlap, _mm_sqrt_ps(_mm_max_ps(lengthSquared, parallelEpsilon)));
+		_mm_store_ps(penetrations + i, _mm_or_ps(_mm_and_ps(isAxis, penetration), _mm_andnot_ps(isAxis, noAxis)));
+	}
+#else
+	for (int i = 0; i < BoxAxisCount; i++)
+	{
+		const Vector3f localAxis(axisX[i], axisY[i], axisZ[i]);
+
+		float lengthSquared = localAxis.GetLengthSquared();
+		if (lengthSquared <= ParallelEdgeEpsilon)
+		{
+			penetrations[i] = FLT_MAX;
+			continue;
+		}
 
-		contacts.push_back(contact);
+		float radius = std::abs(localAxis.x) * boxA.halfSize.x + std::abs(localAxis.y) * boxA.halfSize.y + std::abs(localAxis.z) * boxA.halfSize.z;
+		for (int j = 0; j < 3; j++)
+			radius += std::abs(localAxis * columnsB[j]) * halfSizeB[j];
 
-		currentContacts++;
+		float overlap = radius - std::abs(localAxis * center);
+		if (overlap <= 0.0f)
+			return false;
 
-		if (currentContacts >= maxContacts) break;
+		penetrations[i] = overlap / std::sqrt(lengthSquared);
 	}
+#endif
+
+	int bestFace = 0;
+	for (int i = 1; i < 6; i++)
+	{
+		if (penetrations[i] < penetrations[bestFace])
+			bestFace = i;
+	}
+
+	int bestEdge = 6;
+	for (int i = 7; i < BoxAxisCount; i++)
+	{
+		if (penetrations[i] < penetrations[bestEdge])
+			bestEdge = i;
+	}
+
+	axis.index = penetrations[bestEdge] < EdgeAxisTolerance * penetrations[bestFace] - EdgeAxisOffset ? bestEdge : bestFace;
+	axis.penetration = penetrations[axis.index];
+
+	const Vector3f localAxis(axisX[axis.index], axisY[axis.index], axisZ[axis.index]);
+	axis.normal = (axesA[0] * localAxis.x + axesA[1] * localAxis.y + axesA[2] * localAxis.z).GetNormalized();
+	if (axis.normal * offset < 0.0f)
+		axis.normal *= -1.0f;
+
+	return true;
 }
 
-void ContactGenerator::DetectBandB(const Box& boxA, const Box& boxB)
+void ContactGenerator::DetectBandBFace(const Box& boxA, const Box& boxB, const Box& reference, const Box& incident, const BoxAxis& axis)
 {
-	if (!SATBandB(boxA, boxB)) return;
+	const Rigidbody* referenceBody = m_rigidbodies.GetRigidbody(reference.body);
+	const Rigidbody* incidentBody = m_rigidbodies.GetRigidbody(incident.body);
+	const Matrix4f& referenceTransform = referenceBody->GetTransformMatrix();
+	const Matrix4f& incidentTransform = incidentBody->GetTransformMatrix();
+
+	const float referenceHalfSize[3] = { reference.halfSize.x, reference.halfSize.y, reference.halfSize.z };
+	const float incidentHalfSize[3] = { incident.halfSize.x, incident.halfSize.y, incident.halfSize.z };
+
+	// Outward normal of the reference face, towards the incident box
+	const Vector3f normal = &reference == &boxA ? axis.normal : axis.normal * -1.0f;
+	const int referenceAxis = axis.index % 3;
+	const Vector3f faceCenter = referenceBody->GetPosition() + normal * referenceHalfSize[referenceAxis];
+
+	// The incident face is the one whose normal is the most opposed to the reference normal
+	int incidentAxis = 0;
+	float incidentDot = incidentTransform.GetAxis(0) * normal;
+	for (int i = 1; i < 3; i++)
+	{
+		float dot = incidentTransform.GetAxis(i) * normal;
+		if (std::abs(dot) > std::abs(incidentDot))
+		{
+			incidentAxis = i;
+			incidentDot = dot;
+		}
+	}
+
+	const float incidentSide = incidentDot > 0.0f ? -1.0f : 1.0f;
+	const Vector3f incidentCenter = incidentBody->GetPosition() + incidentTransform.GetAxis(incidentAxis) * (incidentSide * incidentHalfSize[incidentAxis]);
+	const Vector3f incidentU = incidentTransform.GetAxis((incidentAxis + 1) % 3) * incidentHalfSize[(incidentAxis + 1) % 3];
+	const Vector3f incidentV = incidentTransform.GetAxis((incidentAxis + 2) % 3) * incidentHalfSize[(incidentAxis + 2) % 3];
+
+	// Each clip against a side adds at most one vertex to the quad
+	Vector3f polygon[8] =
+	{
+		incidentCenter + incidentU + incidentV,
+		incidentCenter - incidentU + incidentV,
+		incidentCenter - incidentU - incidentV,
+		incidentCenter + incidentU - incidentV
+	};
+	Vector3f clipped[8];
+	int vertexCount = 4;
+
+	for (int i = 1; i < 3 && vertexCount > 0; i++)
+	{
+		const int sideAxis = (referenceAxis + i) % 3;
+		const Vector3f side = referenceTransform.GetAxis(sideAxis);
+		const float sideOffset = side * faceCenter;
+
+		vertexCount = ClipPolygon(polygon, vertexCount, side, sideOffset + referenceHalfSize[sideAxis], clipped);
+		vertexCount = ClipPolygon(clipped, vertexCount, side * -1.0f, referenceHalfSize[sideAxis] - sideOffset, polygon);
+	}
 
+	for (int i = 0; i < vertexCount && !IsFull(); i++)
+	{
+		float separation = normal * (polygon[i] - faceCenter);
+		if (separation > 0.0f) continue;
+
+		Contact* contact = GetNextContact();
+		contact->contactNormal = axis.normal * -1.0f;
+		contact->contactPoint = polygon[i];
+		contact->penetration = -separation;
+
+		contact->bodies = { boxA.body, boxB.body };
+	}
+}
+
+void ContactGenerator::DetectBandBEdge(const Box& boxA, const Box& boxB, const BoxAxis& axis)
+{
+	const Rigidbody* rigidbodyA = m_rigidbodies.GetRigidbody(boxA.body);
+	const Rigidbody* rigidbodyB = m_rigidbodies.GetRigidbody(boxB.body);
+	const Matrix4f& transformA = rigidbodyA->GetTransformMatrix();
+	const Matrix4f& transformB = rigidbodyB->GetTransformMatrix();
+
+	const float halfSizeA[3] = { boxA.halfSize.x, boxA.halfSize.y, boxA.halfSize.z };
+	const float halfSizeB[3] = { boxB.halfSize.x, boxB.halfSize.y, boxB.halfSize.z };
+	const int edgeA = (axis.index - 6) / 3;
+	const int edgeB = (axis.index - 6) % 3;
+
+	// Middle of the edge of each box lying the furthest towards the other box
+	Vector3f pointA = rigidbodyA->GetPosition();
+	Vector3f pointB = rigidbodyB->GetPosition();
+	for (int i = 0; i < 3; i++)
+	{
+		const Vector3f axisA = transformA.GetAxis(i);
+		const Vector3f axisB = transformB.GetAxis(i);
+
+		if (i != edgeA)
+			pointA += axisA * (axisA * axis.normal > 0.0f ? halfSizeA[i] : -halfSizeA[i]);
+		if (i != edgeB)
+			pointB += axisB * (axisB * axis.normal > 0.0f ? -halfSizeB[i] : halfSizeB[i]);
+	}
 
+	// Closest points of the two edges, the axis exists so they are not parallel
+	const Vector3f directionA = transformA.GetAxis(edgeA);
+	const Vector3f directionB = transformB.GetAxis(edgeB);
+	const Vector3f offset = pointA - pointB;
+	const float cosine = directionA * directionB;
+	const float projectionA = directionA * offset;
+	const float projectionB = directionB * offset;
+	const float denominator = std::max(1.0f - cosine * cosine, ParallelEdgeEpsilon);
+
+	float distanceA = (cosine * projectionB - projectionA) / denominator;
+	float distanceB = (projectionB - cosine * projectionA) / denominator;
+	distanceA = std::max(-halfSizeA[edgeA], std::min(distanceA, halfSizeA[edgeA]));
+	distanceB = std::max(-halfSizeB[edgeB], std::min(distanceB, halfSizeB[edgeB]));
+
+	Contact* contact = GetNextContact();
+	contact->contactNormal = axis.normal * -1.0f;
+	contact->contactPoint = (pointA + directionA * distanceA + pointB + directionB * distanceB) * 0.5f;
+	contact->penetration = axis.penetration;
+
+	contact->bodies = { boxA.body, boxB.body };
 }
 
-bool ContactGenerator::SAT(const Box& boxA, const Box& boxB, const Vector3f& axis)
+void ContactGenerator::DetectConvex(const Primitive& primitiveA, const Primitive& primitiveB, SimplexCache* cache /*= nullptr*/)
 {
-	float boxAProjection = boxA.halfSize.x + std::abs(Vector3f::DotProduct(axis, boxA.rigidbody->transformMatrix.GetAxis(0))) +
-		boxA.halfSize.y + std::abs(Vector3f::DotProduct(axis, boxA.rigidbody->transformMatrix.GetAxis(1))) +
-		boxA.halfSize.z + std::abs(Vector3f::DotProduct(axis, boxA.rigidbody->transformMatrix.GetAxis(2)));
+	if (IsFull()) return;
 
-	float boxBProjection = boxB.halfSize.x + std::abs(Vector3f::DotProduct(axis, boxB.rigidbody->transformMatrix.GetAxis(0))) +
-		boxB.halfSize.y + std::abs(Vector3f::DotProduct(axis, boxB.rigidbody->transformMatrix.GetAxis(0))) +
-		boxB.halfSize.z + std::abs(Vector3f::DotProduct(axis, boxB.rigidbody->transformMatrix.GetAxis(0)));
+	Vector3f boxVerticesA[8];
+	Vector3f boxVerticesB[8];
+	const ConvexShape shapeA = GetConvexShape(primitiveA, boxVerticesA);
+	const ConvexShape shapeB = GetConvexShape(primitiveB, boxVerticesB);
+	const float radius = shapeA.radius + shapeB.radius;
 
-	Vector3f center = boxB.rigidbody->position - boxA.rigidbody->position;
+	const GJKResult result = GJKDistance(shapeA, shapeB, cache);
+	if (result.distance >= radius && result.distance > 0.0f) return;
 
-	float distance = std::abs(Vector3f::DotProduct(center, axis));
+	// Normal from A towards B, the points are on the cores
+	Vector3f normal;
+	Vector3f pointA;
+	Vector3f pointB;
+	float penetration;
 
-	return (distance < boxAProjection + boxBProjection);
+	if (result.distance > 0.0f)
+	{
+		// Only the radii overlap, the closest points of the cores give the normal
+		normal = (result.pointB - result.pointA) / result.distance;
+		pointA = result.pointA;
+		pointB = result.pointB;
+		penetration = radius - result.distance;
+	}
+	else
+	{
+		Penetration deepest;
+		if (!EPAPenetration(shapeA, shapeB, result, deepest)) return;
+
+		normal = deepest.normal;
+		pointA = deepest.pointA;
+		pointB = deepest.pointB;
+		penetration = deepest.depth + radius;
+	}
+
+	Contact* contact = GetNextContact();
+	contact->contactNormal = normal * -1.0f;
+	contact->contactPoint = (pointA + normal * shapeA.radius + pointB - normal * shapeB.radius) * 0.5f;
+	contact->penetration = penetration;
+
+	contact->bodies = { primitiveA.body, primitiveB.body };
 }
 
-bool ContactGenerator::SATBandB(const Box& boxA, const Box& boxB)
+void ContactGenerator::DetectCandP(const Primitive& convex, const Plane& plane)
 {
-	Vector3f center = boxB.rigidbody->position - boxB.rigidbody->position;
+	Vector3f boxVertices[8];
+	const ConvexShape shape = GetConvexShape(convex, boxVertices);
 
-	return (
-		SAT(boxA, boxB, boxA.rigidbody->transformMatrix.GetAxis(0)) &&
-		SAT(boxA, boxB, boxA.rigidbody->transformMatrix.GetAxis(1)) &&
-		SAT(boxA, boxB, boxA.rigidbody->transformMatrix.GetAxis(2)) &&
+	for (unsigned int i = 0; i < shape.vertexCount && !IsFull(); i++)
+	{
+		const Vector3f vertex = *shape.transform * shape.vertices[i];
 
-		SAT(boxA, boxB, boxB.rigidbody->transformMatrix.GetAxis(0)) &&
-		SAT(boxA, boxB, boxB.rigidbody->transformMatrix.GetAxis(1)) &&
-		SAT(boxA, boxB, boxB.rigidbody->transformMatrix.GetAxis(2)) &&
+		float distance = plane.normal * vertex - plane.offset - shape.radius;
+		if (distance >= 0.0f) continue;
+
+		Contact* contact = GetNextContact();
+		contact->contactNormal = plane.normal;
+		contact->contactPoint = vertex - plane.normal * (distance + shape.radius);
+		contact->penetration = -distance;
 
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(0), boxB.rigidbody->transformMatrix.GetAxis(0))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(0), boxB.rigidbody->transformMatrix.GetAxis(1))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(0), boxB.rigidbody->transformMatrix.GetAxis(2))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(1), boxB.rigidbody->transformMatrix.GetAxis(0))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(1), boxB.rigidbody->transformMatrix.GetAxis(1))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(1), boxB.rigidbody->transformMatrix.GetAxis(2))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(2), boxB.rigidbody->transformMatrix.GetAxis(0))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(2), boxB.rigidbody->transformMatrix.GetAxis(1))) &&
-		SAT(boxA, boxB, Vector3f::CrossProduct(boxA.rigidbody->transformMatrix.GetAxis(2), boxB.rigidbody->transformMatrix.GetAxis(2)))
-		);
+		contact->bodies = { convex.body, plane.body };
+	}
 }
 
-float ContactGenerator::AxisPenetrationBandB(float boxAProjection, float boxBProjection, const Vector3f& center, const Vector3f& axis)
+ConvexShape ContactGenerator::GetConvexShape(const Primitive& primitive, Vector3f* boxVertices) const
 {
-	return boxAProjection + boxBProjection - (std::abs(center * axis));
-}
+	ConvexShape shape;
+	shape.transform = &m_rigidbodies.GetRigidbody(primitive.body)->GetTransformMatrix();
+	shape.radius = 0.0f;
+
+	switch (primitive.type)
+	{
+	case TypeSphere:
+		shape.vertices = SphereCore;
+		shape.vertexCount = 1;
+		shape.radius = static_cast<const Sphere&>(primitive).radius;
+		break;
+	case TypeBox:
+	{
+		const Vector3f& halfSize = static_cast<const Box&>(primitive).halfSize;
+		for (int i = 0; i < 8; i++)
+			boxVertices[i] = Vector3f(i & 1 ? halfSize.x : -halfSize.x, i & 2 ? halfSize.y : -halfSize.y, i & 4 ? halfSize.z : -halfSize.z);
+
+		shape.vertices = boxVertices;
+		shape.vertexCount = 8;
+		break;
+	}
+	case TypeTetrahedron:
+		shape.vertices = static_cast<const Tetrahedron&>(primitive).vertices.data();
+		shape.vertexCount = 4;
+		break;
+	default:
+		shape.vertices = static_cast<const ConvexHull&>(primitive).vertices.data();
+		shape.vertexCount = static_cast<unsigned int>(static_cast<const ConvexHull&>(primitive).vertices.size());
+		break;
+	}
+
+	return shape;
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include "Collision/ContactManifold.hpp"
+#include "Collision/Contact.hpp"
+#include "Rigidbody.hpp"
+#include "RigidbodyStorage.hpp"
+
+#include <cmath>
+
+namespace
+{
+	// Distance a point can drift on each body between two steps and still be the same point
+	constexpr float MatchDistance = 0.05f;
+
+	Vector3f GetLocalPoint(const RigidbodyStorage& rigidbodies, const BodyHandle& body, const Vector3f& point)
+	{
+		if (!rigidbodies.IsValid(body))
+			return point;
+
+		const Rigidbody* rigidbody = rigidbodies.GetRigidbody(body);
+		return rigidbody->GetTransformMatrix().TransformInverse(point - rigidbody->GetPosition());
+	}
+
+	// Twice the area of the triangle abc, signed by the side of the normal it faces
+	float GetSignedArea(const Vector3f& a, const Vector3f& b, const Vector3f& c, const Vector3f& normal)
+	{
+		return Vector3f::CrossProduct(b - a, c - a) * normal;
+	}
+}
+
+unsigned int ContactManifold::Update(Contact* contacts, unsigned int count, const RigidbodyStorage& rigidbodies)
+{
+	count = Reduce(contacts, count);
+
+	bool isMatched[MaxPoints] = {};
+	ManifoldPoint points[MaxPoints];
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		Contact& contact = contacts[i];
+		ManifoldPoint& point = points[i];
+		point.localPoints[0] = GetLocalPoint(rigidbodies, contact.bodies[0], contact.contactPoint);
+		point.localPoints[1] = GetLocalPoint(rigidbodies, contact.bodies[1], contact.contactPoint);
+		point.impulse = Vector3f::Zero;
+
+		// The closest point of the last step that stayed in place on both bodies
+		float closestDistance = 2.0f * MatchDistance * MatchDistance;
+		unsigned int closest = MaxPoints;
+		for (unsigned int j = 0; j < m_pointCount; j++)
+		{
+			float distanceA = (m_points[j].localPoints[0] - point.localPoints[0]).GetLengthSquared();
+			float distanceB = (m_points[j].localPoints[1] - point.localPoints[1]).GetLengthSquared();
+			if (isMatched[j] || distanceA > MatchDistance * MatchDistance || distanceB > MatchDistance * MatchDistance)
+				continue;
+
+			if (distanceA + distanceB < closestDistance)
+			{
+				closestDistance = distanceA + distanceB;
+				closest = j;
+			}
+		}
+
+		if (closest != MaxPoints)
+		{
+			isMatched[closest] = true;
+			point.impulse = m_points[closest].impulse;
+		}
+
+		contact.accumulatedImpulse = point.impulse;
+	}
+
+	for (unsigned int i = 0; i < count; i++)
+		m_points[i] = points[i];
+	m_pointCount = count;
+
+	return count;
+}
+
+void ContactManifold::StoreImpulses(const Contact* contacts)
+{
+	for (unsigned int i = 0; i < m_pointCount; i++)
+		m_points[i].impulse = contacts[i].accumulatedImpulse;
+}
+
+void ContactManifold::Clear()
+{
+	m_pointCount = 0;
+}
+
+const ManifoldPoint* ContactManifold::GetPoints() const
+{
+	return m_points;
+}
+
+unsigned int ContactManifold::GetPointCount() const
+{
+	return m_pointCount;
+}
+
+unsigned int ContactManifold::Reduce(Contact* contacts, unsigned int count)
+{
+	if (count <= MaxPoints)
+		return count;
+
+	unsigned int kept[MaxPoints];
+	unsigned int keptCount = 1;
+
+	// The deepest point, then the point furthest from it
+	kept[0] = 0;
+	for (unsigned int i = 1; i < count; i++)
+	{
+		if (contacts[i].penetration > contacts[kept[0]].penetration)
+			kept[0] = i;
+	}
+
+	const Vector3f& first = contacts[kept[0]].contactPoint;
+	float largest = 0.0f;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		float distance = (contacts[i].contactPoint - first).GetLengthSquared();
+		if (distance > largest)
+		{
+			largest = distance;
+			kept[1] = i;
+		}
+	}
+	if (largest > 0.0f)
+		keptCount = 2;
+
+	// The point making the largest triangle with them, on either side
+	const Vector3f& normal = contacts[kept[0]].contactNormal;
+	float area = 0.0f;
+	if (keptCount == 2)
+	{
+		const Vector3f& second = contacts[kept[1]].contactPoint;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			float signedArea = GetSignedArea(first, second, contacts[i].contactPoint, normal);
+			if (std::abs(signedArea) > std::abs(area))
+			{
+				area = signedArea;
+				kept[2] = i;
+			}
+		}
+		if (area != 0.0f)
+			keptCount = 3;
+	}
+
+	// The point adding the most area to the triangle, outside one of its edges
+	if (keptCount == 3)
+	{
+		const float side = area > 0.0f ? 1.0f : -1.0f;
+		float addedArea = 0.0f;
+		for (unsigned int i = 0; i < count; i++)
+		{
+			for (unsigned int edge = 0; edge < 3; edge++)
+			{
+				const Vector3f& start = contacts[kept[edge]].contactPoint;
+				const Vector3f& end = contacts[kept[(edge + 1) % 3]].contactPoint;
+
+				float outside = -side * GetSignedArea(start, end, contacts[i].contactPoint, normal);
+				if (outside > addedArea)
+				{
+					addedArea = outside;
+					kept[3] = i;
+				}
+			}
+		}
+		if (addedArea > 0.0f)
+			keptCount = 4;
+	}
+
+	Contact reduced[MaxPoints];
+	for (unsigned int i = 0; i < keptCount; i++)
+		reduced[i] = contacts[kept[i]];
+	for (unsigned int i = 0; i < keptCount; i++)
+		contacts[i] = reduced[i];
+
+	return keptCount;
+}
\ No newline at end of file
@@ -1,24 +1,114 @@
 #include "Collision/ContactResolver.hpp"
 #include "Collision/Contact.hpp"
 #include "Rigidbody.hpp"
+#include "RigidbodyStorage.hpp"
+#include <algorithm>
+#include <cmath>
 
-ContactResolver::ContactResolver(int iterations)
+ContactResolver::ContactResolver(int iterations, RigidbodyStorage& rigidbodies) :
+	m_rigidbodies(rigidbodies)
 {
 	this->iterations = iterations;
 	this->iterationsUsed = 0;
+	this->m_friction = 0.5f;
 }
 
-void ContactResolver::ResolveContacts(std::vector<std::shared_ptr<Contact>>& contacts, float duration, const State& state)
+void ContactResolver::ResolveContacts(Contact* contacts, unsigned int contactCount, float duration, const State& state)
 {
-	if (contacts.size() == 0) return;
+	if (contactCount == 0) return;
 
-	ResolveVelocity(contacts, duration, state);
-	ResolveInterpenetration(contacts, duration, state);
+	WakeUp(contacts, contactCount);
+	WarmStart(contacts, contactCount);
 
-    contacts.clear();
+	for (unsigned int i = 0; i < contactCount; i++)
+		contacts[i].PreCalculation(m_rigidbodies, duration);
+
+	ResolveVelocity(contacts, contactCount, duration, state);
+	ResolveInterpenetration(contacts, contactCount, duration, state);
+}
+
+void ContactResolver::SetFriction(float friction)
+{
+	m_friction = friction;
+}
+
+float ContactResolver::GetFriction() const
+{
+	return m_friction;
+}
+
+Rigidbody* ContactResolver::GetMovingBody(const BodyHandle& body) const
+{
+	if (!m_rigidbodies.IsValid(body))
+		return nullptr;
+
+	Rigidbody* rigidbody = m_rigidbodies.GetRigidbody(body);
+	return rigidbody->IsStatic() ? nullptr : rigidbody;
+}
+
+void ContactResolver::WakeUp(Contact* contacts, unsigned int contactCount)
+{
+	for (unsigned int i = 0; i < contactCount; i++)
+	{
+		Rigidbody* rigidbodies[2] = { GetMovingBody(contacts[i].bodies[0]), GetMovingBody(contacts[i].bodies[1]) };
+		if (rigidbodies[0] == nullptr || rigidbodies[1] == nullptr || rigidbodies[0]->IsAwake() == rigidbodies[1]->IsAwake())
+			continue;
+
+		rigidbodies[rigidbodies[0]->IsAwake() ? 1 : 0]->SetAwake(true);
+	}
 }
 
-void ContactResolver::ResolveVelocity(std::vector<std::shared_ptr<Contact>>& contacts, float duration, const State& state)
+void ContactResolver::WarmStart(Contact* contacts, unsigned int contactCount)
+{
+	for (unsigned int i = 0; i < contactCount; i++)
+	{
+		Contact& contact = contacts[i];
+		if (contact.accumulatedImpulse.GetLengthSquared() == 0.0f)
+			continue;
+
+		contact.CalculateContactBasis();
+		const Vector3f impulse = contact.contactToWorld.TransformTranspose(contact.accumulatedImpulse);
+
+		// Same impulse as the iterations apply, the second body receives it in the opposite direction
+		for (int j = 0; j < 2; j++)
+		{
+			Rigidbody* rigidbody = GetMovingBody(contact.bodies[j]);
+			if (rigidbody == nullptr)
+				continue;
+
+			const float sign = j == 0 ? 1.0f : -1.0f;
+			const Vector3f impulsiveTorque = Vector3f::CrossProduct(contact.contactPoint - rigidbody->GetPosition(), impulse) * sign;
+
+			rigidbody->GetVelocity() += impulse * (sign * rigidbody->GetInverseMass());
+			rigidbody->GetAngularVelocity() += rigidbody->GetInverseInertiaTensorWorld().TransformTranspose(impulsiveTorque);
+		}
+	}
+}
+
+float ContactResolver::CalculateVelocityError(const Contact& contact) const
+{
+	const Vector3f& accumulated = contact.accumulatedImpulse;
+
+	// A contact still pushing from an earlier step may need to push less, its error is then negative
+	float error = contact.deltaVelocity;
+	if (error < 0.0f && accumulated.x > 0.0f)
+		error = -error;
+
+	if (m_friction == 0.0f || (accumulated.x <= 0.0f && contact.deltaVelocity <= 0.0f))
+		return error;
+
+	// The sliding velocity, unless the friction already pushes against it as hard as the normal impulse allows
+	const float maxTangent = m_friction * accumulated.x;
+	const bool isSaturated = accumulated.y * accumulated.y + accumulated.z * accumulated.z >= 0.99f * maxTangent * maxTangent
+		&& accumulated.y * contact.contactVelocity.y + accumulated.z * contact.contactVelocity.z <= 0.0f;
+	if (isSaturated)
+		return error;
+
+	const float sliding = std::sqrt(contact.contactVelocity.y * contact.contactVelocity.y + contact.contactVelocity.z * contact.contactVelocity.z);
+	return std::max(error, sliding);
+}
+
+void ContactResolver::ResolveVelocity(Contact* contacts, unsigned int contactCount, float duration, [[maybe_unused]] const State& state)
 {
 	iterationsUsed = 0;
 
@@ -29,72 +119,69 @@ void ContactResolver::ResolveVelocity(std::vector<std::shared_ptr<Contact>>& con
 	{
 		float max = 0.01f;
 
-		int index = contacts.size();
+		unsigned int index = contactCount;
 
-		for (int i = 0; i < contacts.size(); i++)
+		for (unsigned int i = 0; i < contactCount; i++)
 		{
-            if (contacts[i]->deltaVelocity > max)
+            const float error = CalculateVelocityError(contacts[i]);
+            if (error > max)
             {
-                max = contacts[i]->deltaVelocity;
+                max = error;
                 index = i;
             }
 		}
 
-        if (index == contacts.size()) break;
-
-        Matrix3f inverseInertiaTensor[2];
-        inverseInertiaTensor[0] = contacts[index]->rigidbodies[0]->GetInverseInertiaTensorWorld();
-
-        if (contacts[index]->rigidbodies[1])
-            inverseInertiaTensor[1] = contacts[index]->rigidbodies[1]->GetInverseInertiaTensorWorld();
+        if (index == contactCount) break;
 
-        Vector3f impulseContact;
-        float friction = 0.0f;
+        Rigidbody* rigidbodies[2] = { GetMovingBody(contacts[index].bodies[0]), GetMovingBody(contacts[index].bodies[1]) };
 
-        if (friction == 0.0f)
-        {
-            impulseContact = CalculateImpulse(contacts[index], inverseInertiaTensor, false);
-        }
-        else
+        Matrix3f inverseInertiaTensor[2];
+        for (int j = 0; j < 2; j++)
         {
-            impulseContact = CalculateImpulse(contacts[index], inverseInertiaTensor, true);
+            velocityChange[j] = Vector3f(0.f, 0.f, 0.f);
+            rotationChange[j] = Vector3f(0.f, 0.f, 0.f);
+
+            if (rigidbodies[j])
+                inverseInertiaTensor[j] = rigidbodies[j]->GetInverseInertiaTensorWorld();
         }
 
-        Vector3f impulse = contacts[index]->contactToWorld.TransformTranspose(impulseContact);
+        Vector3f impulseContact = CalculateImpulse(contacts[index], inverseInertiaTensor, m_friction > 0.0f);
+        Vector3f impulse = contacts[index].contactToWorld.TransformTranspose(impulseContact);
 
-        Vector3f impulsiveTorque = Vector3f::CrossProduct(contacts[index]->relativeContactPosition[0], impulse);
-        rotationChange[0] = inverseInertiaTensor[0].TransformTranspose(impulsiveTorque);
-        velocityChange[0] = Vector3f(0.f, 0.f, 0.f);
-        velocityChange[0] += impulse * contacts[index]->rigidbodies[0]->inverseMass;
+        if (rigidbodies[0])
+        {
+            Vector3f impulsiveTorque = Vector3f::CrossProduct(contacts[index].relativeContactPosition[0], impulse);
+            rotationChange[0] = inverseInertiaTensor[0].TransformTranspose(impulsiveTorque);
+            velocityChange[0] += impulse * rigidbodies[0]->GetInverseMass();
 
-        contacts[index]->rigidbodies[0]->velocity += velocityChange[0];
-        contacts[index]->rigidbodies[0]->rotation.AddScaleVector(rotationChange[0], 1.f);
+            rigidbodies[0]->GetVelocity() += velocityChange[0];
+            rigidbodies[0]->GetAngularVelocity() += rotationChange[0];
+        }
 
-        if (contacts[index]->rigidbodies[1])
+        if (rigidbodies[1])
         {
-            Vector3 impulsiveTorque = Vector3f::CrossProduct(impulse, contacts[index]->relativeContactPosition[1]);
+            Vector3 impulsiveTorque = Vector3f::CrossProduct(impulse, contacts[index].relativeContactPosition[1]);
             rotationChange[1] = inverseInertiaTensor[1].TransformTranspose(impulsiveTorque);
-            velocityChange[1] = Vector3f(0.f, 0.f, 0.f);
-            velocityChange[1] += impulse * -contacts[index]->rigidbodies[1]->inverseMass;
+            velocityChange[1] += impulse * -rigidbodies[1]->GetInverseMass();
 
-            contacts[index]->rigidbodies[1]->velocity += velocityChange[1];
-            contacts[index]->rigidbodies[1]->rotation.AddScaleVector(rotationChange[1], 1.f);
+            rigidbodies[1]->GetVelocity() += velocityChange[1];
+            rigidbodies[1]->GetAngularVelocity() += rotationChange[1];
         }
 
-        for (int i = 0; i < contacts.size(); i++)
+        for (unsigned int i = 0; i < contactCount; i++)
         {
             for (int j = 0; j < 2; j++)
             {
-                if (contacts[i]->rigidbodies[j])
+                if (contacts[i].bodies[j].IsValid())
                 {
                     for (int x = 0; x < 2; x++)
                     {
-                        if (contacts[i]->rigidbodies[j] == contacts[index]->rigidbodies[x])
+                        if (contacts[i].bodies[j] == contacts[index].bodies[x])
                         {
-                            deltaVelocity = velocityChange[x] + rotationChange[x].Cross(contacts[i]->relativeContactPosition[j]);
+                            deltaVelocity = velocityChange[x] + rotationChange[x].Cross(contacts[i].relativeContactPosition[j]);
 
-                            contacts[i]->contactVelocity += contacts[i]->contactToWorld.TransformTranspose(deltaVelocity) * (j ? -1 : 1);
-                            contacts[i]->CalculateDeltaVelocity(duration);
+                            contacts[i].contactVelocity += contacts[i].contactToWorld * deltaVelocity * (j ? -1 : 1);
+                            contacts[i].CalculateDeltaVelocity(m_rigidbodies, duration);
                         }
                     }
                 }
@@ -105,9 +192,9 @@ void ContactResolver::ResolveVelocity(std::vector<std::shared_ptr<Contact>>& con
 	}
 }
 
-void ContactResolver::ResolveInterpenetration(std::vector<std::shared_ptr<Contact>>& contacts, float duration, const State& state)
+void ContactResolver::ResolveInterpenetration(Contact* contacts, unsigned int contactCount, [[maybe_unused]] float duration, [[maybe_unused]] const State& state)
 {
-    int i, index;
+    unsigned int i, index;
     Vector3f linearChange[2], angularChange[2];
     float max;
     Vector3f deltaPosition;
@@ -117,18 +204,20 @@ void ContactResolver::ResolveInterpenetration(std::vector<std::shared_ptr<Contac
     while (iterationsUsed < iterations)
     {
         max = 0.01f;
-        index = contacts.size();
+        index = contactCount;
 
-        for (i = 0; i < contacts.size(); i++)
+        for (i = 0; i < contactCount; i++)
         {
-            if (contacts[i]->penetration > max)
+            if (contacts[i].penetration > max)
             {
-                max = contacts[i]->penetration;
+                max = contacts[i].penetration;
                 index = i;
             }
         }
 
-        if (index == contacts.size()) break;
+        if (index == contactCount) break;
+
+        Rigidbody* rigidbodies[2] = { GetMovingBody(contacts[index].bodies[0]), GetMovingBody(contacts[index].bodies[1]) };
 
         float angularLimit = 0.2f;
         float angularMove[2];
@@ -140,16 +229,19 @@ void ContactResolver::ResolveInterpenetration(std::vector<std::shared_ptr<Contac
 
         for (int j = 0; j < 2; j++) 
         {
-            if (contacts[index]->rigidbodies[j])
+            linearChange[j] = Vector3f(0, 0, 0);
+            angularChange[j] = Vector3f(0, 0, 0);
+
+            if (rigidbodies[j])
             {
-                Matrix3f inverseInertiaTensor = contacts[index]->rigidbodies[j]->inverseInertiaTensorWorld;
+                Matrix3f inverseInertiaTensor = rigidbodies[j]->GetInverseInertiaTensorWorld();
 
-                Vector3f angularInertiaWorld = Vector3f::CrossProduct(contacts[index]->relativeContactPosition[j], contacts[index]->contactNormal);
+                Vector3f angularInertiaWorld = Vector3f::CrossProduct(contacts[index].relativeContactPosition[j], contacts[index].contactNormal);
                 angularInertiaWorld = inverseInertiaTensor.TransformTranspose(angularInertiaWorld);
-                angularInertiaWorld = Vector3f::CrossProduct(angularInertiaWorld, contacts[index]->relativeContactPosition[j]);
-                angularInertia[j] = angularInertiaWorld * contacts[index]->contactNormal;
+                angularInertiaWorld = Vector3f::CrossProduct(angularInertiaWorld, contacts[index].relativeContactPosition[j]);
+                angularInertia[j] = angularInertiaWorld * contacts[index].contactNormal;
 
-                linearInertia[j] = contacts[index]->rigidbodies[j]->inverseMass;
+                linearInertia[j] = rigidbodies[j]->GetInverseMass();
 
                 totalInertia += linearInertia[j] + angularInertia[j];
             }
@@ -157,14 +249,14 @@ void ContactResolver::ResolveInterpenetration(std::vector<std::shared_ptr<Contac
 
         for (int j = 0; j < 2; j++)
         {
-            if (contacts[index]->rigidbodies[j])
+            if (rigidbodies[j])
             {
                 float sign = (j == 0) ? 1 : -1;
-                angularMove[j] = sign * contacts[index]->penetration * (angularInertia[j] / totalInertia);
-                linearMove[j] = sign * contacts[index]->penetration * (linearInertia[j] / totalInertia);
+                angularMove[j] = sign * contacts[index].penetration * (angularInertia[j] / totalInertia);
+                linearMove[j] = sign * contacts[index].penetration * (linearInertia[j] / totalInertia);
 
-                Vector3f projection = contacts[index]->relativeContactPosition[j];
-                projection += contacts[index]->contactNormal * -Vector3f::DotProduct(contacts[index]->relativeContactPosition[j], contacts[index]->contactNormal);
+                Vector3f projection = contacts[index].relativeContactPosition[j];
+                projection += contacts[index].contactNormal * -Vector3f::DotProduct(contacts[index].relativeContactPosition[j], contacts[index].contactNormal);
 
                 float maxLength = angularLimit * projection.GetLength();
 
@@ -187,37 +279,37 @@ void ContactResolver::ResolveInterpenetration(std::vector<std::shared_ptr<Contac
                 }
                 else
                 {
-                    Vector3 targetAngularDirection = Vector3f::CrossProduct(contacts[index]->relativeContactPosition[j], contacts[index]->contactNormal);
-                    Matrix3f inverseInertiaTensor = contacts[index]->rigidbodies[j]->inverseInertiaTensorWorld;
+                    Vector3 targetAngularDirection = Vector3f::CrossProduct(contacts[index].relativeContactPosition[j], contacts[index].contactNormal);
+                    Matrix3f inverseInertiaTensor = rigidbodies[j]->GetInverseInertiaTensorWorld();
 
                     angularChange[j] = inverseInertiaTensor.TransformTranspose(targetAngularDirection) * (angularMove[j] / angularInertia[j]);
                 }
 
-                linearChange[j] = contacts[index]->contactNormal * linearMove[j];
+                linearChange[j] = contacts[index].contactNormal * linearMove[j];
 
 
-                contacts[index]->rigidbodies[j]->position = contacts[index]->contactNormal * linearMove[j];
-                contacts[index]->rigidbodies[j]->rotation.AddScaleVector(angularChange[j], 1.0f);
+                rigidbodies[j]->GetPosition() += linearChange[j];
+                rigidbodies[j]->GetRotation().AddScaleVector(angularChange[j], 1.0f);
 
 
-                if (!contacts[index]->rigidbodies[j]->isAwake) 
-                    contacts[index]->rigidbodies[j]->CalculateDerivedData();
+                if (!rigidbodies[j]->IsAwake()) 
+                    rigidbodies[j]->CalculateDerivedData();
             }
         }
 
-        for (i = 0; i < contacts.size(); i++)
+        for (i = 0; i < contactCount; i++)
         {
             for (int j = 0; j < 2; j++)
             {
-                if (contacts[i]->rigidbodies[j])
+                if (contacts[i].bodies[j].IsValid())
                 {
                     for (int x = 0; x < 2; x++)
                     {
-                        if (contacts[i]->rigidbodies[j] == contacts[index]->rigidbodies[x])
+                        if (contacts[i].bodies[j] == contacts[index].bodies[x])
                         {
-                            deltaPosition = linearChange[x] + angularChange[x].Cross(contacts[i]->relativeContactPosition[j]);
+                            deltaPosition = linearChange[x] + angularChange[x].Cross(contacts[i].relativeContactPosition[j]);
 
-                            contacts[i]->penetration += Vector3f::DotProduct(deltaPosition, contacts[i]->contactNormal) * (j ? 1 : -1);
+                            contacts[i].penetration += Vector3f::DotProduct(deltaPosition, contacts[i].contactNormal) * (j ? 1 : -1);
                         }
                     }
                 }
@@ -228,29 +320,54 @@ void ContactResolver::ResolveInterpenetration(std::vector<std::shared_ptr<Contac
     }
 }
 
-Vector3f ContactResolver::CalculateImpulse(std::shared_ptr<Contact>& contact, Matrix3f* inverseTensor, bool hasFriction)
+Vector3f ContactResolver::CalculateImpulse(Contact& contact, Matrix3f* inverseTensor, bool hasFriction)
 {
-    Vector3f impulseContact;
-    Vector3f deltaVelocityWorld = Vector3f::CrossProduct(contact->relativeContactPosition[0], contact->contactNormal);
-    deltaVelocityWorld = inverseTensor[0].TransformTranspose(deltaVelocityWorld);
-    deltaVelocityWorld = Vector3f::CrossProduct(deltaVelocityWorld, contact->relativeContactPosition[0]);
+    // Velocity change along each contact axis for a unit impulse along that axis
+    const Vector3f directions[3] = { contact.contactToWorld.TransformTranspose(Vector3f(1.f, 0.f, 0.f)),
+                                     contact.contactToWorld.TransformTranspose(Vector3f(0.f, 1.f, 0.f)),
+                                     contact.contactToWorld.TransformTranspose(Vector3f(0.f, 0.f, 1.f)) };
+    float deltaVelocity[3] = { 0.0f, 0.0f, 0.0f };
 
-    float deltaVelocity = deltaVelocityWorld * contact->contactNormal;
-    deltaVelocity += contact->rigidbodies[0]->inverseMass;
-
-    if (contact->rigidbodies[1])
+    for (int j = 0; j < 2; j++)
     {
-        Vector3f deltaVelocityWorld = Vector3f::CrossProduct(contact->relativeContactPosition[1], contact->contactNormal);
-        deltaVelocityWorld = inverseTensor[1].TransformTranspose(deltaVelocityWorld);
-        deltaVelocityWorld = Vector3f::CrossProduct(deltaVelocityWorld, contact->relativeContactPosition[1]);
+        const Rigidbody* rigidbody = GetMovingBody(contact.bodies[j]);
+        if (rigidbody == nullptr)
+            continue;
 
-        deltaVelocity += deltaVelocityWorld * contact->contactNormal;
-        deltaVelocity += contact->rigidbodies[1]->inverseMass;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            Vector3f deltaVelocityWorld = Vector3f::CrossProduct(contact.relativeContactPosition[j], directions[axis]);
+            deltaVelocityWorld = inverseTensor[j].TransformTranspose(deltaVelocityWorld);
+            deltaVelocityWorld = Vector3f::CrossProduct(deltaVelocityWorld, contact.relativeContactPosition[j]);
+
+            deltaVelocity[axis] += deltaVelocityWorld * directions[axis] + rigidbody->GetInverseMass();
+        }
     }
 
-    impulseContact.x = contact->deltaVelocity / deltaVelocity;
-    impulseContact.x = 0;
-    impulseContact.x = 0;
+    if (deltaVelocity[0] <= 0.0f)
+        return Vector3f::Zero;
+
+    // The accumulated normal impulse can only push, the applied impulse is the change of the clamped total
+    const Vector3f accumulated = contact.accumulatedImpulse;
+    contact.accumulatedImpulse.x = std::max(accumulated.x + contact.deltaVelocity / deltaVelocity[0], 0.0f);
+
+    if (hasFriction)
+    {
+        // Cancel the sliding velocity, within the cone allowed by the normal impulse
+        float tangentY = accumulated.y - contact.contactVelocity.y / deltaVelocity[1];
+        float tangentZ = accumulated.z - contact.contactVelocity.z / deltaVelocity[2];
+
+        const float maxTangent = m_friction * contact.accumulatedImpulse.x;
+        const float tangent = std::sqrt(tangentY * tangentY + tangentZ * tangentZ);
+        if (tangent > maxTangent)
+        {
+            tangentY *= maxTangent / tangent;
+            tangentZ *= maxTangent / tangent;
+        }
+
+        contact.accumulatedImpulse.y = tangentY;
+        contact.accumulatedImpulse.z = tangentZ;
+    }
 
-    return impulseContact;
+    return contact.accumulatedImpulse - accumulated;
 }
@@ -0,0 +1,473 @@
+#include <algorithm>
+#include "Collision/DynamicTree.hpp"
+#include "Collision/Primitives/Primitive.hpp"
+#include "RigidbodyStorage.hpp"
+
+namespace
+{
+	float GetSurfaceArea(const Vector3f& min, const Vector3f& max)
+	{
+		Vector3f size = max - min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+}
+
+bool DynamicTreeNode::IsLeaf() const
+{
+	return children[0] == DynamicTree::NullNode;
+}
+
+bool DynamicTreeNode::Contains(const Vector3f& otherMin, const Vector3f& otherMax) const
+{
+	return min.x <= otherMin.x && min.y <= otherMin.y && min.z <= otherMin.z
+		&& otherMax.x <= max.x && otherMax.y <= max.y && otherMax.z <= max.z;
+}
+
+bool DynamicTreeNode::Overlaps(const DynamicTreeNode& other) const
+{
+	return min.x <= other.max.x && other.min.x <= max.x
+		&& min.y <= other.max.y && other.min.y <= max.y
+		&& min.z <= other.max.z && other.min.z <= max.z;
+}
+
+float DynamicTreeNode::GetSurfaceArea() const
+{
+	return ::GetSurfaceArea(min, max);
+}
+
+DynamicTree::DynamicTree(float margin /*= 0.1f*/) :
+	m_root(NullNode),
+	m_freeList(NullNode),
+	m_leafCount(0),
+	m_movedLeafCount(0),
+	m_margin(margin)
+{
+}
+
+int32_t DynamicTree::Insert(std::shared_ptr<Primitive> primitive, const BoundingSphere& volume)
+{
+	Leaf leaf;
+	leaf.primitive = primitive;
+	leaf.body = primitive->body;
+	leaf.center = volume.GetCenter();
+	leaf.radius = volume.GetRadius();
+
+	return CreateLeaf(leaf);
+}
+
+int32_t DynamicTree::Insert(const BodyHandle& body, const BoundingSphere& volume)
+{
+	Leaf leaf;
+	leaf.body = body;
+	leaf.center = volume.GetCenter();
+	leaf.radius = volume.GetRadius();
+
+	return CreateLeaf(leaf);
+}
+
+void DynamicTree::Remove(int32_t leaf)
+{
+	RemoveLeaf(leaf);
+	m_leaves[leaf] = Leaf();
+	FreeNode(leaf);
+	m_leafCount--;
+}
+
+void DynamicTree::Clear()
+{
+	m_nodes.clear();
+	m_leaves.clear();
+	m_root = NullNode;
+	m_freeList = NullNode;
+	m_leafCount = 0;
+	m_movedLeafCount = 0;
+}
+
+void DynamicTree::Reserve(std::size_t leafCount)
+{
+	// A binary tree with n leaves has 2n - 1 nodes
+	m_nodes.reserve(leafCount * 2);
+	m_leaves.reserve(leafCount * 2);
+}
+
+void DynamicTree::Update(const RigidbodyStorage& rigidbodies)
+{
+	m_movedLeafCount = 0;
+
+	for (int32_t node = 0; node < static_cast<int32_t>(m_nodes.size()); ++node)
+	{
+		if (m_nodes[node].height != 0)
+			continue;
+
+		Leaf& leaf = m_leaves[node];
+		unsigned int index = rigidbodies.GetIndex(leaf.body);
+		if (index == BodyHandle::InvalidIndex)
+			continue;
+
+		leaf.center = rigidbodies.positions[index];
+
+		// Still inside its fat bounds, the tree does not change
+		Vector3f radius(leaf.radius, leaf.radius, leaf.radius);
+		if (m_nodes[node].Contains(leaf.center - radius, leaf.center + radius))
+			continue;
+
+		RemoveLeaf(node);
+		SetFatBounds(node);
+		InsertLeaf(node);
+		m_movedLeafCount++;
+	}
+}
+
+unsigned int DynamicTree::GetPotentialContact(PotentialContact* contacts, unsigned int limit) const
+{
+	unsigned int count = 0;
+	m_truncated = false;
+
+	auto report = [&](int32_t leafA, int32_t leafB)
+	{
+		// One pair past the limit is enough to know some were left out
+		if (count >= limit)
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		contacts[count].bodies[0] = m_leaves[leafA].body;
+		contacts[count].bodies[1] = m_leaves[leafB].body;
+		++count;
+		return true;
+	};
+
+	QueryPairs(report);
+	return count;
+}
+
+unsigned int DynamicTree::GetPotentialContactPrimitive(PotentialContactPrimitive* contacts, unsigned int limit) const
+{
+	unsigned int count = 0;
+	m_truncated = false;
+
+	auto report = [&](int32_t leafA, int32_t leafB)
+	{
+		// One pair past the limit is enough to know some were left out
+		if (count >= limit)
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		// Leaves inserted without a primitive only take part in body pairs
+		if (m_leaves[leafA].primitive == nullptr || m_leaves[leafB].primitive == nullptr)
+			return true;
+
+		contacts[count].primitives[0] = m_leaves[leafA].primitive.get();
+		contacts[count].primitives[1] = m_leaves[leafB].primitive.get();
+		++count;
+		return true;
+	};
+
+	QueryPairs(report);
+	return count;
+}
+
+void DynamicTree::SetMargin(float margin)
+{
+	m_margin = margin;
+}
+
+float DynamicTree::GetMargin() const
+{
+	return m_margin;
+}
+
+int32_t DynamicTree::GetRoot() const
+{
+	return m_root;
+}
+
+const DynamicTreeNode& DynamicTree::GetNode(int32_t node) const
+{
+	return m_nodes[node];
+}
+
+int32_t DynamicTree::GetHeight() const
+{
+	return m_root == NullNode ? 0 : m_nodes[m_root].height;
+}
+
+std::size_t DynamicTree::GetLeafCount() const
+{
+	return m_leafCount;
+}
+
+std::size_t DynamicTree::GetMovedLeafCount() const
+{
+	return m_movedLeafCount;
+}
+
+Primitive* DynamicTree::GetPrimitive(int32_t leaf) const
+{
+	return m_leaves[leaf].primitive.get();
+}
+
+BodyHandle DynamicTree::GetBody(int32_t leaf) const
+{
+	return m_leaves[leaf].body;
+}
+
+int32_t DynamicTree::AllocateNode()
+{
+	int32_t node;
+
+	if (m_freeList != NullNode)
+	{
+		node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+	}
+	else
+	{
+		node = static_cast<int32_t>(m_nodes.size());
+		m_nodes.emplace_back();
+		m_leaves.emplace_back();
+	}
+
+	DynamicTreeNode& newNode = m_nodes[node];
+	newNode.min = Vector3f::Zero;
+	newNode.max = Vector3f::Zero;
+	newNode.parent = NullNode;
+	newNode.children[0] = NullNode;
+	newNode.children[1] = NullNode;
+	newNode.height = 0;
+
+	return node;
+}
+
+void DynamicTree::FreeNode(int32_t node)
+{
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+int32_t DynamicTree::CreateLeaf(const Leaf& leaf)
+{
+	int32_t node = AllocateNode();
+	m_leaves[node] = leaf;
+	m_leafCount++;
+
+	SetFatBounds(node);
+	InsertLeaf(node);
+
+	return node;
+}
+
+void DynamicTree::SetFatBounds(int32_t leaf)
+{
+	const Leaf& data = m_leaves[leaf];
+	Vector3f extent(data.radius + m_margin, data.radius + m_margin, data.radius + m_margin);
+
+	m_nodes[leaf].min = data.center - extent;
+	m_nodes[leaf].max = data.center + extent;
+}
+
+void DynamicTree::InsertLeaf(int32_t leaf)
+{
+	if (m_root == NullNode)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = NullNode;
+		return;
+	}
+
+	// Go down while pairing the leaf with a node deeper costs less than pairing it with the current one
+	const Vector3f leafMin = m_nodes[leaf].min;
+	const Vector3f leafMax = m_nodes[leaf].max;
+	int32_t sibling = m_root;
+
+	while (!m_nodes[sibling].IsLeaf())
+	{
+		const DynamicTreeNode& node = m_nodes[sibling];
+		float area = node.GetSurfaceArea();
+		float combinedArea = GetSurfaceArea(Vector3f::Min(node.min, leafMin), Vector3f::Max(node.max, leafMax));
+
+		// A new parent here has the combined area, and every ancestor below grows by the difference
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		for (int i = 0; i < 2; ++i)
+		{
+			const DynamicTreeNode& child = m_nodes[node.children[i]];
+			float childArea = GetSurfaceArea(Vector3f::Min(child.min, leafMin), Vector3f::Max(child.max, leafMax));
+
+			if (child.IsLeaf())
+				childCosts[i] = childArea + inheritanceCost;
+			else
+				childCosts[i] = childArea - child.GetSurfaceArea() + inheritanceCost;
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1])
+			break;
+
+		sibling = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+	}
+
+	// A new internal node takes the place of the sibling, with the sibling and the leaf as children
+	int32_t oldParent = m_nodes[sibling].parent;
+	int32_t newParent = AllocateNode();
+
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].children[0] = sibling;
+	m_nodes[newParent].children[1] = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	if (oldParent == NullNode)
+		m_root = newParent;
+	else
+		m_nodes[oldParent].children[m_nodes[oldParent].children[0] == sibling ? 0 : 1] = newParent;
+
+	UpdateAncestors(newParent);
+}
+
+void DynamicTree::RemoveLeaf(int32_t leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = NullNode;
+		return;
+	}
+
+	// The sibling takes the place of the parent
+	int32_t parent = m_nodes[leaf].parent;
+	int32_t sibling = m_nodes[parent].children[0] == leaf ? m_nodes[parent].children[1] : m_nodes[parent].children[0];
+	int32_t grandParent = m_nodes[parent].parent;
+
+	m_nodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == NullNode)
+	{
+		m_root = sibling;
+		return;
+	}
+
+	DynamicTreeNode& grandParentNode = m_nodes[grandParent];
+	grandParentNode.children[grandParentNode.children[0] == parent ? 0 : 1] = sibling;
+
+	UpdateAncestors(grandParent);
+}
+
+void DynamicTree::UpdateAncestors(int32_t node)
+{
+	while (node != NullNode)
+	{
+		node = Balance(node);
+		UpdateNode(node);
+		node = m_nodes[node].parent;
+	}
+}
+
+int32_t DynamicTree::Balance(int32_t nodeA)
+{
+	DynamicTreeNode& a = m_nodes[nodeA];
+	if (a.IsLeaf() || a.height < 2)
+		return nodeA;
+
+	int32_t nodeB = a.children[0];
+	int32_t nodeC = a.children[1];
+	int32_t balance = m_nodes[nodeC].height - m_nodes[nodeB].height;
+
+	if (balance >= -1 && balance <= 1)
+		return nodeA;
+
+	// The higher child becomes the parent of a, a keeps the lower child and the lower grandchild of the higher one
+	int high = balance > 1 ? 1 : 0;
+	int32_t nodeUp = a.children[high];
+	DynamicTreeNode& up = m_nodes[nodeUp];
+
+	int32_t nodeF = up.children[0];
+	int32_t nodeG = up.children[1];
+
+	up.children[0] = nodeA;
+	up.parent = a.parent;
+	a.parent = nodeUp;
+
+	if (up.parent == NullNode)
+		m_root = nodeUp;
+	else
+		m_nodes[up.parent].children[m_nodes[up.parent].children[0] == nodeA ? 0 : 1] = nodeUp;
+
+	// The higher grandchild stays under the rotated node
+	if (m_nodes[nodeF].height > m_nodes[nodeG].height)
+		std::swap(nodeF, nodeG);
+
+	up.children[1] = nodeG;
+	a.children[high] = nodeF;
+	m_nodes[nodeF].parent = nodeA;
+
+	UpdateNode(nodeA);
+	UpdateNode(nodeUp);
+
+	return nodeUp;
+}
+
+void DynamicTree::UpdateNode(int32_t node)
+{
+	DynamicTreeNode& current = m_nodes[node];
+	const DynamicTreeNode& childA = m_nodes[current.children[0]];
+	const DynamicTreeNode& childB = m_nodes[current.children[1]];
+
+	current.min = Vector3f::Min(childA.min, childB.min);
+	current.max = Vector3f::Max(childA.max, childB.max);
+	current.height = 1 + std::max(childA.height, childB.height);
+}
+
+bool DynamicTree::Overlaps(int32_t leafA, int32_t leafB) const
+{
+	// Same test as the BVH so every broad phase reports the same pairs
+	const Leaf& a = m_leaves[leafA];
+	const Leaf& b = m_leaves[leafB];
+
+	float distanceSquared = (a.center - b.center).GetLengthSquared();
+	return distanceSquared < (a.radius + b.radius) * (a.radius + b.radius);
+}
+
+template<typename Report>
+void DynamicTree::QueryPairs(Report& report) const
+{
+	if (m_root == NullNode)
+		return;
+
+	// Every leaf queries the tree with its fat bounds and reports the leaves after it, so each pair is found once
+	for (int32_t leaf = 0; leaf < static_cast<int32_t>(m_nodes.size()); ++leaf)
+	{
+		if (m_nodes[leaf].height != 0)
+			continue;
+
+		const DynamicTreeNode& bounds = m_nodes[leaf];
+
+		m_queryStack.clear();
+		m_queryStack.push_back(m_root);
+
+		while (!m_queryStack.empty())
+		{
+			int32_t node = m_queryStack.back();
+			m_queryStack.pop_back();
+
+			const DynamicTreeNode& current = m_nodes[node];
+			if (!current.Overlaps(bounds))
+				continue;
+
+			if (!current.IsLeaf())
+			{
+				m_queryStack.push_back(current.children[0]);
+				m_queryStack.push_back(current.children[1]);
+			}
+			else if (node > leaf && Overlaps(leaf, node) && !report(leaf, node))
+			{
+				return;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,542 @@
+#include "Collision/GJK.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace
+{
+	constexpr unsigned int MaxGJKIterations = 32;
+	// Below this squared distance the cores touch and are considered overlapping
+	constexpr float TouchingDistanceSquared = 1e-10f;
+	// GJK stops once a new support point gets closer to the origin by less than this fraction of the distance
+	constexpr float GJKRelativeTolerance = 1e-6f;
+
+	constexpr unsigned int MaxEPAIterations = 64;
+	constexpr unsigned int MaxEPAVertices = MaxEPAIterations + 4;
+	// A closed polytope of V vertices has 2V - 4 faces
+	constexpr unsigned int MaxEPAFaces = 2 * MaxEPAVertices;
+	// EPA stops once the support point is this close to the nearest face
+	constexpr float EPATolerance = 1e-4f;
+	// Smallest area or volume the grown simplex has to span
+	constexpr float DegenerateEpsilon = 1e-10f;
+	// Below this volume, relative to the product of its edges from the first vertex, a tetrahedron is flat
+	constexpr float FlatTetrahedronTolerance = 1e-5f;
+
+	// Vertex of the Minkowski difference A - B
+	struct SupportPoint
+	{
+		Vector3f pointA;
+		Vector3f pointB;
+		Vector3f point;
+		uint16_t indexA;
+		uint16_t indexB;
+	};
+
+	struct Simplex
+	{
+		SupportPoint vertices[4];
+		/* Barycentric weights of the point of the simplex closest to the origin */
+		float weights[4];
+		unsigned int count;
+	};
+
+	uint16_t GetSupportIndex(const ConvexShape& shape, const Vector3f& direction)
+	{
+		// The direction is rotated in the space of the body once instead of moving every vertex to world space
+		const Vector3f localDirection = shape.transform->TransformInverse(direction);
+
+		uint16_t support = 0;
+		float supportDot = shape.vertices[0] * localDirection;
+		for (unsigned int i = 1; i < shape.vertexCount; i++)
+		{
+			float dot = shape.vertices[i] * localDirection;
+			if (dot > supportDot)
+			{
+				support = static_cast<uint16_t>(i);
+				supportDot = dot;
+			}
+		}
+
+		return support;
+	}
+
+	SupportPoint GetSupportPoint(const ConvexShape& shapeA, const ConvexShape& shapeB, uint16_t indexA, uint16_t indexB)
+	{
+		SupportPoint support;
+		support.pointA = *shapeA.transform * shapeA.vertices[indexA];
+		support.pointB = *shapeB.transform * shapeB.vertices[indexB];
+		support.point = support.pointA - support.pointB;
+		support.indexA = indexA;
+		support.indexB = indexB;
+
+		return support;
+	}
+
+	SupportPoint GetSupportPoint(const ConvexShape& shapeA, const ConvexShape& shapeB, const Vector3f& direction)
+	{
+		return GetSupportPoint(shapeA, shapeB, GetSupportIndex(shapeA, direction), GetSupportIndex(shapeB, direction * -1.0f));
+	}
+
+	// The solvers take their vertices by value, they may come from the simplex they write to
+	void SetVertex(Simplex& simplex, const SupportPoint& a)
+	{
+		simplex.vertices[0] = a;
+		simplex.weights[0] = 1.0f;
+		simplex.count = 1;
+	}
+
+	void SetEdge(Simplex& simplex, const SupportPoint& a, const SupportPoint& b, float t)
+	{
+		simplex.vertices[0] = a;
+		simplex.vertices[1] = b;
+		simplex.weights[0] = 1.0f - t;
+		simplex.weights[1] = t;
+		simplex.count = 2;
+	}
+
+	// Closest point of the segment ab to the origin, simplex receives the smallest part of the segment holding it
+	void SolveSegment(const SupportPoint a, const SupportPoint b, Simplex& simplex)
+	{
+		const Vector3f ab = b.point - a.point;
+		float t = -(a.point * ab);
+		float lengthSquared = ab * ab;
+
+		if (t <= 0.0f || lengthSquared <= 0.0f)
+			SetVertex(simplex, a);
+		else if (t >= lengthSquared)
+			SetVertex(simplex, b);
+		else
+			SetEdge(simplex, a, b, t / lengthSquared);
+	}
+
+	// Closest point of the triangle abc to the origin, by the Voronoi region of the triangle holding the origin
+	void SolveTriangle(const SupportPoint a, const SupportPoint b, const SupportPoint c, Simplex& simplex)
+	{
+		const Vector3f ab = b.point - a.point;
+		const Vector3f ac = c.point - a.point;
+
+		float d1 = -(ab * a.point);
+		float d2 = -(ac * a.point);
+		if (d1 <= 0.0f && d2 <= 0.0f)
+			return SetVertex(simplex, a);
+
+		float d3 = -(ab * b.point);
+		float d4 = -(ac * b.point);
+		if (d3 >= 0.0f && d4 <= d3)
+			return SetVertex(simplex, b);
+
+		float vc = d1 * d4 - d3 * d2;
+		if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+			return SetEdge(simplex, a, b, d1 / (d1 - d3));
+
+		float d5 = -(ab * c.point);
+		float d6 = -(ac * c.point);
+		if (d6 >= 0.0f && d5 <= d6)
+			return SetVertex(simplex, c);
+
+		float vb = d5 * d2 - d1 * d6;
+		if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+			return SetEdge(simplex, a, c, d2 / (d2 - d6));
+
+		float va = d3 * d6 - d5 * d4;
+		if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f)
+			return SetEdge(simplex, b, c, (d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+		// Flat triangles have no inside
+		float sum = va + vb + vc;
+		if (sum <= 0.0f)
+			return SolveSegment(a, b, simplex);
+
+		simplex.vertices[0] = a;
+		simplex.vertices[1] = b;
+		simplex.vertices[2] = c;
+		simplex.weights[1] = vb / sum;
+		simplex.weights[2] = vc / sum;
+		simplex.weights[0] = 1.0f - simplex.weights[1] - simplex.weights[2];
+		simplex.count = 3;
+	}
+
+	Vector3f GetClosestPoint(const Simplex& simplex)
+	{
+		Vector3f point = Vector3f::Zero;
+		for (unsigned int i = 0; i < simplex.count; i++)
+			point += simplex.vertices[i].point * simplex.weights[i];
+
+		return point;
+	}
+
+	// Keeps the whole tetrahedron and returns true when it holds the origin, otherwise reduces it to the closest face part
+	bool SolveTetrahedron(Simplex& simplex)
+	{
+		// Each face with the vertex opposite to it
+		static constexpr int Faces[4][4] = { { 0, 1, 2, 3 }, { 0, 3, 1, 2 }, { 0, 2, 3, 1 }, { 1, 3, 2, 0 } };
+
+		const Simplex tetrahedron = simplex;
+		Simplex face;
+		float closestDistance = FLT_MAX;
+		bool isInside = true;
+
+		// The side tests of a flat tetrahedron are only rounding noise, its faces are all searched
+		const Vector3f edges[3] =
+		{
+			tetrahedron.vertices[1].point - tetrahedron.vertices[0].point,
+			tetrahedron.vertices[2].point - tetrahedron.vertices[0].point,
+			tetrahedron.vertices[3].point - tetrahedron.vertices[0].point
+		};
+		const float volume = Vector3f::CrossProduct(edges[0], edges[1]) * edges[2];
+		const bool isFlat = std::abs(volume) <= FlatTetrahedronTolerance * edges[0].GetLength() * edges[1].GetLength() * edges[2].GetLength();
+
+		for (const int* indices : Faces)
+		{
+			const Vector3f& a = tetrahedron.vertices[indices[0]].point;
+			const Vector3f normal = Vector3f::CrossProduct(tetrahedron.vertices[indices[1]].point - a, tetrahedron.vertices[indices[2]].point - a);
+
+			// The origin is inside the face when it lies on the same side as the opposite vertex
+			if (!isFlat && (normal * a) * (normal * (tetrahedron.vertices[indices[3]].point - a)) < 0.0f)
+				continue;
+
+			isInside = false;
+			SolveTriangle(tetrahedron.vertices[indices[0]], tetrahedron.vertices[indices[1]], tetrahedron.vertices[indices[2]], face);
+
+			float distance = GetClosestPoint(face).GetLengthSquared();
+			if (distance < closestDistance)
+			{
+				simplex = face;
+				closestDistance = distance;
+			}
+		}
+
+		return isInside;
+	}
+
+	// A touching pair leaves GJK with fewer than four vertices, they are completed by support points away from them
+	bool BuildTetrahedron(const ConvexShape& shapeA, const ConvexShape& shapeB, SupportPoint* vertices, unsigned int& count)
+	{
+		const Vector3f axes[6] = { Vector3f::Right, Vector3f::Left, Vector3f::Up, Vector3f::Down, Vector3f::Forward, Vector3f::Forward * -1.0f };
+
+		if (count == 1)
+		{
+			for (const Vector3f& axis : axes)
+			{
+				vertices[1] = GetSupportPoint(shapeA, shapeB, axis);
+				if ((vertices[1].point - vertices[0].point).GetLengthSquared() > DegenerateEpsilon)
+				{
+					count = 2;
+					break;
+				}
+			}
+		}
+
+		if (count == 2)
+		{
+			const Vector3f edge = vertices[1].point - vertices[0].point;
+
+			// Any direction normal to the edge, built from the axis the least aligned with it
+			const Vector3f absEdge(std::abs(edge.x), std::abs(edge.y), std::abs(edge.z));
+			const Vector3f& axis = absEdge.x <= absEdge.y && absEdge.x <= absEdge.z ? Vector3f::Right : absEdge.y <= absEdge.z ? Vector3f::Up : Vector3f::Forward;
+			const Vector3f normal = Vector3f::CrossProduct(edge, axis);
+			const Vector3f binormal = Vector3f::CrossProduct(edge, normal);
+			const Vector3f directions[4] = { normal, normal * -1.0f, binormal, binormal * -1.0f };
+
+			for (const Vector3f& direction : directions)
+			{
+				vertices[2] = GetSupportPoint(shapeA, shapeB, direction);
+				if (Vector3f::CrossProduct(edge, vertices[2].point - vertices[0].point).GetLengthSquared() > DegenerateEpsilon)
+				{
+					count = 3;
+					break;
+				}
+			}
+		}
+
+		if (count == 3)
+		{
+			const Vector3f normal = Vector3f::CrossProduct(vertices[1].point - vertices[0].point, vertices[2].point - vertices[0].point);
+			const Vector3f directions[2] = { normal, normal * -1.0f };
+
+			for (const Vector3f& direction : directions)
+			{
+				vertices[3] = GetSupportPoint(shapeA, shapeB, direction);
+				if (std::abs(normal * (vertices[3].point - vertices[0].point)) > DegenerateEpsilon)
+				{
+					count = 4;
+					break;
+				}
+			}
+		}
+
+		return count == 4;
+	}
+
+	struct PolytopeFace
+	{
+		int indices[3];
+		/* Outward unit normal */
+		Vector3f normal;
+		/* Distance from the origin to the plane of the face */
+		float distance;
+	};
+
+	struct PolytopeEdge
+	{
+		int indices[2];
+	};
+}
+
+GJKResult GJKDistance(const ConvexShape& shapeA, const ConvexShape& shapeB, SimplexCache* cache /*= nullptr*/)
+{
+	Simplex simplex;
+	simplex.count = 0;
+
+	// The vertices of the last simplex give its support points at the new poses
+	if (cache != nullptr && cache->count <= 4)
+	{
+		for (unsigned int i = 0; i < cache->count; i++)
+		{
+			if (cache->indicesA[i] >= shapeA.vertexCount || cache->indicesB[i] >= shapeB.vertexCount)
+			{
+				simplex.count = 0;
+				break;
+			}
+
+			simplex.vertices[simplex.count++] = GetSupportPoint(shapeA, shapeB, cache->indicesA[i], cache->indicesB[i]);
+		}
+	}
+
+	if (simplex.count == 0)
+	{
+		simplex.vertices[0] = GetSupportPoint(shapeA, shapeB, 0, 0);
+		simplex.count = 1;
+	}
+
+	GJKResult result;
+	result.iterations = 0;
+	bool isOverlapping = false;
+
+	while (true)
+	{
+		switch (simplex.count)
+		{
+		case 1:
+			simplex.weights[0] = 1.0f;
+			break;
+		case 2:
+			SolveSegment(simplex.vertices[0], simplex.vertices[1], simplex);
+			break;
+		case 3:
+			SolveTriangle(simplex.vertices[0], simplex.vertices[1], simplex.vertices[2], simplex);
+			break;
+		default:
+			isOverlapping = SolveTetrahedron(simplex);
+			break;
+		}
+
+		if (isOverlapping)
+			break;
+
+		const Vector3f closest = GetClosestPoint(simplex);
+		float distanceSquared = closest * closest;
+		if (distanceSquared <= TouchingDistanceSquared)
+		{
+			isOverlapping = true;
+			break;
+		}
+
+		if (result.iterations == MaxGJKIterations)
+			break;
+		result.iterations++;
+
+		const SupportPoint support = GetSupportPoint(shapeA, shapeB, closest * -1.0f);
+
+		// A support point already in the simplex, or one barely closer to the origin, means the distance is found
+		bool isKnown = false;
+		for (unsigned int i = 0; i < simplex.count; i++)
+			isKnown = isKnown || (simplex.vertices[i].indexA == support.indexA && simplex.vertices[i].indexB == support.indexB);
+
+		if (isKnown || distanceSquared - closest * support.point <= GJKRelativeTolerance * distanceSquared)
+			break;
+
+		simplex.vertices[simplex.count++] = support;
+	}
+
+	result.pointA = Vector3f::Zero;
+	result.pointB = Vector3f::Zero;
+	if (isOverlapping)
+	{
+		result.pointA = simplex.vertices[0].pointA;
+		result.pointB = simplex.vertices[0].pointB;
+		result.distance = 0.0f;
+	}
+	else
+	{
+		for (unsigned int i = 0; i < simplex.count; i++)
+		{
+			result.pointA += simplex.vertices[i].pointA * simplex.weights[i];
+			result.pointB += simplex.vertices[i].pointB * simplex.weights[i];
+		}
+		result.distance = (result.pointA - result.pointB).GetLength();
+	}
+
+	result.simplexCount = simplex.count;
+	for (unsigned int i = 0; i < simplex.count; i++)
+	{
+		result.simplexA[i] = simplex.vertices[i].pointA;
+		result.simplexB[i] = simplex.vertices[i].pointB;
+		result.simplexIndicesA[i] = simplex.vertices[i].indexA;
+		result.simplexIndicesB[i] = simplex.vertices[i].indexB;
+	}
+
+	if (cache != nullptr)
+	{
+		cache->count = simplex.count;
+		for (unsigned int i = 0; i < simplex.count; i++)
+		{
+			cache->indicesA[i] = simplex.vertices[i].indexA;
+			cache->indicesB[i] = simplex.vertices[i].indexB;
+		}
+	}
+
+	return result;
+}
+
+bool GJKOverlap(const ConvexShape& shapeA, const ConvexShape& shapeB, SimplexCache* cache /*= nullptr*/)
+{
+	GJKResult result = GJKDistance(shapeA, shapeB, cache);
+	return result.distance <= 0.0f || result.distance < shapeA.radius + shapeB.radius;
+}
+
+bool EPAPenetration(const ConvexShape& shapeA, const ConvexShape& shapeB, const GJKResult& gjk, Penetration& penetration)
+{
+	SupportPoint vertices[MaxEPAVertices];
+	unsigned int vertexCount = gjk.simplexCount;
+	for (unsigned int i = 0; i < vertexCount; i++)
+	{
+		vertices[i].pointA = gjk.simplexA[i];
+		vertices[i].pointB = gjk.simplexB[i];
+		vertices[i].point = gjk.simplexA[i] - gjk.simplexB[i];
+		vertices[i].indexA = gjk.simplexIndicesA[i];
+		vertices[i].indexB = gjk.simplexIndicesB[i];
+	}
+
+	if (vertexCount == 0 || !BuildTetrahedron(shapeA, shapeB, vertices, vertexCount))
+		return false;
+
+	// Faces are wound so their normal points away from the opposite vertex
+	const Vector3f normal = Vector3f::CrossProduct(vertices[1].point - vertices[0].point, vertices[2].point - vertices[0].point);
+	if (normal * (vertices[3].point - vertices[0].point) > 0.0f)
+		std::swap(vertices[1], vertices[2]);
+
+	PolytopeFace faces[MaxEPAFaces];
+	unsigned int faceCount = 0;
+	auto addFace = [&](int a, int b, int c)
+		{
+			PolytopeFace& face = faces[faceCount++];
+			face.indices[0] = a;
+			face.indices[1] = b;
+			face.indices[2] = c;
+
+			// A sliver face is kept to close the polytope but never taken as the nearest one
+			Vector3f faceNormal = Vector3f::CrossProduct(vertices[b].point - vertices[a].point, vertices[c].point - vertices[a].point);
+			float length = faceNormal.GetLength();
+			face.normal = length > 0.0f ? faceNormal / length : Vector3f::Zero;
+			face.distance = length > 0.0f ? face.normal * vertices[a].point : FLT_MAX;
+		};
+
+	addFace(0, 1, 2);
+	addFace(0, 3, 1);
+	addFace(0, 2, 3);
+	addFace(1, 3, 2);
+
+	PolytopeEdge edges[3 * MaxEPAFaces];
+	PolytopeFace nearest;
+
+	for (unsigned int iteration = 0; ; iteration++)
+	{
+		unsigned int nearestIndex = 0;
+		for (unsigned int i = 1; i < faceCount; i++)
+		{
+			if (faces[i].distance < faces[nearestIndex].distance)
+				nearestIndex = i;
+		}
+		nearest = faces[nearestIndex];
+
+		if (nearest.distance == FLT_MAX)
+			return false;
+		if (iteration == MaxEPAIterations || vertexCount == MaxEPAVertices)
+			break;
+
+		const SupportPoint support = GetSupportPoint(shapeA, shapeB, nearest.normal);
+		if (support.point * nearest.normal - nearest.distance <= EPATolerance)
+			break;
+
+		// The faces the new vertex sees are removed, the edges they leave open are the horizon closed by the new faces
+		unsigned int edgeCount = 0;
+		for (unsigned int i = 0; i < faceCount;)
+		{
+			const PolytopeFace& face = faces[i];
+			if (face.normal * (support.point - vertices[face.indices[0]].point) <= 0.0f)
+			{
+				i++;
+				continue;
+			}
+
+			for (int j = 0; j < 3; j++)
+			{
+				int start = face.indices[j];
+				int end = face.indices[(j + 1) % 3];
+
+				// An edge shared with another removed face is inside the hole
+				bool isShared = false;
+				for (unsigned int k = 0; k < edgeCount; k++)
+				{
+					if (edges[k].indices[0] == end && edges[k].indices[1] == start)
+					{
+						edges[k] = edges[--edgeCount];
+						isShared = true;
+						break;
+					}
+				}
+
+				if (!isShared)
+					edges[edgeCount++] = { { start, end } };
+			}
+
+			faces[i] = faces[--faceCount];
+		}
+
+		if (faceCount + edgeCount > MaxEPAFaces)
+			break;
+
+		vertices[vertexCount] = support;
+		for (unsigned int i = 0; i < edgeCount; i++)
+			addFace(edges[i].indices[0], edges[i].indices[1], static_cast<int>(vertexCount));
+		vertexCount++;
+	}
+
+	// Barycentric coordinates of the projection of the origin on the nearest face give the deepest points
+	const SupportPoint& a = vertices[nearest.indices[0]];
+	const SupportPoint& b = vertices[nearest.indices[1]];
+	const SupportPoint& c = vertices[nearest.indices[2]];
+	const Vector3f ab = b.point - a.point;
+	const Vector3f ac = c.point - a.point;
+	const Vector3f ap = nearest.normal * nearest.distance - a.point;
+
+	float d00 = ab * ab;
+	float d01 = ab * ac;
+	float d11 = ac * ac;
+	float d20 = ap * ab;
+	float d21 = ap * ac;
+	float denominator = d00 * d11 - d01 * d01;
+
+	float v = denominator > 0.0f ? (d11 * d20 - d01 * d21) / denominator : 0.0f;
+	float w = denominator > 0.0f ? (d00 * d21 - d01 * d20) / denominator : 0.0f;
+	float u = 1.0f - v - w;
+
+	penetration.normal = nearest.normal;
+	penetration.depth = std::max(nearest.distance, 0.0f);
+	penetration.pointA = a.pointA * u + b.pointA * v + c.pointA * w;
+	penetration.pointB = a.pointB * u + b.pointB * v + c.pointB * w;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include "Collision/PairCache.hpp"
+#include "Collision/Primitives/Primitive.hpp"
+
+PairCache::PairCache() :
+	m_slotMask(0),
+	m_step(0)
+{
+}
+
+void PairCache::Update(const PotentialContactPrimitive* pairs, unsigned int count)
+{
+	++m_step;
+	m_endedPairs.clear();
+
+	if ((m_pairs.size() + count) * 2 > m_slots.size())
+		RebuildSlots(m_pairs.size() + count);
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		Primitive* primitiveA = pairs[i].primitives[0];
+		Primitive* primitiveB = pairs[i].primitives[1];
+		if (primitiveA->id > primitiveB->id)
+			std::swap(primitiveA, primitiveB);
+
+		uint64_t key = GetKey(*primitiveA, *primitiveB);
+		uint32_t slot = GetSlot(key);
+
+		while (m_slots[slot] != EmptySlot && m_pairs[m_slots[slot]].key != key)
+			slot = (slot + 1) & m_slotMask;
+
+		if (m_slots[slot] != EmptySlot)
+		{
+			// Already seen this step when the broad phase reports it twice
+			CachedPair& pair = m_pairs[m_slots[slot]];
+			if (pair.lastStep != m_step)
+			{
+				pair.state = StatePersist;
+				pair.lastStep = m_step;
+			}
+			continue;
+		}
+
+		CachedPair pair;
+		pair.primitives = { primitiveA, primitiveB };
+		pair.key = key;
+		pair.state = StateBegin;
+		pair.lastStep = m_step;
+		pair.testedStep = 0;
+		pair.contactCount = 0;
+		pair.simplex = SimplexCache();
+		pair.manifold.Clear();
+		pair.firstContact = 0;
+
+		m_slots[slot] = static_cast<int32_t>(m_pairs.size());
+		m_pairs.push_back(pair);
+	}
+
+	// Pairs not reported this step end, the others keep their order
+	std::size_t pairCount = 0;
+	for (std::size_t i = 0; i < m_pairs.size(); ++i)
+	{
+		if (m_pairs[i].lastStep == m_step)
+			m_pairs[pairCount++] = m_pairs[i];
+		else
+			m_endedPairs.push_back(m_pairs[i]);
+	}
+
+	if (pairCount != m_pairs.size())
+	{
+		m_pairs.resize(pairCount);
+		RebuildSlots(pairCount);
+	}
+}
+
+void PairCache::Clear()
+{
+	m_pairs.clear();
+	m_endedPairs.clear();
+	std::fill(m_slots.begin(), m_slots.end(), EmptySlot);
+}
+
+CachedPair* PairCache::GetPairs()
+{
+	return m_pairs.data();
+}
+
+const CachedPair* PairCache::GetPairs() const
+{
+	return m_pairs.data();
+}
+
+unsigned int PairCache::GetPairCount() const
+{
+	return static_cast<unsigned int>(m_pairs.size());
+}
+
+const CachedPair* PairCache::GetEndedPairs() const
+{
+	return m_endedPairs.data();
+}
+
+unsigned int PairCache::GetEndedPairCount() const
+{
+	return static_cast<unsigned int>(m_endedPairs.size());
+}
+
+unsigned int PairCache::GetStep() const
+{
+	return m_step;
+}
+
+uint64_t PairCache::GetKey(const Primitive& primitiveA, const Primitive& primitiveB)
+{
+	return (static_cast<uint64_t>(primitiveA.id) << 32) | primitiveB.id;
+}
+
+uint32_t PairCache::GetSlot(uint64_t key) const
+{
+	// Fibonacci hashing, the high bits of the product mix both ids
+	return static_cast<uint32_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & m_slotMask;
+}
+
+void PairCache::RebuildSlots(std::size_t pairCount)
+{
+	// Only grows, so a cache that shrank and grows back does not allocate
+	std::size_t slotCount = std::max<std::size_t>(m_slots.size(), 16);
+	while (slotCount < pairCount * 2)
+		slotCount *= 2;
+
+	m_slots.assign(slotCount, EmptySlot);
+	m_slotMask = static_cast<uint32_t>(slotCount - 1);
+
+	for (std::size_t i = 0; i < m_pairs.size(); ++i)
+	{
+		uint32_t slot = GetSlot(m_pairs[i].key);
+		while (m_slots[slot] != EmptySlot)
+			slot = (slot + 1) & m_slotMask;
+
+		m_slots[slot] = static_cast<int32_t>(i);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "Collision/Primitives/ConvexHull.hpp"
+
+ConvexHull::ConvexHull(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, std::vector<Vector3f> vertices) :
+	Primitive(rigidbody, offset, PrimitiveType::TypeConvexHull),
+	vertices(std::move(vertices))
+{
+}
\ No newline at end of file
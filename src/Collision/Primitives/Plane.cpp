@@ -5,4 +5,5 @@ Plane::Plane(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset
 	Primitive(rigidbody, offset, PrimitiveType::TypePlane)
 {
 	this->normal = normal;
+	this->offset = fOffset;
 }
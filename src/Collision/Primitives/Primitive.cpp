@@ -1,17 +1,26 @@
 #include "Collision/Primitives/Primitive.hpp"
 #include "Rigidbody.hpp"
 
+#include <atomic>
+
+namespace
+{
+	std::atomic<uint32_t> s_nextPrimitiveId(0);
+}
+
 Primitive::Primitive(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset)
-	: type(PrimitiveType::TypePrimitive)
+	: type(PrimitiveType::TypePrimitive),
+	id(s_nextPrimitiveId++)
 {
-	this->rigidbody = rigidbody;
+	this->body = rigidbody ? rigidbody->GetHandle() : BodyHandle();
 	this->offset = offset;
 }
 
 Primitive::Primitive(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, const PrimitiveType& type)
-	: type(type)
+	: type(type),
+	id(s_nextPrimitiveId++)
 {
-	this->rigidbody = rigidbody;
+	this->body = rigidbody ? rigidbody->GetHandle() : BodyHandle();
 	this->offset = offset;
 }
 
@@ -0,0 +1,22 @@
+#include "Collision/Primitives/Tetrahedron.hpp"
+
+#include <cmath>
+
+Tetrahedron::Tetrahedron(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, const std::array<Vector3f, 4>& vertices) :
+	Primitive(rigidbody, offset, PrimitiveType::TypeTetrahedron),
+	vertices(vertices)
+{
+}
+
+Tetrahedron::Tetrahedron(const std::shared_ptr<Rigidbody>& rigidbody, const Matrix4f& offset, const float edgeLength) :
+	Primitive(rigidbody, offset, PrimitiveType::TypeTetrahedron)
+{
+	// Alternate corners of a cube, whose edges are 2 * sqrt(2) long
+	const float s = edgeLength / (2.0f * std::sqrt(2.0f));
+	vertices = {
+		Vector3f(s, s, s),
+		Vector3f(s, -s, -s),
+		Vector3f(-s, s, -s),
+		Vector3f(-s, -s, s)
+	};
+}
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include <algorithm>
+#include "Collision/SweepAndPrune.hpp"
+#include "Collision/Primitives/Primitive.hpp"
+#include "RigidbodyStorage.hpp"
+
+int32_t SweepAndPrune::Endpoint::GetProxy() const
+{
+	return static_cast<int32_t>(data >> 1);
+}
+
+bool SweepAndPrune::Endpoint::IsMax() const
+{
+	return (data & 1) != 0;
+}
+
+SweepAndPrune::SweepAndPrune() :
+	m_sortedEndpointCount(0),
+	m_proxyCount(0),
+	m_sortAxis(0)
+{
+}
+
+int32_t SweepAndPrune::Insert(std::shared_ptr<Primitive> primitive, const BoundingSphere& volume)
+{
+	Proxy proxy;
+	proxy.center = volume.GetCenter();
+	proxy.radius = volume.GetRadius();
+	proxy.alive = true;
+	proxy.primitive = primitive;
+	proxy.body = primitive->body;
+
+	return InsertProxy(proxy);
+}
+
+int32_t SweepAndPrune::Insert(const BodyHandle& body, const BoundingSphere& volume)
+{
+	Proxy proxy;
+	proxy.center = volume.GetCenter();
+	proxy.radius = volume.GetRadius();
+	proxy.alive = true;
+	proxy.body = body;
+
+	return InsertProxy(proxy);
+}
+
+void SweepAndPrune::Remove(int32_t proxy)
+{
+	m_proxies[proxy] = Proxy();
+	m_proxies[proxy].alive = false;
+	m_removedProxies.push_back(proxy);
+	m_proxyCount--;
+}
+
+void SweepAndPrune::Clear()
+{
+	m_proxies.clear();
+	m_freeProxies.clear();
+	m_removedProxies.clear();
+	m_endpoints.clear();
+	m_active.clear();
+	m_activeIndices.clear();
+	m_sortedEndpointCount = 0;
+	m_proxyCount = 0;
+}
+
+void SweepAndPrune::Reserve(std::size_t proxyCount)
+{
+	m_proxies.reserve(proxyCount);
+	m_endpoints.reserve(proxyCount * 2);
+	m_active.reserve(proxyCount);
+	m_activeIndices.reserve(proxyCount);
+}
+
+void SweepAndPrune::Update(const RigidbodyStorage& rigidbodies)
+{
+	// The endpoints of the removed proxies go away before their slot can be reused
+	if (!m_removedProxies.empty())
+	{
+		RemoveDeadEndpoints();
+		m_freeProxies.insert(m_freeProxies.end(), m_removedProxies.begin(), m_removedProxies.end());
+		m_removedProxies.clear();
+	}
+
+	for (Proxy& proxy : m_proxies)
+	{
+		if (!proxy.alive)
+			continue;
+
+		unsigned int index = rigidbodies.GetIndex(proxy.body);
+		if (index != BodyHandle::InvalidIndex)
+			proxy.center = rigidbodies.positions[index];
+	}
+
+	int sortAxis = ChooseSortAxis();
+	bool axisChanged = sortAxis != m_sortAxis;
+	m_sortAxis = sortAxis;
+
+	UpdateEndpointValues();
+
+	// The previous order means nothing on another axis, insertion sort would be quadratic
+	if (axisChanged)
+		std::sort(m_endpoints.begin(), m_endpoints.end(), &SweepAndPrune::EndpointLess);
+	else
+		SortEndpoints();
+
+	m_sortedEndpointCount = m_endpoints.size();
+}
+
+unsigned int SweepAndPrune::GetPotentialContact(PotentialContact* contacts, unsigned int limit) const
+{
+	unsigned int count = 0;
+	m_truncated = false;
+
+	auto report = [&](int32_t proxyA, int32_t proxyB)
+	{
+		// One pair past the limit is enough to know some were left out
+		if (count >= limit)
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		contacts[count].bodies[0] = m_proxies[proxyA].body;
+		contacts[count].bodies[1] = m_proxies[proxyB].body;
+		++count;
+		return true;
+	};
+
+	Sweep(report);
+	return count;
+}
+
+unsigned int SweepAndPrune::GetPotentialContactPrimitive(PotentialContactPrimitive* contacts, unsigned int limit) const
+{
+	unsigned int count = 0;
+	m_truncated = false;
+
+	auto report = [&](int32_t proxyA, int32_t proxyB)
+	{
+		// One pair past the limit is enough to know some were left out
+		if (count >= limit)
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		// Proxies inserted without a primitive only take part in body pairs
+		if (m_proxies[proxyA].primitive == nullptr || m_proxies[proxyB].primitive == nullptr)
+			return true;
+
+		contacts[count].primitives[0] = m_proxies[proxyA].primitive.get();
+		contacts[count].primitives[1] = m_proxies[proxyB].primitive.get();
+		++count;
+		return true;
+	};
+
+	Sweep(report);
+	return count;
+}
+
+std::size_t SweepAndPrune::GetProxyCount() const
+{
+	return m_proxyCount;
+}
+
+int SweepAndPrune::GetSortAxis() const
+{
+	return m_sortAxis;
+}
+
+int32_t SweepAndPrune::InsertProxy(const Proxy& proxy)
+{
+	int32_t index;
+
+	if (!m_freeProxies.empty())
+	{
+		index = m_freeProxies.back();
+		m_freeProxies.pop_back();
+		m_proxies[index] = proxy;
+	}
+	else
+	{
+		index = static_cast<int32_t>(m_proxies.size());
+		m_proxies.push_back(proxy);
+		m_activeIndices.push_back(0);
+	}
+
+	// Appended unsorted, the next Update moves them to their place
+	uint32_t data = static_cast<uint32_t>(index) << 1;
+	m_endpoints.push_back({ GetAxisValue(proxy.center, m_sortAxis) - proxy.radius, data });
+	m_endpoints.push_back({ GetAxisValue(proxy.center, m_sortAxis) + proxy.radius, data | 1 });
+	m_proxyCount++;
+
+	return index;
+}
+
+int SweepAndPrune::ChooseSortAxis() const
+{
+	if (m_proxyCount < 2)
+		return m_sortAxis;
+
+	Vector3f sum = Vector3f::Zero;
+	Vector3f sumSquared = Vector3f::Zero;
+
+	for (const Proxy& proxy : m_proxies)
+	{
+		if (!proxy.alive)
+			continue;
+
+		sum += proxy.center;
+		sumSquared += Vector3f(proxy.center.x * proxy.center.x, proxy.center.y * proxy.center.y, proxy.center.z * proxy.center.z);
+	}
+
+	// Variance times the proxy count, enough to compare the axes
+	float count = static_cast<float>(m_proxyCount);
+	float varianceX = sumSquared.x - sum.x * sum.x / count;
+	float varianceY = sumSquared.y - sum.y * sum.y / count;
+	float varianceZ = sumSquared.z - sum.z * sum.z / count;
+
+	// Only switch for a clear gain, a new axis means a full sort
+	float current = m_sortAxis == 0 ? varianceX : (m_sortAxis == 1 ? varianceY : varianceZ);
+	int axis = m_sortAxis;
+	float best = current * 1.2f;
+
+	if (varianceX > best) { axis = 0; best = varianceX; }
+	if (varianceY > best) { axis = 1; best = varianceY; }
+	if (varianceZ > best) { axis = 2; best = varianceZ; }
+
+	return axis;
+}
+
+float SweepAndPrune::GetAxisValue(const Vector3f& vector, int axis)
+{
+	return axis == 0 ? vector.x : (axis == 1 ? vector.y : vector.z);
+}
+
+bool SweepAndPrune::EndpointLess(const Endpoint& a, const Endpoint& b)
+{
+	return a.value < b.value || (a.value == b.value && !a.IsMax() && b.IsMax());
+}
+
+void SweepAndPrune::RemoveDeadEndpoints()
+{
+	std::size_t sortedCount = 0;
+	std::size_t count = 0;
+
+	for (std::size_t i = 0; i < m_endpoints.size(); ++i)
+	{
+		if (!m_proxies[m_endpoints[i].GetProxy()].alive)
+			continue;
+
+		m_endpoints[count++] = m_endpoints[i];
+		if (i < m_sortedEndpointCount)
+			sortedCount++;
+	}
+
+	m_endpoints.resize(count);
+	m_sortedEndpointCount = sortedCount;
+}
+
+void SweepAndPrune::UpdateEndpointValues()
+{
+	for (Endpoint& endpoint : m_endpoints)
+	{
+		const Proxy& proxy = m_proxies[endpoint.GetProxy()];
+		float center = GetAxisValue(proxy.center, m_sortAxis);
+		endpoint.value = endpoint.IsMax() ? center + proxy.radius : center - proxy.radius;
+	}
+}
+
+void SweepAndPrune::SortEndpoints()
+{
+	// Insertion sort, each endpoint only moves past the few bounds it crossed since the last update
+	for (std::size_t i = 1; i < m_sortedEndpointCount; ++i)
+	{
+		Endpoint endpoint = m_endpoints[i];
+		std::size_t j = i;
+
+		while (j > 0 && EndpointLess(endpoint, m_endpoints[j - 1]))
+		{
+			m_endpoints[j] = m_endpoints[j - 1];
+			--j;
+		}
+
+		m_endpoints[j] = endpoint;
+	}
+
+	// Endpoints of the new proxies are sorted on their own, then merged
+	if (m_sortedEndpointCount < m_endpoints.size())
+	{
+		auto middle = m_endpoints.begin() + m_sortedEndpointCount;
+		std::sort(middle, m_endpoints.end(), &SweepAndPrune::EndpointLess);
+		std::inplace_merge(m_endpoints.begin(), middle, m_endpoints.end(), &SweepAndPrune::EndpointLess);
+	}
+}
+
+bool SweepAndPrune::Overlaps(int32_t proxyA, int32_t proxyB) const
+{
+	// Same test as the BVH so both report the same pairs
+	const Proxy& a = m_proxies[proxyA];
+	const Proxy& b = m_proxies[proxyB];
+
+	float distanceSquared = (a.center - b.center).GetLengthSquared();
+	return distanceSquared < (a.radius + b.radius) * (a.radius + b.radius);
+}
+
+template<typename Report>
+void SweepAndPrune::Sweep(Report& report) const
+{
+	m_active.clear();
+
+	for (const Endpoint& endpoint : m_endpoints)
+	{
+		int32_t proxy = endpoint.GetProxy();
+
+		// Removed since the last update
+		if (!m_proxies[proxy].alive)
+			continue;
+
+		if (endpoint.IsMax())
+		{
+			int32_t index = m_activeIndices[proxy];
+			int32_t last = m_active.back();
+			m_active[index] = last;
+			m_activeIndices[last] = index;
+			m_active.pop_back();
+			continue;
+		}
+
+		// Every active proxy overlaps this one on the sorted axis
+		for (int32_t other : m_active)
+		{
+			if (Overlaps(other, proxy) && !report(other, proxy))
+				return;
+		}
+
+		m_activeIndices[proxy] = static_cast<int32_t>(m_active.size());
+		m_active.push_back(proxy);
+	}
+}
\ No newline at end of file
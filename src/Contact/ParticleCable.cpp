@@ -15,7 +15,7 @@ void ParticleCable::AddContact(std::vector <std::shared_ptr<ParticleContact>>& c
 
 	if (length < maxLength) return;
 
-	Vector3f normal = (particles.at(1)->position - particles.at(0)->position).GetNormalized();
+	Vector3f normal = (particles.at(1)->GetPosition() - particles.at(0)->GetPosition()).GetNormalized();
 
 	std::shared_ptr<ParticleContact> newContact = std::make_shared<ParticleContact>(particles, restitution, length - maxLength, normal);
 
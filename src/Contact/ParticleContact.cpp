@@ -1,8 +1,20 @@
 #include "Contact/ParticleContact.hpp"
 
-ParticleContact::ParticleContact(std::vector<std::shared_ptr<Particle>>& particles, float restitution, float penetration, Vector3f contactNormal)
+ParticleContact::ParticleContact() :
+	particles({ nullptr, nullptr }),
+	restitution(0.f),
+	penetration(0.f)
 {
-	this->particles = particles;
+}
+
+ParticleContact::ParticleContact(std::vector<std::shared_ptr<Particle>>& particles, float restitution, float penetration, Vector3f contactNormal) :
+	ParticleContact(particles[0].get(), particles.size() > 1 ? particles[1].get() : nullptr, restitution, penetration, contactNormal)
+{
+}
+
+ParticleContact::ParticleContact(Particle* particle, Particle* otherParticle, float restitution, float penetration, Vector3f contactNormal)
+{
+	this->particles = { particle, otherParticle };
 	this->penetration = penetration;
 	this->restitution = restitution;
 	this->contactNormal = contactNormal;
@@ -16,10 +28,10 @@ void ParticleContact::Resolve(float duration)
 
 float ParticleContact::CalculateSeparatingVelocity()
 {
-	Vector3f velocity = particles.at(0)->velocity;
+	Vector3f velocity = particles[0]->GetVelocity();
 
-	if (particles.at(1))
-		velocity -= particles.at(1)->velocity;
+	if (particles[1])
+		velocity -= particles[1]->GetVelocity();
 
 	return velocity * contactNormal;
 }
@@ -34,9 +46,9 @@ void ParticleContact::ResolveVelocity(float duration)
 	float newSeparatingVelocity = -sVelocity * restitution;
 
 
-	Vector3f accel = particles.at(0)->GetAcceleration();
-	if (particles.at(1))
-		accel -= particles.at(1)->GetAcceleration();
+	Vector3f accel = particles[0]->GetAcceleration();
+	if (particles[1])
+		accel -= particles[1]->GetAcceleration();
 
 	float accelSeparating = accel * contactNormal * duration;
 
@@ -47,28 +59,38 @@ void ParticleContact::ResolveVelocity(float duration)
 	}
 
 
-	float inverseMass = 1.f / particles.at(0)->mass;
+	float inverseMass = particles[0]->GetInverseMass();
+
+	if (particles[1])
+		inverseMass += particles[1]->GetInverseMass();
 
-	if (particles.at(1))
-		inverseMass += 1.f / particles.at(1)->mass;
+	if (inverseMass <= 0.f) return;
 
-	particles.at(0)->velocity += (contactNormal * (newSeparatingVelocity - sVelocity) / inverseMass) * (1.f / particles.at(0)->mass);
+	particles[0]->SetVelocity(particles[0]->GetVelocity() + (contactNormal * (newSeparatingVelocity - sVelocity) / inverseMass) * particles[0]->GetInverseMass());
 	
-	if (particles.at(1))
-		particles.at(1)->velocity += (contactNormal * (newSeparatingVelocity - sVelocity) / inverseMass) * -(1.f / particles.at(1)->mass);
+	if (particles[1])
+		particles[1]->SetVelocity(particles[1]->GetVelocity() + (contactNormal * (newSeparatingVelocity - sVelocity) / inverseMass) * -particles[1]->GetInverseMass());
 }
 
 void ParticleContact::ResolveInterpenetration(float duration)
 {
 	if (penetration <= 0.f) return;
 
-	float inverseMass = 1.f / particles.at(0)->mass;
+	float inverseMass = particles[0]->GetInverseMass();
+
+	if (particles[1])
+		inverseMass += particles[1]->GetInverseMass();
+
+	if (inverseMass <= 0.f) return;
+
+	// The normal points towards the first particle, it moves along it and the second one against it
+	Vector3f movePerInverseMass = contactNormal * (penetration / inverseMass);
 
-	if (particles.at(1))
-		inverseMass += 1.f / particles.at(1)->mass;
+	particles[0]->SetPosition(particles[0]->GetPosition() + movePerInverseMass * particles[0]->GetInverseMass());
 
-	particles.at(0)->position += (contactNormal * (-penetration / inverseMass)) * (1.f / particles.at(0)->mass);
+	if(particles[1])
+		particles[1]->SetPosition(particles[1]->GetPosition() - movePerInverseMass * particles[1]->GetInverseMass());
 
-	if(particles.at(1))
-		particles.at(1)->position += (contactNormal * (-penetration / inverseMass)) * (1.f / particles.at(1)->mass);
+	// The overlap is gone, further iterations must not move the particles again
+	penetration = 0.f;
 }
@@ -42,3 +42,12 @@ void ParticleContactResolver::ResolveContacts(std::vector<std::shared_ptr<Partic
 		contactArray.erase(contactArray.begin() + i);
 	}
 }
+
+void ParticleContactResolver::ResolveContacts(ParticleContact* contacts, unsigned int numContacts, float duration)
+{
+	for (unsigned int i = 0; i < iteration; i++)
+	{
+		for (unsigned int j = 0; j < numContacts; j++)
+			contacts[j].Resolve(duration);
+	}
+}
\ No newline at end of file
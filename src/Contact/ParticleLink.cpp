@@ -8,7 +8,7 @@ ParticleLink::ParticleLink(std::vector<std::shared_ptr<Particle>>& particles)
 
 float ParticleLink::CurrentLength() const
 {
-    return (particles.at(0)->position - particles.at(1)->position).GetLength();
+    return (particles.at(0)->GetPosition() - particles.at(1)->GetPosition()).GetLength();
 }
 
 void ParticleLink::AddContact(std::vector<std::shared_ptr<ParticleContact>> contact, unsigned int limit)
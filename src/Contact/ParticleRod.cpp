@@ -14,7 +14,7 @@ void ParticleRod::AddContact(std::vector<std::shared_ptr<ParticleContact>>& cont
 
 	if (currLength == length) return;
 
-	Vector3f normal = (particles.at(1)->position - particles.at(0)->position).GetNormalized();
+	Vector3f normal = (particles.at(1)->GetPosition() - particles.at(0)->GetPosition()).GetNormalized();
 	float penetration = 0.f;
 
 	if (currLength > length)
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <cmath>
+#include "Contact/ParticleSpatialHash.hpp"
+#include "ParticleStorage.hpp"
+
+namespace
+{
+	// Half of the 26 neighbouring cells, the other half finds the same pairs from the neighbour's side
+	const int32_t ForwardNeighbours[13][3] =
+	{
+		{ 1, -1, -1 }, { 1, -1, 0 }, { 1, -1, 1 },
+		{ 1, 0, -1 }, { 1, 0, 0 }, { 1, 0, 1 },
+		{ 1, 1, -1 }, { 1, 1, 0 }, { 1, 1, 1 },
+		{ 0, 1, -1 }, { 0, 1, 0 }, { 0, 1, 1 },
+		{ 0, 0, 1 }
+	};
+}
+
+bool ParticleSpatialHash::Cell::operator==(const Cell& cell) const
+{
+	return x == cell.x && y == cell.y && z == cell.z;
+}
+
+ParticleSpatialHash::ParticleSpatialHash(float particleRadius, float restitution, unsigned int maxContacts) :
+	m_restitution(restitution),
+	m_bucketMask(0),
+	m_contacts(maxContacts),
+	m_contactCount(0),
+	m_truncated(false)
+{
+	SetParticleRadius(particleRadius);
+}
+
+unsigned int ParticleSpatialHash::GenerateContacts(const ParticleStorage& particles)
+{
+	m_contactCount = 0;
+	m_truncated = false;
+
+	Bin(particles);
+
+	// Walking the particles in bucket order keeps the particles of a cell in cache while they are tested together
+	const uint32_t particleCount = static_cast<uint32_t>(m_sortedParticles.size());
+	for (uint32_t i = 0; i < particleCount; i++)
+	{
+		const Cell& cell = m_sortedCells[i];
+
+		// Particles of the same cell are all in this bucket, the ones sorted before this particle already met it
+		if (!GenerateContacts(i, cell, i + 1))
+			return m_contactCount;
+
+		for (const int32_t* offset : ForwardNeighbours)
+		{
+			const Cell neighbour = { cell.x + offset[0], cell.y + offset[1], cell.z + offset[2] };
+
+			if (!GenerateContacts(i, neighbour, m_bucketStarts[GetBucket(neighbour)]))
+				return m_contactCount;
+		}
+	}
+
+	return m_contactCount;
+}
+
+void ParticleSpatialHash::SetParticleRadius(float particleRadius)
+{
+	m_particleRadius = particleRadius;
+	// Two particles closer than a diameter are always in neighbouring cells
+	m_inverseCellSize = 1.f / (2.f * particleRadius);
+}
+
+float ParticleSpatialHash::GetParticleRadius() const
+{
+	return m_particleRadius;
+}
+
+float ParticleSpatialHash::GetCellSize() const
+{
+	return 2.f * m_particleRadius;
+}
+
+void ParticleSpatialHash::SetRestitution(float restitution)
+{
+	m_restitution = restitution;
+}
+
+float ParticleSpatialHash::GetRestitution() const
+{
+	return m_restitution;
+}
+
+ParticleContact* ParticleSpatialHash::GetContacts()
+{
+	return m_contacts.data();
+}
+
+unsigned int ParticleSpatialHash::GetContactCount() const
+{
+	return m_contactCount;
+}
+
+unsigned int ParticleSpatialHash::GetMaxContacts() const
+{
+	return static_cast<unsigned int>(m_contacts.size());
+}
+
+bool ParticleSpatialHash::IsTruncated() const
+{
+	return m_truncated;
+}
+
+void ParticleSpatialHash::Bin(const ParticleStorage& particles)
+{
+	const uint32_t particleCount = static_cast<uint32_t>(particles.GetSize());
+
+	// Twice as many buckets as particles keeps the collisions between cells rare, the table only grows
+	uint32_t bucketCount = 1;
+	while (bucketCount < 2 * particleCount)
+		bucketCount <<= 1;
+
+	if (bucketCount > m_bucketMask + 1)
+	{
+		m_bucketMask = bucketCount - 1;
+		m_bucketStarts.resize(static_cast<std::size_t>(bucketCount) + 1);
+	}
+	bucketCount = m_bucketMask + 1;
+
+	m_particleCells.resize(particleCount);
+	m_sortedParticles.resize(particleCount);
+	m_sortedPositions.resize(particleCount);
+	m_sortedCells.resize(particleCount);
+
+	// Count the particles of every bucket
+	std::fill(m_bucketStarts.begin(), m_bucketStarts.end(), 0u);
+	for (uint32_t i = 0; i < particleCount; i++)
+	{
+		const Cell cell = { GetCellCoordinate(particles.positionsX[i]), GetCellCoordinate(particles.positionsY[i]), GetCellCoordinate(particles.positionsZ[i]) };
+		m_particleCells[i] = cell;
+		m_bucketStarts[GetBucket(cell)]++;
+	}
+
+	// Every bucket now holds the end of its range
+	uint32_t end = 0;
+	for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+	{
+		end += m_bucketStarts[bucket];
+		m_bucketStarts[bucket] = end;
+	}
+	m_bucketStarts[bucketCount] = particleCount;
+
+	// Filling the ranges from their end moves every bucket back to its start and keeps the particles in index order
+	for (uint32_t i = particleCount; i-- > 0;)
+	{
+		const uint32_t slot = --m_bucketStarts[GetBucket(m_particleCells[i])];
+		m_sortedParticles[slot] = particles.GetParticle(i);
+		m_sortedPositions[slot] = Vector3f(particles.positionsX[i], particles.positionsY[i], particles.positionsZ[i]);
+		m_sortedCells[slot] = m_particleCells[i];
+	}
+}
+
+bool ParticleSpatialHash::GenerateContacts(uint32_t slot, const Cell& cell, uint32_t firstSlot)
+{
+	const float diameter = 2.f * m_particleRadius;
+	const Vector3f& position = m_sortedPositions[slot];
+	const uint32_t lastSlot = m_bucketStarts[GetBucket(cell) + 1];
+
+	for (uint32_t j = firstSlot; j < lastSlot; j++)
+	{
+		// Buckets also hold the particles of other cells hashed to the same value
+		if (!(m_sortedCells[j] == cell))
+			continue;
+
+		const Vector3f offset = position - m_sortedPositions[j];
+		const float squaredDistance = offset.GetLengthSquared();
+		if (squaredDistance >= diameter * diameter)
+			continue;
+
+		if (m_contactCount == m_contacts.size())
+		{
+			m_truncated = true;
+			return false;
+		}
+
+		const float distance = std::sqrt(squaredDistance);
+		// Particles at the same position are separated along an arbitrary axis
+		const Vector3f normal = distance > 0.f ? offset / distance : Vector3f::Up;
+
+		m_contacts[m_contactCount++] = ParticleContact(m_sortedParticles[slot], m_sortedParticles[j], m_restitution, diameter - distance, normal);
+	}
+
+	return true;
+}
+
+int32_t ParticleSpatialHash::GetCellCoordinate(float value) const
+{
+	return static_cast<int32_t>(std::floor(value * m_inverseCellSize));
+}
+
+uint32_t ParticleSpatialHash::GetBucket(const Cell& cell) const
+{
+	// Linear in x, so the neighbours of consecutive buckets are consecutive buckets as well and stay in cache
+	const uint32_t hash = static_cast<uint32_t>(cell.x) + static_cast<uint32_t>(cell.y) * 19349663u + static_cast<uint32_t>(cell.z) * 83492791u;
+	return hash & m_bucketMask;
+}
\ No newline at end of file
@@ -1,37 +1,92 @@
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include "Quaternion.hpp"
 #include "EulerIntegrator.hpp"
 #include "Particle.hpp"
-#include "Rigidbody.hpp"
-#include "Collision/BoundingSphere.hpp"
+#include "RigidbodyStorage.hpp"
+#include "ParticleStorage.hpp"
 #include "State.hpp"
 
-void EulerIntegrator::Update(State& current, std::vector<std::shared_ptr<Particle>>& particles, std::vector<std::shared_ptr<Rigidbody>> rigidbodies, const float& deltaTime, bool isGravityEnabled /*= true*/)
+#if defined(__AVX__) || defined(__AVX2__)
+#include <immintrin.h>
+#define EULER_INTEGRATOR_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EULER_INTEGRATOR_SSE
+#endif
+
+void EulerIntegrator::Update(State& current, ParticleStorage& particles, RigidbodyStorage& rigidbodies, const float& deltaTime, bool isGravityEnabled /*= true*/)
 {
-	// Update Particles
-	for (std::shared_ptr<Particle> particle : particles)
-	{
-		particle->velocity += particle->GetAcceleration() * deltaTime;
-		particle->position += particle->velocity * deltaTime;
-	}
+	// Every body is integrated independently, so splitting them in chunks gives the same result on any number of threads.
+	// The State is resized first and each chunk writes its own slice of it.
 
-	// Save Particles Positions
-	current.m_particlePositions.clear();
-	for (std::shared_ptr<Particle> particle : particles)
-	{
-		current.m_particlePositions.push_back(particle->position);
-	}
+	// Update Particles & Save Particles Positions
+	current.m_particlePositions.resize(particles.GetSize());
+	Vector3f* particlePositions = current.m_particlePositions.data();
+
+	ParallelFor(particles.GetSize(), ParticleChunkSize, [&](std::size_t begin, std::size_t end)
+		{
+			IntegrateParticles(particles, begin, end, deltaTime);
+			particles.WriteSnapshot(particlePositions, begin, end);
+		});
+
+	// Update Rigidbodies & Save Rigidbodies Positions & Rotations
+	current.m_rigidbodyPositions.resize(rigidbodies.GetSize());
+	current.m_rigidbodyRotations.resize(rigidbodies.GetSize());
+	Vector3f* rigidbodyPositions = current.m_rigidbodyPositions.data();
+	Quaternionf* rigidbodyRotations = current.m_rigidbodyRotations.data();
+
+	ParallelFor(rigidbodies.GetSize(), RigidbodyChunkSize, [&](std::size_t begin, std::size_t end)
+		{
+			IntegrateRigidbodies(rigidbodies, begin, end, deltaTime);
+			std::copy(rigidbodies.positions.begin() + begin, rigidbodies.positions.begin() + end, rigidbodyPositions + begin);
+			std::copy(rigidbodies.rotations.begin() + begin, rigidbodies.rotations.begin() + end, rigidbodyRotations + begin);
+		});
+}
+
+void EulerIntegrator::SetThreadCount(unsigned int threadCount)
+{
+	if (threadCount <= 1)
+		m_threadPool.reset();
+	else if (!m_threadPool || m_threadPool->GetThreadCount() != threadCount)
+		m_threadPool = std::make_unique<ThreadPool>(threadCount);
+}
+
+unsigned int EulerIntegrator::GetThreadCount() const
+{
+	return m_threadPool ? m_threadPool->GetThreadCount() : 1;
+}
+
+template<typename Function>
+void EulerIntegrator::ParallelFor(std::size_t count, std::size_t chunkSize, const Function& function)
+{
+	if (m_threadPool)
+		m_threadPool->ParallelFor(count, chunkSize, function);
+	else if (count > 0)
+		function(0, count);
+}
+
+void EulerIntegrator::IntegrateRigidbodies(RigidbodyStorage& rigidbodies, std::size_t begin, std::size_t end, float deltaTime)
+{
+	// Weight kept from the previous motion, it halves every second whatever the time step
+	const float motionBias = std::pow(0.5f, deltaTime);
 
-	// Update Rigidbodies
-	for (std::shared_ptr<Rigidbody> rigidbody : rigidbodies)
+	for (std::size_t i = begin; i < end; ++i)
 	{
-		rigidbody->velocity += rigidbody->GetAcceleration() * deltaTime * (1.0f - rigidbody->linearDamping);
-		rigidbody->position += rigidbody->velocity * deltaTime;
-		
-		if(rigidbody->m_boundingSphere != nullptr)
-			rigidbody->m_boundingSphere->m_center = rigidbody->position;
+		// Static and sleeping bodies only move when they are woken up or placed, CalculateDerivedData is then up to the caller
+		if (rigidbodies.inverseMasses[i] == 0.0f || rigidbodies.awake[i] == 0)
+			continue;
 
-		rigidbody->angularVelocity += rigidbody->GetAngularAcceleration() * deltaTime * (1.0f - rigidbody->angularDamping);
+		Vector3f& position = rigidbodies.positions[i];
+		Quaternionf& rotation = rigidbodies.rotations[i];
+		Vector3f& velocity = rigidbodies.velocities[i];
+		Vector3f& angularVelocity = rigidbodies.angularVelocities[i];
+
+		velocity += rigidbodies.forces[i] * rigidbodies.inverseMasses[i] * deltaTime * (1.0f - rigidbodies.linearDampings[i]);
+		position += velocity * deltaTime;
+
+		angularVelocity += rigidbodies.inverseInertiaTensorsWorld[i] * rigidbodies.torques[i] * deltaTime * (1.0f - rigidbodies.angularDampings[i]);
 
 		// Calculate the rotation quaternion using the angular velocity
 		//Quaternionf deltaRotation = Quaternionf(
@@ -45,19 +100,89 @@ void EulerIntegrator::Update(State& current, std::vector<std::shared_ptr<Particl
 		//rigidbody->rotation = deltaRotation * rigidbody->rotation;
 		//rigidbody->rotation.Normalize();  // Normalize the quaternion to avoid drift over time
 
-		Quaternionf newRotation = Quaternionf(0.f, rigidbody->angularVelocity.x, rigidbody->angularVelocity.y, rigidbody->angularVelocity.z) * deltaTime;
-		newRotation = newRotation * rigidbody->rotation;
-		rigidbody->rotation = rigidbody->rotation + newRotation * 0.5;
+		Quaternionf newRotation = Quaternionf(0.f, angularVelocity.x, angularVelocity.y, angularVelocity.z) * deltaTime;
+		newRotation = newRotation * rotation;
+		rotation = rotation + newRotation * 0.5;
+
+		// A body that barely moved for a while falls asleep, capping the average lets a fast body settle in time
+		float& motion = rigidbodies.motions[i];
+		motion = motionBias * motion + (1.0f - motionBias) * (velocity * velocity + angularVelocity * angularVelocity);
+		motion = std::min(motion, SLEEP_MOTION * 10.0f);
 
-		rigidbody->CalculateDerivedData();
+		if (motion < SLEEP_MOTION)
+		{
+			rigidbodies.awake[i] = 0;
+			velocity = Vector3f::Zero;
+			angularVelocity = Vector3f::Zero;
+		}
+
+		rigidbodies.CalculateDerivedData(static_cast<unsigned int>(i));
 	}
+}
 
-	// Save Rigidbodies Positions & Rotations
-	current.m_rigidbodyPositions.clear();
-	current.m_rigidbodyRotations.clear();
-	for (std::shared_ptr<Rigidbody> rigidbody : rigidbodies)
+void EulerIntegrator::IntegrateParticles(ParticleStorage& particles, std::size_t begin, std::size_t end, float deltaTime)
+{
+	float* px = particles.positionsX.data();
+	float* py = particles.positionsY.data();
+	float* pz = particles.positionsZ.data();
+	float* vx = particles.velocitiesX.data();
+	float* vy = particles.velocitiesY.data();
+	float* vz = particles.velocitiesZ.data();
+	const float* fx = particles.forcesX.data();
+	const float* fy = particles.forcesY.data();
+	const float* fz = particles.forcesZ.data();
+	const float* inverseMasses = particles.inverseMasses.data();
+
+	std::size_t i = begin;
+
+	// Multiply and add are kept separate (no fma) so every path gives the same result as the scalar loop
+#if defined(EULER_INTEGRATOR_AVX)
+	const __m256 dt = _mm256_set1_ps(deltaTime);
+	for (; i + 8 <= end; i += 8)
 	{
-		current.m_rigidbodyPositions.push_back(rigidbody->position);
-		current.m_rigidbodyRotations.push_back(rigidbody->rotation);
+		const __m256 scale = _mm256_mul_ps(_mm256_loadu_ps(inverseMasses + i), dt);
+
+		__m256 velocityX = _mm256_add_ps(_mm256_loadu_ps(vx + i), _mm256_mul_ps(_mm256_loadu_ps(fx + i), scale));
+		__m256 velocityY = _mm256_add_ps(_mm256_loadu_ps(vy + i), _mm256_mul_ps(_mm256_loadu_ps(fy + i), scale));
+		__m256 velocityZ = _mm256_add_ps(_mm256_loadu_ps(vz + i), _mm256_mul_ps(_mm256_loadu_ps(fz + i), scale));
+		_mm256_storeu_ps(vx + i, velocityX);
+		_mm256_storeu_ps(vy + i, velocityY);
+		_mm256_storeu_ps(vz + i, velocityZ);
+
+		_mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(velocityX, dt)));
+		_mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(velocityY, dt)));
+		_mm256_storeu_ps(pz + i, _mm256_add_ps(_mm256_loadu_ps(pz + i), _mm256_mul_ps(velocityZ, dt)));
+	}
+#elif defined(EULER_INTEGRATOR_SSE)
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	for (; i + 4 <= end; i += 4)
+	{
+		const __m128 scale = _mm_mul_ps(_mm_loadu_ps(inverseMasses + i), dt);
+
+		__m128 velocityX = _mm_add_ps(_mm_loadu_ps(vx + i), _mm_mul_ps(_mm_loadu_ps(fx + i), scale));
+		__m128 velocityY = _mm_add_ps(_mm_loadu_ps(vy + i), _mm_mul_ps(_mm_loadu_ps(fy + i), scale));
+		__m128 velocityZ = _mm_add_ps(_mm_loadu_ps(vz + i), _mm_mul_ps(_mm_loadu_ps(fz + i), scale));
+		_mm_storeu_ps(vx + i, velocityX);
+		_mm_storeu_ps(vy + i, velocityY);
+		_mm_storeu_ps(vz + i, velocityZ);
+
+		_mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velocityX, dt)));
+		_mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velocityY, dt)));
+		_mm_storeu_ps(pz + i, _mm_add_ps(_mm_loadu_ps(pz + i), _mm_mul_ps(velocityZ, dt)));
+	}
+#endif
+
+	// Remaining particles, or all of them when no vector instructions are available
+	for (; i < end; ++i)
+	{
+		const float scale = inverseMasses[i] * deltaTime;
+
+		vx[i] += fx[i] * scale;
+		vy[i] += fy[i] * scale;
+		vz[i] += fz[i] * scale;
+
+		px[i] += vx[i] * deltaTime;
+		py[i] += vy[i] * deltaTime;
+		pz[i] += vz[i] * deltaTime;
 	}
 }
@@ -17,13 +17,13 @@ ForceAnchoredSpring::ForceAnchoredSpring(Vector3f anchor, Vector3f connectionPoi
 	connectionPoint(connectionPoint)
 {}
 
-void ForceAnchoredSpring::UpdateForce(std::shared_ptr<Particle> particle, float deltaTime)
+void ForceAnchoredSpring::UpdateForce(Particle& particle, float deltaTime)
 {
-	if (particle->mass < 1.0f)
+	if (particle.GetMass() < 1.0f)
 		return;
 
 	// calculate the vector of the spring
-	Vector3f springVector = particle->position - m_anchor;
+	Vector3f springVector = particle.GetPosition() - m_anchor;
 
 	if (springVector.x == 0 && springVector.y == 0 && springVector.z == 0)
 		return;
@@ -33,16 +33,16 @@ void ForceAnchoredSpring::UpdateForce(std::shared_ptr<Particle> particle, float
 
 	// calculate the final force and apply it
 	Vector3f force = -m_k * (magnitude - m_restLength) * springVector.GetNormalized();
-	particle->AddForce(force);
+	particle.AddForce(force);
 }
 
-void ForceAnchoredSpring::UpdateForce(std::shared_ptr<Rigidbody> rigidbody, float deltaTime)
+void ForceAnchoredSpring::UpdateForce(Rigidbody& rigidbody, float deltaTime)
 {
-	if (rigidbody->mass < 1.0f)
+	if (rigidbody.GetMass() < 1.0f)
 		return;
 
 	// calculate local to world space point
-	Vector3f localInWorldSpace = rigidbody->GetPointInWorldSpace(connectionPoint);
+	Vector3f localInWorldSpace = rigidbody.GetPointInWorldSpace(connectionPoint);
 
 	// calculate the force of the spring
 	Vector3f force = localInWorldSpace - m_anchor;
@@ -56,7 +56,7 @@ void ForceAnchoredSpring::UpdateForce(std::shared_ptr<Rigidbody> rigidbody, floa
 	force.Normalize();
 	force *= -magnitude;
 
-	rigidbody->AddForceAtPoint(force, localInWorldSpace);
+	rigidbody.AddForceAtPoint(force, localInWorldSpace);
 }
 
 void ForceAnchoredSpring::SetAnchor(Vector3f anchor)
@@ -1,6 +1,8 @@
 #include "Force/ForceBuoyancy.hpp"
 #include "Particle.hpp"
 #include "Rigidbody.hpp"
+#include "ParticleStorage.hpp"
+#include "RigidbodyStorage.hpp"
 
 ForceBuoyancy::ForceBuoyancy(float maxDepth, float volume, float waterHeight, float liquidDensity) :
 	m_maxDepth(maxDepth),
@@ -10,54 +12,74 @@ ForceBuoyancy::ForceBuoyancy(float maxDepth, float volume, float waterHeight, fl
 {
 }
 
-void ForceBuoyancy::UpdateForce(std::shared_ptr<Particle> particle, float deltaTime)
+void ForceBuoyancy::UpdateForce(Particle& particle, float deltaTime)
 {
-	// calculate the submersion depth
-	float depth = particle->position.y;
+	Vector3f force;
+	if (CalculateForce(particle.GetPosition().y, force))
+		particle.AddForce(force);
+}
 
-	// check if we're out of the water
-	if (depth >= m_waterHeight + m_maxDepth)
+void ForceBuoyancy::UpdateForce(Rigidbody& rigidbody, float deltaTime)
+{
+	Vector3f force;
+	if (CalculateForce(rigidbody.GetPosition().y, force))
+		rigidbody.AddForce(force);
+}
+
+void ForceBuoyancy::UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, [[maybe_unused]] float deltaTime)
+{
+	const float* py = particles.positionsY.data();
+	float* fx = particles.forcesX.data();
+	float* fy = particles.forcesY.data();
+	float* fz = particles.forcesZ.data();
+
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		return;
+		unsigned int index = indices[i];
+
+		Vector3f force;
+		if (!CalculateForce(py[index], force))
+			continue;
+
+		fx[index] += force.x;
+		fy[index] += force.y;
+		fz[index] += force.z;
 	}
+}
 
-	Vector3f force(0, 0, 0);
+void ForceBuoyancy::UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, [[maybe_unused]] float deltaTime)
+{
+	const Vector3f* positions = rigidbodies.positions.data();
+	Vector3f* forces = rigidbodies.forces.data();
 
-	// check if we're at maximum depth
-	if (depth <= m_waterHeight - m_maxDepth)
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		force.y = m_liquidDensity * m_volume;
-		particle->AddForce(force);
-		return;
-	}
+		unsigned int index = indices[i];
 
-	// otherwise we are partly submerged
-	force.y = m_liquidDensity * m_volume * (depth - m_waterHeight - m_maxDepth) / 2 * m_maxDepth;
-	particle->AddForce(force);
+		Vector3f force;
+		if (CalculateForce(positions[index].y, force))
+			forces[index] += force;
+	}
 }
 
-void ForceBuoyancy::UpdateForce(std::shared_ptr<Rigidbody> rigidbody, float deltaTime)
+bool ForceBuoyancy::CalculateForce(float depth, Vector3f& force) const
 {
-	// calculate the submersion depth
-	float depth = rigidbody->position.y;
-
 	// check if we're out of the water
 	if (depth >= m_waterHeight + m_maxDepth)
 	{
-		return;
+		return false;
 	}
 
-	Vector3f force(0, 0, 0);
+	force = Vector3f(0, 0, 0);
 
 	// check if we're at maximum depth
 	if (depth <= m_waterHeight - m_maxDepth)
 	{
 		force.y = m_liquidDensity * m_volume;
-		rigidbody->AddForce(force);
-		return;
+		return true;
 	}
 
 	// otherwise we are partly submerged
 	force.y = m_liquidDensity * m_volume * (depth - m_waterHeight - m_maxDepth) / 2 * m_maxDepth;
-	rigidbody->AddForce(force);
+	return true;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "Force/ForceDrag.hpp"
 #include "Particle.hpp"
 #include "Rigidbody.hpp"
+#include "ParticleStorage.hpp"
+#include "RigidbodyStorage.hpp"
 
 ForceDrag::ForceDrag(float k1, float k2) : 
 	m_k1(k1), 
@@ -8,40 +10,76 @@ ForceDrag::ForceDrag(float k1, float k2) :
 {
 };
 
-void ForceDrag::UpdateForce(std::shared_ptr<Particle> particle, float deltaTime)
+void ForceDrag::UpdateForce(Particle& particle, float deltaTime)
 {
-	float velocityLength = particle->velocity.GetLength();
-	if (velocityLength < 0.001f)
-		return;
+	Vector3f force;
+	if (CalculateForce(particle.GetVelocity(), particle.GetMass(), force))
+		particle.AddForce(force);
+}
 
-	if (particle->mass < 0.001f)
-		return;
-	
-	// calculate the total drag coefficient
-	float dragCoeff = velocityLength;
-	dragCoeff = m_k1 * dragCoeff + m_k2 * dragCoeff * dragCoeff;
+void ForceDrag::UpdateForce(Rigidbody& rigidbody, float deltaTime)
+{
+	Vector3f force;
+	if (CalculateForce(rigidbody.GetVelocity(), rigidbody.GetMass(), force))
+		rigidbody.AddForce(force);
+}
+
+void ForceDrag::UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, [[maybe_unused]] float deltaTime)
+{
+	const float* vx = particles.velocitiesX.data();
+	const float* vy = particles.velocitiesY.data();
+	const float* vz = particles.velocitiesZ.data();
+	float* fx = particles.forcesX.data();
+	float* fy = particles.forcesY.data();
+	float* fz = particles.forcesZ.data();
+	const float* masses = particles.masses.data();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		unsigned int index = indices[i];
+
+		Vector3f force;
+		if (!CalculateForce(Vector3f(vx[index], vy[index], vz[index]), masses[index], force))
+			continue;
+
+		fx[index] += force.x;
+		fy[index] += force.y;
+		fz[index] += force.z;
+	}
+}
+
+void ForceDrag::UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, [[maybe_unused]] float deltaTime)
+{
+	const Vector3f* velocities = rigidbodies.velocities.data();
+	Vector3f* forces = rigidbodies.forces.data();
+	const float* masses = rigidbodies.masses.data();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		unsigned int index = indices[i];
 
-	// calculate the force and apply it
-	Vector3f force = particle->velocity.GetNormalized() * -dragCoeff;
-	particle->AddForce(force);
+		Vector3f force;
+		if (CalculateForce(velocities[index], masses[index], force))
+			forces[index] += force;
+	}
 }
 
-void ForceDrag::UpdateForce(std::shared_ptr<Rigidbody> rigidbody, float deltaTime)
+bool ForceDrag::CalculateForce(const Vector3f& velocity, float mass, Vector3f& force) const
 {
-	float velocityLength = rigidbody->velocity.GetLength();
+	float velocityLength = velocity.GetLength();
 	if (velocityLength < 0.001f)
-		return;
+		return false;
 
-	if (rigidbody->mass < 0.001f)
-		return;
+	if (mass < 0.001f)
+		return false;
 
 	// calculate the total drag coefficient
 	float dragCoeff = velocityLength;
 	dragCoeff = m_k1 * dragCoeff + m_k2 * dragCoeff * dragCoeff;
 
-	// calculate the force and apply it
-	Vector3f force = rigidbody->velocity.GetNormalized() * -dragCoeff;
-	rigidbody->AddForce(force);
+	// calculate the force
+	force = velocity.GetNormalized() * -dragCoeff;
+	return true;
 }
 
 void ForceDrag::SetDragCoefficients(float k1, float k2)
@@ -0,0 +1,17 @@
+#include "Force/ForceGenerator.hpp"
+#include "Particle.hpp"
+#include "Rigidbody.hpp"
+#include "ParticleStorage.hpp"
+#include "RigidbodyStorage.hpp"
+
+void ForceGenerator::UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, float deltaTime)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		UpdateForce(*particles.GetParticle(indices[i]), deltaTime);
+}
+
+void ForceGenerator::UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, float deltaTime)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		UpdateForce(*rigidbodies.GetRigidbody(indices[i]), deltaTime);
+}
\ No newline at end of file
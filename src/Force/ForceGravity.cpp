@@ -1,13 +1,40 @@
 #include "Force/ForceGravity.hpp"
 #include "Particle.hpp"
 #include "Rigidbody.hpp"
+#include "ParticleStorage.hpp"
+#include "RigidbodyStorage.hpp"
 
-void ForceGravity::UpdateForce(std::shared_ptr<Particle> particle, float deltaTime)
+void ForceGravity::UpdateForce(Particle& particle, float deltaTime)
 {
-	particle->AddForce(m_gravity * particle->mass);
+	particle.AddForce(m_gravity * particle.GetMass());
 }
 
-void ForceGravity::UpdateForce(std::shared_ptr<Rigidbody> rigidbody, float deltaTime)
+void ForceGravity::UpdateForce(Rigidbody& rigidbody, float deltaTime)
 {
-	rigidbody->AddForce(m_gravity * rigidbody->mass);
+	rigidbody.AddForce(m_gravity * rigidbody.GetMass());
+}
+
+void ForceGravity::UpdateForces(ParticleStorage& particles, const unsigned int* indices, std::size_t count, [[maybe_unused]] float deltaTime)
+{
+	float* fx = particles.forcesX.data();
+	float* fy = particles.forcesY.data();
+	float* fz = particles.forcesZ.data();
+	const float* masses = particles.masses.data();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		unsigned int index = indices[i];
+		fx[index] += m_gravity.x * masses[index];
+		fy[index] += m_gravity.y * masses[index];
+		fz[index] += m_gravity.z * masses[index];
+	}
+}
+
+void ForceGravity::UpdateForces(RigidbodyStorage& rigidbodies, const unsigned int* indices, std::size_t count, [[maybe_unused]] float deltaTime)
+{
+	Vector3f* forces = rigidbodies.forces.data();
+	const float* masses = rigidbodies.masses.data();
+
+	for (std::size_t i = 0; i < count; ++i)
+		forces[indices[i]] += m_gravity * masses[indices[i]];
 }
\ No newline at end of file
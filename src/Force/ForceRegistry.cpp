@@ -1,55 +1,168 @@
+#include <algorithm>
+#include <typeinfo>
 #include "Force/ForceRegistry.hpp"
 #include "Force/ForceGenerator.hpp"
 #include "Particle.hpp"
+#include "Rigidbody.hpp"
+#include "ParticleStorage.hpp"
+#include "RigidbodyStorage.hpp"
 
 void ForceRegistry::Add(std::shared_ptr<Particle> particle, std::shared_ptr<ForceGenerator> fg)
 {
-	m_registry.push_back({ particle, fg });
+	GetBatch(m_registry, fg).bodies.push_back(particle->GetHandle());
 }
 
 void ForceRegistry::Add(std::shared_ptr<Rigidbody> rigidbody, std::shared_ptr<ForceGenerator> fg)
 {
-	m_registryRigidbody.push_back({ rigidbody, fg });
+	GetBatch(m_registryRigidbody, fg).bodies.push_back(rigidbody->GetHandle());
+}
+
+void ForceRegistry::Add(const std::shared_ptr<Particle>* particles, std::size_t count, std::shared_ptr<ForceGenerator> fg)
+{
+	Batch& batch = GetBatch(m_registry, fg);
+	batch.bodies.reserve(batch.bodies.size() + count);
+
+	for (std::size_t i = 0; i < count; ++i)
+		batch.bodies.push_back(particles[i]->GetHandle());
+}
+
+void ForceRegistry::Add(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count, std::shared_ptr<ForceGenerator> fg)
+{
+	Batch& batch = GetBatch(m_registryRigidbody, fg);
+	batch.bodies.reserve(batch.bodies.size() + count);
+
+	for (std::size_t i = 0; i < count; ++i)
+		batch.bodies.push_back(rigidbodies[i]->GetHandle());
 }
 
 void ForceRegistry::Remove(std::shared_ptr<Particle> particle, std::shared_ptr<ForceGenerator> fg)
 {
-	for (auto it = m_registry.begin(); it != m_registry.end(); ++it)
+	Remove(m_registry, particle->GetHandle(), fg);
+}
+
+void ForceRegistry::Remove(std::shared_ptr<Rigidbody> rigidbody, std::shared_ptr<ForceGenerator> fg)
+{
+	Remove(m_registryRigidbody, rigidbody->GetHandle(), fg);
+}
+
+void ForceRegistry::Remove(const std::shared_ptr<Particle>* particles, std::size_t count)
+{
+	std::vector<BodyHandle> handles = SortedHandles(particles, count);
+	Remove(m_registry, handles);
+}
+
+void ForceRegistry::Remove(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count)
+{
+	std::vector<BodyHandle> handles = SortedHandles(rigidbodies, count);
+	Remove(m_registryRigidbody, handles);
+}
+
+void ForceRegistry::Clear()
+{
+	m_registry.clear();
+	m_registryRigidbody.clear();
+}
+
+void ForceRegistry::UpdateForces(ParticleStorage& particles, RigidbodyStorage& rigidbodies, float deltaTime)
+{
+	UpdateForces(m_registry, particles, deltaTime);
+	UpdateForces(m_registryRigidbody, rigidbodies, deltaTime);
+}
+
+ForceRegistry::Batch& ForceRegistry::GetBatch(Registry& registry, const std::shared_ptr<ForceGenerator>& fg)
+{
+	for (Batch& batch : registry)
 	{
-		if (it->particle == particle && it->forceGenerator == fg)
-		{
-			m_registry.erase(it);
-			break;
-		}
+		if (batch.forceGenerator == fg)
+			return batch;
 	}
+
+	// Insert after the last batch of the same type, so the same code runs back to back
+	const ForceGenerator& generator = *fg;
+	auto position = registry.end();
+	for (auto it = registry.begin(); it != registry.end(); ++it)
+	{
+		const ForceGenerator& other = *it->forceGenerator;
+		if (typeid(other) == typeid(generator))
+			position = it + 1;
+	}
+
+	Batch batch;
+	batch.forceGenerator = fg;
+	return *registry.insert(position, std::move(batch));
 }
 
-void ForceRegistry::Remove(std::shared_ptr<Rigidbody> rigidbody, std::shared_ptr<ForceGenerator> fg)
+void ForceRegistry::Remove(Registry& registry, const BodyHandle& body, const std::shared_ptr<ForceGenerator>& fg)
 {
-	for (auto it = m_registryRigidbody.begin(); it != m_registryRigidbody.end(); ++it)
+	for (auto it = registry.begin(); it != registry.end(); ++it)
 	{
-		if (it->rigidbody == rigidbody && it->forceGenerator == fg)
+		if (it->forceGenerator != fg)
+			continue;
+
+		std::vector<BodyHandle>& bodies = it->bodies;
+		for (std::size_t i = 0; i < bodies.size(); ++i)
 		{
-			m_registryRigidbody.erase(it);
-			break;
+			if (bodies[i] == body)
+			{
+				SwapRemove(bodies, i);
+				break;
+			}
 		}
+
+		if (bodies.empty())
+			registry.erase(it);
+
+		return;
 	}
 }
 
-void ForceRegistry::Clear()
+void ForceRegistry::Remove(Registry& registry, const std::vector<BodyHandle>& handles)
 {
-	m_registry.clear();
+	for (Batch& batch : registry)
+	{
+		batch.bodies.erase(std::remove_if(batch.bodies.begin(), batch.bodies.end(), [&handles](const BodyHandle& body)
+			{
+				return std::binary_search(handles.begin(), handles.end(), body, &ForceRegistry::HandleLess);
+			}), batch.bodies.end());
+	}
+
+	registry.erase(std::remove_if(registry.begin(), registry.end(), [](const Batch& batch)
+		{
+			return batch.bodies.empty();
+		}), registry.end());
 }
 
-void ForceRegistry::UpdateForces(float deltaTime)
+template<typename Storage>
+void ForceRegistry::UpdateForces(Registry& registry, Storage& storage, float deltaTime)
 {
-	for (auto& entry : m_registry)
+	for (Batch& batch : registry)
 	{
-		entry.forceGenerator->UpdateForce(entry.particle, deltaTime);
-	}
+		// Bodies removed from the PhysicsSystem are skipped
+		batch.indices.clear();
+		for (const BodyHandle& body : batch.bodies)
+		{
+			unsigned int index = storage.GetIndex(body);
+			if (index != BodyHandle::InvalidIndex)
+				batch.indices.push_back(index);
+		}
 
-	for (auto& entry : m_registryRigidbody)
-	{
-		entry.forceGenerator->UpdateForce(entry.rigidbody, deltaTime);
+		if (!batch.indices.empty())
+			batch.forceGenerator->UpdateForces(storage, batch.indices.data(), batch.indices.size(), deltaTime);
 	}
+}
+
+bool ForceRegistry::HandleLess(const BodyHandle& a, const BodyHandle& b)
+{
+	return a.index != b.index ? a.index < b.index : a.generation < b.generation;
+}
+
+template<typename T>
+std::vector<BodyHandle> ForceRegistry::SortedHandles(const std::shared_ptr<T>* bodies, std::size_t count)
+{
+	std::vector<BodyHandle> handles(count);
+	for (std::size_t i = 0; i < count; ++i)
+		handles[i] = bodies[i]->GetHandle();
+
+	std::sort(handles.begin(), handles.end(), &ForceRegistry::HandleLess);
+	return handles;
 }
\ No newline at end of file
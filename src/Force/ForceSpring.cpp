@@ -32,13 +32,13 @@ ForceSpring::ForceSpring(std::shared_ptr<Rigidbody> otherEnd, Vector3f connectio
 {
 }
 
-void ForceSpring::UpdateForce(std::shared_ptr<Particle> particle, float deltaTime)
+void ForceSpring::UpdateForce(Particle& particle, float deltaTime)
 {
-	if (particle->mass < 1.0f)
+	if (particle.GetMass() < 1.0f)
 		return;
 
 	// Calculate the vector of the spring
-	Vector3f force = m_otherParticle->position - particle->position;
+	Vector3f force = m_otherParticle->GetPosition() - particle.GetPosition();
 
 	// Calculate the magnitude of the spring
 	float displacement = force.GetLength() - m_restLength;
@@ -49,17 +49,17 @@ void ForceSpring::UpdateForce(std::shared_ptr<Particle> particle, float deltaTim
 	force *= -magnitude;
 
 	// Apply the force to both particles
-	particle->AddForce(force);
+	particle.AddForce(force);
 	m_otherParticle->AddForce(force.GetInvert());  // Opposite force applied to the other particle
 }
 
-void ForceSpring::UpdateForce(std::shared_ptr<Rigidbody> rigidbody, float deltaTime)
+void ForceSpring::UpdateForce(Rigidbody& rigidbody, float deltaTime)
 {
-	if (rigidbody->mass < 1.0f)
+	if (rigidbody.GetMass() < 1.0f)
 		return;
 
 	// Calculate local to world space points
-	Vector3f localInWorldSpace = rigidbody->GetPointInWorldSpace(connectionPoint);
+	Vector3f localInWorldSpace = rigidbody.GetPointInWorldSpace(connectionPoint);
 	Vector3f otherInWorldSpace = m_otherRigidbody->GetPointInWorldSpace(otherConnectionPoint);
 
 	// Calculate the force of the spring
@@ -74,7 +74,7 @@ void ForceSpring::UpdateForce(std::shared_ptr<Rigidbody> rigidbody, float deltaT
 	force.Normalize();
 	force *= -magnitude;
 
-	rigidbody->AddForceAtPoint(force, localInWorldSpace);
+	rigidbody.AddForceAtPoint(force, localInWorldSpace);
 	m_otherRigidbody->AddForceAtPoint(force.GetInvert(), otherInWorldSpace); // Opposite force applied to the other connection point
 }
 
@@ -1,65 +1,157 @@
 #include "Particle.hpp"
+#include "ParticleStorage.hpp"
 #include "Constants/PhysicConstants.hpp"
 
 Particle::Particle() 
 	: 
 	name(std::string("Particle")),
-	position(Vector3f::Zero),
-	velocity(Vector3f::Zero),
+	m_mass(MIN_MASS),
 	m_acceleration(Vector3f::Zero),
-	mass(MIN_MASS),
-	force(Vector3f::Zero)
+	m_state(Vector3f::Zero, 1.0f / MIN_MASS)
 {
 }
 
 Particle::Particle(std::string name) :
 	name(name),
-	position(Vector3f::Zero),
-	velocity(Vector3f::Zero),
+	m_mass(MIN_MASS),
 	m_acceleration(Vector3f::Zero),
-	mass(MIN_MASS),
-	force(Vector3f::Zero)
+	m_state(Vector3f::Zero, 1.0f / MIN_MASS)
 {
 }
 
 Particle::Particle(std::string name, Vector3f position) :
 	name(name),
-	position(position),
-	velocity(Vector3f::Zero),
+	m_mass(MIN_MASS),
 	m_acceleration(Vector3f::Zero),
-	mass(MIN_MASS),
-	force(Vector3f::Zero)
+	m_state(position, 1.0f / MIN_MASS)
 {
 }
 
 Particle::Particle(std::string name, Vector3f position, float mass) :
 	name(name),
-	position(position),
-	velocity(Vector3f::Zero),
+	m_mass(mass > MIN_MASS ? mass : MIN_MASS),
 	m_acceleration(Vector3f::Zero),
-	mass(mass > MIN_MASS ? mass : MIN_MASS),
-	force(Vector3f::Zero)
+	m_state(position, 1.0f / m_mass)
 {
 }
 
+Particle::Particle(const Particle& particle) :
+	name(particle.name),
+	m_mass(particle.GetMass()),
+	m_acceleration(particle.m_acceleration),
+	m_state(particle.GetPosition(), particle.GetInverseMass())
+{
+	m_state.velocity = particle.GetVelocity();
+	m_state.force = particle.GetForce();
+}
+
+Particle::~Particle()
+{
+	if (m_storage != nullptr)
+		m_storage->Remove(m_handle);
+}
+
+Particle& Particle::operator=(const Particle& particle)
+{
+	// Only the physical values are copied, the particle keeps its own place in a storage
+	name = particle.name;
+	m_acceleration = particle.m_acceleration;
+	SetMass(particle.GetMass());
+	SetPosition(particle.GetPosition());
+	SetVelocity(particle.GetVelocity());
+	ClearForce();
+	AddForce(particle.GetForce());
+
+	return *this;
+}
+
+Vector3f Particle::GetPosition() const
+{
+	return m_storage ? m_storage->GetPosition(m_storageIndex) : m_state.position;
+}
+
+void Particle::SetPosition(const Vector3f& position)
+{
+	if (m_storage)
+		m_storage->SetPosition(m_storageIndex, position);
+	else
+		m_state.position = position;
+}
+
+Vector3f Particle::GetVelocity() const
+{
+	return m_storage ? m_storage->GetVelocity(m_storageIndex) : m_state.velocity;
+}
+
+void Particle::SetVelocity(const Vector3f& velocity)
+{
+	if (m_storage)
+		m_storage->SetVelocity(m_storageIndex, velocity);
+	else
+		m_state.velocity = velocity;
+}
+
+Vector3f Particle::GetForce() const
+{
+	return m_storage ? m_storage->GetForce(m_storageIndex) : m_state.force;
+}
+
+float Particle::GetMass() const
+{
+	return m_storage ? m_storage->masses[m_storageIndex] : m_mass;
+}
+
+void Particle::SetMass(float mass)
+{
+	m_mass = mass > MIN_MASS ? mass : MIN_MASS;
+
+	if (m_storage)
+	{
+		m_storage->masses[m_storageIndex] = m_mass;
+		m_storage->inverseMasses[m_storageIndex] = 1.0f / m_mass;
+	}
+	else
+		m_state.inverseMass = 1.0f / m_mass;
+}
+
+float Particle::GetInverseMass() const
+{
+	return m_storage ? m_storage->inverseMasses[m_storageIndex] : m_state.inverseMass;
+}
+
 void Particle::ClearForce()
 {
-	force = Vector3f::Zero;
+	if (m_storage)
+	{
+		m_storage->forcesX[m_storageIndex] = 0.0f;
+		m_storage->forcesY[m_storageIndex] = 0.0f;
+		m_storage->forcesZ[m_storageIndex] = 0.0f;
+	}
+	else
+		m_state.force = Vector3f::Zero;
 }
 
 void Particle::AddForce(const Vector3f& f)
 {
-	force += f;
+	if (m_storage)
+		m_storage->AddForce(m_storageIndex, f);
+	else
+		m_state.force += f;
 }
 
 Vector3f const Particle::GetAcceleration()
 {
-	m_acceleration = force / mass;
+	m_acceleration = GetForce() * GetInverseMass();
 	return m_acceleration;
 }
 
+BodyHandle Particle::GetHandle() const
+{
+	return m_handle;
+}
+
 Vector3f Particle::SetAcceleration(const Vector3f& acceleration)
 {
 	m_acceleration = acceleration;
 	return m_acceleration;
-}
\ No newline at end of file
+}
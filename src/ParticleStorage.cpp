@@ -0,0 +1,225 @@
+#include <algorithm>
+#include "ParticleStorage.hpp"
+#include "Particle.hpp"
+
+ParticleState::ParticleState(const Vector3f& position, float inverseMass) :
+	position(position),
+	velocity(Vector3f::Zero),
+	force(Vector3f::Zero),
+	inverseMass(inverseMass)
+{
+}
+
+ParticleStorage::~ParticleStorage()
+{
+	Clear();
+}
+
+BodyHandle ParticleStorage::Add(Particle* particle)
+{
+	unsigned int index = static_cast<unsigned int>(m_particles.size());
+	BodyHandle handle = m_handleTable.Create(index);
+	const ParticleState& state = particle->m_state;
+
+	positionsX.push_back(state.position.x);
+	positionsY.push_back(state.position.y);
+	positionsZ.push_back(state.position.z);
+	velocitiesX.push_back(state.velocity.x);
+	velocitiesY.push_back(state.velocity.y);
+	velocitiesZ.push_back(state.velocity.z);
+	forcesX.push_back(state.force.x);
+	forcesY.push_back(state.force.y);
+	forcesZ.push_back(state.force.z);
+	inverseMasses.push_back(state.inverseMass);
+	masses.push_back(particle->m_mass);
+	m_particles.push_back(particle);
+	m_handles.push_back(handle);
+
+	particle->m_storage = this;
+	particle->m_storageIndex = index;
+	particle->m_handle = handle;
+
+	return handle;
+}
+
+void ParticleStorage::Remove(const BodyHandle& handle)
+{
+	unsigned int index = m_handleTable.GetDenseIndex(handle);
+	if (index == BodyHandle::InvalidIndex)
+		return;
+
+	Detach(index);
+	m_handleTable.Destroy(handle);
+
+	SwapRemove(positionsX, index);
+	SwapRemove(positionsY, index);
+	SwapRemove(positionsZ, index);
+	SwapRemove(velocitiesX, index);
+	SwapRemove(velocitiesY, index);
+	SwapRemove(velocitiesZ, index);
+	SwapRemove(forcesX, index);
+	SwapRemove(forcesY, index);
+	SwapRemove(forcesZ, index);
+	SwapRemove(inverseMasses, index);
+	SwapRemove(masses, index);
+	SwapRemove(m_particles, index);
+	SwapRemove(m_handles, index);
+
+	// The last particle took the slot of the removed one
+	if (index < m_particles.size())
+	{
+		m_particles[index]->m_storageIndex = index;
+		m_handleTable.SetDenseIndex(m_handles[index], index);
+	}
+}
+
+void ParticleStorage::Remove(const BodyHandle* handles, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		Remove(handles[i]);
+}
+
+void ParticleStorage::Clear()
+{
+	for (unsigned int i = 0; i < m_particles.size(); ++i)
+		Detach(i);
+
+	positionsX.clear();
+	positionsY.clear();
+	positionsZ.clear();
+	velocitiesX.clear();
+	velocitiesY.clear();
+	velocitiesZ.clear();
+	forcesX.clear();
+	forcesY.clear();
+	forcesZ.clear();
+	inverseMasses.clear();
+	masses.clear();
+	m_particles.clear();
+	m_handles.clear();
+	m_handleTable.Clear();
+}
+
+void ParticleStorage::Reserve(std::size_t capacity)
+{
+	positionsX.reserve(capacity);
+	positionsY.reserve(capacity);
+	positionsZ.reserve(capacity);
+	velocitiesX.reserve(capacity);
+	velocitiesY.reserve(capacity);
+	velocitiesZ.reserve(capacity);
+	forcesX.reserve(capacity);
+	forcesY.reserve(capacity);
+	forcesZ.reserve(capacity);
+	inverseMasses.reserve(capacity);
+	masses.reserve(capacity);
+	m_particles.reserve(capacity);
+	m_handles.reserve(capacity);
+	m_handleTable.Reserve(capacity);
+}
+
+std::size_t ParticleStorage::GetSize() const
+{
+	return m_particles.size();
+}
+
+bool ParticleStorage::IsValid(const BodyHandle& handle) const
+{
+	return m_handleTable.IsAlive(handle);
+}
+
+unsigned int ParticleStorage::GetIndex(const BodyHandle& handle) const
+{
+	return m_handleTable.GetDenseIndex(handle);
+}
+
+Particle* ParticleStorage::GetParticle(const BodyHandle& handle) const
+{
+	unsigned int index = m_handleTable.GetDenseIndex(handle);
+	return index != BodyHandle::InvalidIndex ? m_particles[index] : nullptr;
+}
+
+Particle* ParticleStorage::GetParticle(unsigned int index) const
+{
+	return m_particles[index];
+}
+
+Vector3f ParticleStorage::GetPosition(unsigned int index) const
+{
+	return Vector3f(positionsX[index], positionsY[index], positionsZ[index]);
+}
+
+void ParticleStorage::SetPosition(unsigned int index, const Vector3f& position)
+{
+	positionsX[index] = position.x;
+	positionsY[index] = position.y;
+	positionsZ[index] = position.z;
+}
+
+Vector3f ParticleStorage::GetVelocity(unsigned int index) const
+{
+	return Vector3f(velocitiesX[index], velocitiesY[index], velocitiesZ[index]);
+}
+
+void ParticleStorage::SetVelocity(unsigned int index, const Vector3f& velocity)
+{
+	velocitiesX[index] = velocity.x;
+	velocitiesY[index] = velocity.y;
+	velocitiesZ[index] = velocity.z;
+}
+
+Vector3f ParticleStorage::GetForce(unsigned int index) const
+{
+	return Vector3f(forcesX[index], forcesY[index], forcesZ[index]);
+}
+
+void ParticleStorage::AddForce(unsigned int index, const Vector3f& force)
+{
+	forcesX[index] += force.x;
+	forcesY[index] += force.y;
+	forcesZ[index] += force.z;
+}
+
+void ParticleStorage::ClearAccumulators()
+{
+	std::fill(forcesX.begin(), forcesX.end(), 0.0f);
+	std::fill(forcesY.begin(), forcesY.end(), 0.0f);
+	std::fill(forcesZ.begin(), forcesZ.end(), 0.0f);
+}
+
+void ParticleStorage::WriteSnapshot(std::vector<Vector3f>& positions) const
+{
+	positions.resize(m_particles.size());
+	WriteSnapshot(positions.data(), 0, m_particles.size());
+}
+
+void ParticleStorage::WriteSnapshot(Vector3f* positions, std::size_t begin, std::size_t end) const
+{
+	const float* x = positionsX.data();
+	const float* y = positionsY.data();
+	const float* z = positionsZ.data();
+
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		positions[i].x = x[i];
+		positions[i].y = y[i];
+		positions[i].z = z[i];
+	}
+}
+
+void ParticleStorage::Detach(unsigned int index)
+{
+	// Give the particle back its own copy of the state so it stays usable outside of the storage
+	Particle* particle = m_particles[index];
+	ParticleState& state = particle->m_state;
+
+	state.position = GetPosition(index);
+	state.velocity = GetVelocity(index);
+	state.force = GetForce(index);
+	state.inverseMass = inverseMasses[index];
+	particle->m_mass = masses[index];
+
+	particle->m_storage = nullptr;
+	particle->m_storageIndex = 0;
+	particle->m_handle = BodyHandle();
+}
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <algorithm>
 #include <map>
 #include <vector>
 #include <memory>
@@ -7,51 +8,64 @@
 #include "Particle.hpp"
 #include "Rigidbody.hpp"
 
-#include "Collision/BVHNode.hpp"
+#include "Collision/BVH.hpp"
 #include "Collision/BoundingSphere.hpp"
 #include "Collision/BoundingBox.hpp"
-#include "Collision/BVHNode.hpp"
 
 #include "Collision/ContactGenerator.hpp"
 #include "Collision/ContactResolver.hpp"
+#include "Collision/PairCache.hpp"
 
 #include "Collision/Primitives/Primitive.hpp"
 #include "Collision/Primitives/Sphere.hpp"
 #include "Collision/Primitives/Box.hpp"
 #include "Collision/Primitives/Plane.hpp"
 
+#include "Contact/ParticleSpatialHash.hpp"
+
 #include "State.hpp"
+#include "AllocationCounter.hpp"
 
 PhysicsSystem::PhysicsSystem(std::shared_ptr<ForceRegistry> forceRegistry) :
+	m_particleStorage(std::make_unique<ParticleStorage>()),
+	m_rigidbodyStorage(std::make_unique<RigidbodyStorage>()),
 	m_forceRegistry(forceRegistry),
 	m_integrator(std::make_unique<EulerIntegrator>()),
-	m_contactGenerator(std::make_unique<ContactGenerator>(50)),
-	m_contactResolver(std::make_unique<ContactResolver>(50)),
+	m_particleContactResolver(std::make_unique<ParticleContactResolver>(2)),
+	m_potentialContact(64),
 	m_potentialContactCount(0),
-	m_potentialContactPrimitiveCount(0)
+	m_isPotentialContactTruncated(false),
+	m_potentialContactPrimitive(64),
+	m_potentialContactPrimitiveCount(0),
+	m_isPotentialContactPrimitiveTruncated(false),
+	m_maxPotentialContacts(1 << 20),
+	m_pairCache(std::make_unique<PairCache>()),
+	m_isContactTruncated(false),
+	m_stepAllocationCount(0),
+	m_contactGenerator(std::make_unique<ContactGenerator>(50, *m_rigidbodyStorage)),
+	m_contactResolver(std::make_unique<ContactResolver>(50, *m_rigidbodyStorage))
 {
-	m_potentialContact = new PotentialContact();
-	m_potentialContactPrimitive = new PotentialContactPrimitive();
 }
 
 PhysicsSystem::~PhysicsSystem()
 {
-	if(m_potentialContact)
-		delete(m_potentialContact);
-	if(m_potentialContactPrimitive)
-		delete(m_potentialContactPrimitive);
 }
 
 void PhysicsSystem::Update(State& current, float deltaTime, bool isGravityEnabled, bool hasToDetectBroadPhase, bool hasToDetectNarrowPhase, bool hasToResolveContact)
 {
+	const std::size_t allocationCount = AllocationCounter::GetCount();
+
 	// Clear les forces des particles et rigidbodies
 	ClearForces();
 
 	// Mise  jour des forces
-	m_forceRegistry->UpdateForces(deltaTime);
+	m_forceRegistry->UpdateForces(*m_particleStorage, *m_rigidbodyStorage, deltaTime);
 
 	// Mise  jour des particules
-	m_integrator->Update(current, m_particles, m_rigidbodies, deltaTime, isGravityEnabled);	
+	m_integrator->Update(current, *m_particleStorage, *m_rigidbodyStorage, deltaTime, isGravityEnabled);	
+
+	// Collisions entre particules
+	ParticleCollisionDetection(deltaTime);
 
 	// Rsolution des collisions
 	if (hasToDetectBroadPhase)
@@ -64,206 +78,271 @@ void PhysicsSystem::Update(State& current, float deltaTime, bool isGravityEnable
 	}
 	if(hasToResolveContact)
 	{
-		m_contactResolver->ResolveContacts(m_contactGenerator->GetContacts(), deltaTime, current);
+		m_contactResolver->ResolveContacts(m_contactGenerator->GetContacts(), m_contactGenerator->GetCurrentContacts(), deltaTime, current);
+		if (hasToDetectNarrowPhase)
+			StoreContactImpulses();
+		m_contactGenerator->Reset();
 	}
 
+	m_stepAllocationCount = AllocationCounter::GetCount() - allocationCount;
 }
 
 void PhysicsSystem::ClearForces()
 {
-	for (auto& particle : m_particles)
-	{
-		particle->ClearForce();
-	}
-	for (auto& rigidbody : m_rigidbodies)
-	{
-		rigidbody->ClearForce();
-		rigidbody->ClearTorque();
-	}
+	m_particleStorage->ClearAccumulators();
+	m_rigidbodyStorage->ClearAccumulators();
 }
 
-void PhysicsSystem::AddRootBVHNode(std::shared_ptr<BVHNode> node)
+void PhysicsSystem::SetThreadCount(unsigned int threadCount)
 {
-	m_rootBVHNode = node;
+	m_integrator->SetThreadCount(threadCount);
 }
 
-void PhysicsSystem::BroadPhaseCollisionDetection()
+unsigned int PhysicsSystem::GetThreadCount() const
 {
-	m_rootBVHNode->RecalculateBoundingVolume();
-	m_potentialContactCount = m_rootBVHNode->GetPotentialContact(m_potentialContact, 1000);
-	m_potentialContactPrimitiveCount = m_rootBVHNode->GetPotentialContactPrimitive(m_potentialContactPrimitive, 1000);
-	ParsePotentialContacts();
-	ParsePotentialContactsPrimitive();
+	return m_integrator->GetThreadCount();
 }
 
-void PhysicsSystem::NarrowPhaseCollisionDetection()
+void PhysicsSystem::SetBroadPhase(std::shared_ptr<BroadPhase> broadPhase)
 {
-	for (unsigned int i = 0; i < m_potentialContactPrimitiveCount; i++)
-	{
-		PrimitiveType type1 = m_potentialContactPrimitive[i].primitives[0]->GetType();
-		PrimitiveType type2 = m_potentialContactPrimitive[i].primitives[1]->GetType();
+	m_broadPhase = broadPhase;
+}
 
-		if (type1 == PrimitiveType::TypeSphere && type2 == PrimitiveType::TypeSphere)
-		{
-			std::shared_ptr<Sphere> sphere1 = std::dynamic_pointer_cast<Sphere>(m_potentialContactPrimitive[i].primitives[0]);
-			std::shared_ptr<Sphere> sphere2 = std::dynamic_pointer_cast<Sphere>(m_potentialContactPrimitive[i].primitives[1]);
-			
-			Sphere sphereA = *sphere1;
-			Sphere sphereB = *sphere2;
+void PhysicsSystem::SetParticleSpatialHash(std::shared_ptr<ParticleSpatialHash> spatialHash)
+{
+	m_particleSpatialHash = spatialHash;
+}
 
-			m_contactGenerator->DetectSandS(sphereA, sphereB);
+unsigned int PhysicsSystem::GetParticleContactCount() const
+{
+	return m_particleSpatialHash ? m_particleSpatialHash->GetContactCount() : 0;
+}
 
-			std::cout << "Sphere - Sphere" << std::endl;
-			std::cout << "Sphere 1: " << sphere1->rigidbody->name << std::endl;
-			std::cout << "Sphere 2: " << sphere2->rigidbody->name << std::endl;
-		}
-		else if (type1 == PrimitiveType::TypeSphere && type2 == PrimitiveType::TypeBox)
-		{
-			std::shared_ptr<Sphere> sphere = std::dynamic_pointer_cast<Sphere>(m_potentialContactPrimitive[i].primitives[0]);
-			std::shared_ptr<Box> box = std::dynamic_pointer_cast<Box>(m_potentialContactPrimitive[i].primitives[1]);
+void PhysicsSystem::ParticleCollisionDetection(float deltaTime)
+{
+	if (m_particleSpatialHash == nullptr)
+		return;
 
-			Sphere sphereA = *sphere;
-			Box boxB = *box;
+	unsigned int contactCount = m_particleSpatialHash->GenerateContacts(*m_particleStorage);
+	m_particleContactResolver->ResolveContacts(m_particleSpatialHash->GetContacts(), contactCount, deltaTime);
+}
 
-			m_contactGenerator->DetectSandB(sphereA, boxB);
+void PhysicsSystem::BroadPhaseCollisionDetection()
+{
+	if (m_broadPhase == nullptr)
+		return;
 
-			std::cout << "Sphere - Box" << std::endl;
-			std::cout << "Sphere: " << sphere->rigidbody->name << std::endl;
-			std::cout << "Box: " << box->rigidbody->name << std::endl;
-		}
-		else if (type1 == PrimitiveType::TypeBox && type2 == PrimitiveType::TypeSphere)
-		{
-			std::shared_ptr<Sphere> sphere = std::dynamic_pointer_cast<Sphere>(m_potentialContactPrimitive[i].primitives[1]);
-			std::shared_ptr<Box> box = std::dynamic_pointer_cast<Box>(m_potentialContactPrimitive[i].primitives[0]);
-			
-			Sphere sphereA = *sphere;
-			Box boxB = *box;
-
-			m_contactGenerator->DetectSandB(sphereA, boxB);
-			
-			std::cout << "Box - Sphere" << std::endl;
-			std::cout << "Sphere: " << sphere->rigidbody->name << std::endl;
-			std::cout << "Box: " << box->rigidbody->name << std::endl;
-		}
-		else if (type1 == PrimitiveType::TypeSphere && type2 == PrimitiveType::TypePlane)
-		{
-			std::shared_ptr<Sphere> sphere = std::dynamic_pointer_cast<Sphere>(m_potentialContactPrimitive[i].primitives[0]);
-			std::shared_ptr<Plane> plane = std::dynamic_pointer_cast<Plane>(m_potentialContactPrimitive[i].primitives[1]);
+	m_broadPhase->Update(*m_rigidbodyStorage);
+
+	// A full buffer is doubled and the pairs queried again, so the buffers stop growing once they fit the scene
+	m_potentialContactCount = m_broadPhase->GetPotentialContact(m_potentialContact.data(), static_cast<unsigned int>(m_potentialContact.size()));
+	while (m_broadPhase->IsTruncated() && m_potentialContact.size() < m_maxPotentialContacts)
+	{
+		m_potentialContact.resize(std::min<std::size_t>(m_potentialContact.size() * 2, m_maxPotentialContacts));
+		m_potentialContactCount = m_broadPhase->GetPotentialContact(m_potentialContact.data(), static_cast<unsigned int>(m_potentialContact.size()));
+	}
+	m_isPotentialContactTruncated = m_broadPhase->IsTruncated();
 
-			Sphere sphereA = *sphere;
-			Plane planeB = *plane;
+	m_potentialContactPrimitiveCount = m_broadPhase->GetPotentialContactPrimitive(m_potentialContactPrimitive.data(), static_cast<unsigned int>(m_potentialContactPrimitive.size()));
+	while (m_broadPhase->IsTruncated() && m_potentialContactPrimitive.size() < m_maxPotentialContacts)
+	{
+		m_potentialContactPrimitive.resize(std::min<std::size_t>(m_potentialContactPrimitive.size() * 2, m_maxPotentialContacts));
+		m_potentialContactPrimitiveCount = m_broadPhase->GetPotentialContactPrimitive(m_potentialContactPrimitive.data(), static_cast<unsigned int>(m_potentialContactPrimitive.size()));
+	}
+	m_isPotentialContactPrimitiveTruncated = m_broadPhase->IsTruncated();
 
-			m_contactGenerator->DetectSandP(sphereA, planeB);
+	m_pairCache->Update(m_potentialContactPrimitive.data(), m_potentialContactPrimitiveCount);
+}
 
-			std::cout << "Sphere - Plane" << std::endl;
-			std::cout << "Sphere: " << sphere->rigidbody->name << std::endl;
-			std::cout << "Plane: " << plane->rigidbody->name << std::endl;
-		}
-		else if (type1 == PrimitiveType::TypePlane && type2 == PrimitiveType::TypeSphere)
+void PhysicsSystem::NarrowPhaseCollisionDetection()
+{
+	CachedPair* pairs = m_pairCache->GetPairs();
+	m_spherePairs.clear();
+	m_spherePlanePairs.clear();
+
+	for (unsigned int i = 0; i < m_pairCache->GetPairCount(); i++)
+	{
+		CachedPair& pair = pairs[i];
+
+		// Neither the integrator nor the solver moves the bodies, the pair needs no contact this step
+		if (!CanMove(pair.primitives[0]->body) && !CanMove(pair.primitives[1]->body))
+			continue;
+
+		// Spheres against spheres and planes are tested together once every pair is sorted
+		const PrimitiveType typeA = pair.primitives[0]->type;
+		const PrimitiveType typeB = pair.primitives[1]->type;
+		if (typeA == TypeSphere && typeB == TypeSphere)
 		{
-			std::shared_ptr<Sphere> sphere = std::dynamic_pointer_cast<Sphere>(m_potentialContactPrimitive[i].primitives[1]);
-			std::shared_ptr<Plane> plane = std::dynamic_pointer_cast<Plane>(m_potentialContactPrimitive[i].primitives[0]);
-			
-			Sphere sphereA = *sphere;
-			Plane planeB = *plane;
-
-			m_contactGenerator->DetectSandP(sphereA, planeB);
-			
-			std::cout << "Plane - Sphere" << std::endl;
-			std::cout << "Sphere: " << sphere->rigidbody->name << std::endl;
-			std::cout << "Plane: " << plane->rigidbody->name << std::endl;
+			m_spherePairs.push_back({ static_cast<const Sphere*>(pair.primitives[0]), static_cast<const Sphere*>(pair.primitives[1]), &pair });
+			continue;
 		}
-		else if (type1 == PrimitiveType::TypeBox && type2 == PrimitiveType::TypeBox)
+		if (typeA == TypeSphere && typeB == TypePlane)
 		{
-			std::shared_ptr<Box> box1 = std::dynamic_pointer_cast<Box>(m_potentialContactPrimitive[i].primitives[0]);
-			std::shared_ptr<Box> box2 = std::dynamic_pointer_cast<Box>(m_potentialContactPrimitive[i].primitives[1]);
-			
-			Box boxA = *box1;
-			Box boxB = *box2;
-
-			m_contactGenerator->DetectBandB(boxA, boxB);
-			
-			std::cout << "Box - Box" << std::endl;
-			std::cout << "Box 1: " << box1->rigidbody->name << std::endl;
-			std::cout << "Box 2: " << box2->rigidbody->name << std::endl;
+			m_spherePlanePairs.push_back({ static_cast<const Sphere*>(pair.primitives[0]), static_cast<const Plane*>(pair.primitives[1]), &pair });
+			continue;
 		}
-		else if (type1 == PrimitiveType::TypeBox && type2 == PrimitiveType::TypePlane)
+		if (typeA == TypePlane && typeB == TypeSphere)
 		{
-			std::shared_ptr<Box> box = std::dynamic_pointer_cast<Box>(m_potentialContactPrimitive[i].primitives[0]);
-			std::shared_ptr<Plane> plane = std::dynamic_pointer_cast<Plane>(m_potentialContactPrimitive[i].primitives[1]);
-			
-			Box boxA = *box;
-			Plane planeB = *plane;
-
-			m_contactGenerator->DetectBandP(boxA, planeB);
-			
-			std::cout << "Box - Plane" << std::endl;
-			std::cout << "Box: " << box->rigidbody->name << std::endl;
-			std::cout << "Plane: " << plane->rigidbody->name << std::endl;
+			m_spherePlanePairs.push_back({ static_cast<const Sphere*>(pair.primitives[1]), static_cast<const Plane*>(pair.primitives[0]), &pair });
+			continue;
 		}
-		else if (type1 == PrimitiveType::TypePlane && type2 == PrimitiveType::TypeBox)
-		{
-			std::shared_ptr<Box> box = std::dynamic_pointer_cast<Box>(m_potentialContactPrimitive[i].primitives[1]);
-			std::shared_ptr<Plane> plane = std::dynamic_pointer_cast<Plane>(m_potentialContactPrimitive[i].primitives[0]);
 
-			Box boxA = *box;
-			Plane planeB = *plane;
+		const unsigned int contactCount = m_contactGenerator->GetCurrentContacts();
+		m_contactGenerator->Detect(*pair.primitives[0], *pair.primitives[1], &pair);
 
-			m_contactGenerator->DetectBandP(boxA, planeB);
+		const unsigned int keptCount = UpdatePairContacts(pair, contactCount, m_contactGenerator->GetCurrentContacts() - contactCount);
+		m_contactGenerator->SetCurrentContacts(contactCount + keptCount);
+	}
 
-			std::cout << "Plane - Box" << std::endl;
-			std::cout << "Box: " << box->rigidbody->name << std::endl;
-			std::cout << "Plane: " << plane->rigidbody->name << std::endl;
-		}
+	// A sphere pair has at most one contact, which its manifold always keeps
+	m_hitPairs.resize(std::max(m_hitPairs.size(), std::max(m_spherePairs.size(), m_spherePlanePairs.size())));
+
+	unsigned int firstContact = m_contactGenerator->GetCurrentContacts();
+	unsigned int hitCount = m_contactGenerator->DetectSandSBatch(m_spherePairs.data(), static_cast<unsigned int>(m_spherePairs.size()), m_hitPairs.data());
+	for (unsigned int i = 0, hit = 0; i < m_spherePairs.size(); i++)
+	{
+		const bool isTouching = hit < hitCount && m_hitPairs[hit] == i;
+		UpdatePairContacts(*m_spherePairs[i].pair, firstContact + hit, isTouching ? 1 : 0);
+		hit += isTouching ? 1 : 0;
+	}
+
+	firstContact = m_contactGenerator->GetCurrentContacts();
+	hitCount = m_contactGenerator->DetectSandPBatch(m_spherePlanePairs.data(), static_cast<unsigned int>(m_spherePlanePairs.size()), m_hitPairs.data());
+	for (unsigned int i = 0, hit = 0; i < m_spherePlanePairs.size(); i++)
+	{
+		const bool isTouching = hit < hitCount && m_hitPairs[hit] == i;
+		UpdatePairContacts(*m_spherePlanePairs[i].pair, firstContact + hit, isTouching ? 1 : 0);
+		hit += isTouching ? 1 : 0;
 	}
+
+	m_isContactTruncated = m_contactGenerator->IsTruncated();
 }
 
-void PhysicsSystem::AddParticle(std::shared_ptr<Particle> particle)
+unsigned int PhysicsSystem::UpdatePairContacts(CachedPair& pair, unsigned int firstContact, unsigned int contactCount)
 {
+	// The pair keeps at most four of its contacts, matched with the points of its last test
+	const unsigned int keptCount = pair.manifold.Update(m_contactGenerator->GetContacts() + firstContact, contactCount, *m_rigidbodyStorage);
+
+	pair.testedStep = m_pairCache->GetStep();
+	pair.firstContact = firstContact;
+	pair.contactCount = keptCount;
+
+	return keptCount;
+}
+
+BodyHandle PhysicsSystem::AddParticle(std::shared_ptr<Particle> particle)
+{
+	if (particle->GetHandle().IsValid())
+		return particle->GetHandle();
+
 	m_particles.push_back(particle);
-	std::cout << particle->position << std::endl;
+	return m_particleStorage->Add(particle.get());
 }
 
-void PhysicsSystem::RemoveParticle(std::shared_ptr<Particle> particle)
+void PhysicsSystem::AddParticles(const std::shared_ptr<Particle>* particles, std::size_t count, BodyHandle* handles /*= nullptr*/)
 {
-	for (auto it = m_particles.begin(); it != m_particles.end(); ++it)
+	ReserveParticles(m_particles.size() + count);
+
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		if (*it == particle)
-		{
-			m_particles.erase(it);
-			return;
-		}
+		BodyHandle handle = AddParticle(particles[i]);
+		if (handles != nullptr)
+			handles[i] = handle;
 	}
 }
 
-void PhysicsSystem::AddRigidbody(std::shared_ptr<Rigidbody> rigidbody)
+void PhysicsSystem::RemoveParticle(std::shared_ptr<Particle> particle)
+{
+	// m_particles follows the storage order, the storage index finds the particle without searching
+	unsigned int index = m_particleStorage->GetIndex(particle->GetHandle());
+	if (index == BodyHandle::InvalidIndex || m_particles[index] != particle)
+		return;
+
+	m_particleStorage->Remove(particle->GetHandle());
+	SwapRemove(m_particles, index);
+}
+
+void PhysicsSystem::RemoveParticles(const std::shared_ptr<Particle>* particles, std::size_t count)
 {
+	for (std::size_t i = 0; i < count; ++i)
+		RemoveParticle(particles[i]);
+}
+
+void PhysicsSystem::ReserveParticles(std::size_t capacity)
+{
+	// Grow geometrically so repeated bulk adds of a few particles stay amortized
+	if (capacity <= m_particles.capacity())
+		return;
+
+	capacity = std::max(capacity, m_particles.capacity() * 2);
+	m_particles.reserve(capacity);
+	m_particleStorage->Reserve(capacity);
+}
+
+BodyHandle PhysicsSystem::AddRigidbody(std::shared_ptr<Rigidbody> rigidbody)
+{
+	if (rigidbody->IsInStorage())
+		return rigidbody->GetHandle();
+
 	m_rigidbodies.push_back(rigidbody);
+	return m_rigidbodyStorage->Add(rigidbody.get());
 }
 
-void PhysicsSystem::RemoveRigidbody(std::shared_ptr<Rigidbody> rigidbody)
+void PhysicsSystem::AddRigidbodies(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count, BodyHandle* handles /*= nullptr*/)
 {
-	for (auto it = m_rigidbodies.begin(); it != m_rigidbodies.end(); ++it)
+	ReserveRigidbodies(m_rigidbodies.size() + count);
+
+	for (std::size_t i = 0; i < count; ++i)
 	{
-		if (*it == rigidbody)
-		{
-			m_rigidbodies.erase(it);
-			return;
-		}
+		BodyHandle handle = AddRigidbody(rigidbodies[i]);
+		if (handles != nullptr)
+			handles[i] = handle;
 	}
 }
 
+void PhysicsSystem::RemoveRigidbody(std::shared_ptr<Rigidbody> rigidbody)
+{
+	// m_rigidbodies follows the storage order, the storage index finds the body without searching
+	unsigned int index = m_rigidbodyStorage->GetIndex(rigidbody->GetHandle());
+	if (index == BodyHandle::InvalidIndex || m_rigidbodies[index] != rigidbody)
+		return;
+
+	m_rigidbodyStorage->Remove(rigidbody->GetHandle());
+	SwapRemove(m_rigidbodies, index);
+}
+
+void PhysicsSystem::RemoveRigidbodies(const std::shared_ptr<Rigidbody>* rigidbodies, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		RemoveRigidbody(rigidbodies[i]);
+}
+
+void PhysicsSystem::ReserveRigidbodies(std::size_t capacity)
+{
+	if (capacity <= m_rigidbodies.capacity())
+		return;
+
+	capacity = std::max(capacity, m_rigidbodies.capacity() * 2);
+	m_rigidbodies.reserve(capacity);
+	m_rigidbodyStorage->Reserve(capacity);
+}
+
 std::vector<std::shared_ptr<Particle>> PhysicsSystem::GetParticles()
 {
 	return m_particles;
 }
 
+Particle* PhysicsSystem::GetParticle(const BodyHandle& handle) const
+{
+	return m_particleStorage->GetParticle(handle);
+}
+
 void PhysicsSystem::PrintParticles()
 {
 	for (const std::shared_ptr<Particle> particle : m_particles)
 	{
-		std::cout << "Particle position: " << particle->position << std::endl;
-		std::cout << "Particle velocity: " << particle->velocity << std::endl;
+		std::cout << "Particle position: " << particle->GetPosition() << std::endl;
+		std::cout << "Particle velocity: " << particle->GetVelocity() << std::endl;
 		std::cout << "Particle acceleration: " << particle->GetAcceleration() << std::endl;
 	}
 }
@@ -273,9 +352,37 @@ std::vector<std::shared_ptr<Rigidbody>> PhysicsSystem::GetRigidbodies()
 	return m_rigidbodies;
 }
 
-PotentialContact* PhysicsSystem::GetPotentialContactArray() const
+Rigidbody* PhysicsSystem::GetRigidbody(const BodyHandle& handle) const
 {
-	return m_potentialContact;
+	return m_rigidbodyStorage->GetRigidbody(handle);
+}
+
+RigidbodyStorage& PhysicsSystem::GetRigidbodyStorage()
+{
+	return *m_rigidbodyStorage;
+}
+
+void PhysicsSystem::SetMaxPotentialContacts(unsigned int maxPotentialContacts)
+{
+	m_maxPotentialContacts = maxPotentialContacts;
+
+	if (m_potentialContact.size() > maxPotentialContacts)
+		m_potentialContact.resize(maxPotentialContacts);
+	if (m_potentialContactPrimitive.size() > maxPotentialContacts)
+		m_potentialContactPrimitive.resize(maxPotentialContacts);
+
+	m_potentialContactCount = std::min(m_potentialContactCount, maxPotentialContacts);
+	m_potentialContactPrimitiveCount = std::min(m_potentialContactPrimitiveCount, maxPotentialContacts);
+}
+
+unsigned int PhysicsSystem::GetMaxPotentialContacts() const
+{
+	return m_maxPotentialContacts;
+}
+
+const PotentialContact* PhysicsSystem::GetPotentialContactArray() const
+{
+	return m_potentialContact.data();
 }
 
 unsigned int PhysicsSystem::GetPotentialContactCount() const
@@ -283,9 +390,19 @@ unsigned int PhysicsSystem::GetPotentialContactCount() const
 	return m_potentialContactCount;
 }
 
-PotentialContactPrimitive* PhysicsSystem::GetPotentialContactPrimitiveArray() const
+unsigned int PhysicsSystem::GetPotentialContactCapacity() const
 {
-	return m_potentialContactPrimitive;
+	return static_cast<unsigned int>(m_potentialContact.size());
+}
+
+bool PhysicsSystem::IsPotentialContactTruncated() const
+{
+	return m_isPotentialContactTruncated;
+}
+
+const PotentialContactPrimitive* PhysicsSystem::GetPotentialContactPrimitiveArray() const
+{
+	return m_potentialContactPrimitive.data();
 }
 
 unsigned int PhysicsSystem::GetPotentialContactPrimitiveCount() const
@@ -293,20 +410,57 @@ unsigned int PhysicsSystem::GetPotentialContactPrimitiveCount() const
 	return m_potentialContactPrimitiveCount;
 }
 
+unsigned int PhysicsSystem::GetPotentialContactPrimitiveCapacity() const
+{
+	return static_cast<unsigned int>(m_potentialContactPrimitive.size());
+}
+
+bool PhysicsSystem::IsPotentialContactPrimitiveTruncated() const
+{
+	return m_isPotentialContactPrimitiveTruncated;
+}
+
+const PairCache& PhysicsSystem::GetPairCache() const
+{
+	return *m_pairCache;
+}
+
+void PhysicsSystem::StoreContactImpulses()
+{
+	CachedPair* pairs = m_pairCache->GetPairs();
+	const Contact* contacts = m_contactGenerator->GetContacts();
+
+	for (unsigned int i = 0; i < m_pairCache->GetPairCount(); i++)
+	{
+		CachedPair& pair = pairs[i];
+		if (pair.testedStep == m_pairCache->GetStep() && pair.contactCount > 0)
+			pair.manifold.StoreImpulses(contacts + pair.firstContact);
+	}
+}
+
+bool PhysicsSystem::CanMove(const BodyHandle& body) const
+{
+	if (!m_rigidbodyStorage->IsValid(body))
+		return false;
+
+	unsigned int index = m_rigidbodyStorage->GetIndex(body);
+	return m_rigidbodyStorage->awake[index] != 0 && m_rigidbodyStorage->inverseMasses[index] > 0.0f;
+}
+
 void PhysicsSystem::PrintRigidbodies()
 {
 	for (const std::shared_ptr<Rigidbody> rigidbody : m_rigidbodies)
 	{
-		std::cout << rigidbody->name << " position" << rigidbody->position << std::endl;
-		std::cout << rigidbody->name << " rotation" << rigidbody->rotation << std::endl;
+		std::cout << rigidbody->name << " position" << rigidbody->GetPosition() << std::endl;
+		std::cout << rigidbody->name << " rotation" << rigidbody->GetRotation() << std::endl;
 		std::cout << rigidbody->name << " scale" << rigidbody->scale << std::endl;
-		std::cout << rigidbody->name << " velocity" << rigidbody->velocity << std::endl;
+		std::cout << rigidbody->name << " velocity" << rigidbody->GetVelocity() << std::endl;
 		std::cout << rigidbody->name << " acceleration" << rigidbody->GetAcceleration() << std::endl;
-		std::cout << rigidbody->name << " angular velocity" << rigidbody->angularVelocity << std::endl;
+		std::cout << rigidbody->name << " angular velocity" << rigidbody->GetAngularVelocity() << std::endl;
 		std::cout << rigidbody->name << " angular acceleration" << rigidbody->GetAngularAcceleration() << std::endl;
-		std::cout << rigidbody->name << " torque" << rigidbody->torque << std::endl;
-		std::cout << rigidbody->name << " mass"	 << rigidbody->mass << std::endl;
-		std::cout << rigidbody->name << " force" << rigidbody->force << std::endl;
+		std::cout << rigidbody->name << " torque" << rigidbody->GetTorque() << std::endl;
+		std::cout << rigidbody->name << " mass"	 << rigidbody->GetMass() << std::endl;
+		std::cout << rigidbody->name << " force" << rigidbody->GetForce() << std::endl;
 	}
 }
 
@@ -314,9 +468,14 @@ void PhysicsSystem::ParsePotentialContacts()
 {
 	for (unsigned int i = 0; i < m_potentialContactCount; ++i)
 	{
+		const Rigidbody* first = GetRigidbody(m_potentialContact[i].bodies[0]);
+		const Rigidbody* second = GetRigidbody(m_potentialContact[i].bodies[1]);
+		if (first == nullptr || second == nullptr)
+			continue;
+
 		std::cout << "Contact " << i << std::endl;
-		std::cout << "Rigidbody 1: " << m_potentialContact[i].rigidbodies[0]->name << std::endl;
-		std::cout << "Rigidbody 2: " << m_potentialContact[i].rigidbodies[1]->name << std::endl;
+		std::cout << "Rigidbody 1: " << first->name << std::endl;
+		std::cout << "Rigidbody 2: " << second->name << std::endl;
 	}
 }
 
@@ -324,18 +483,43 @@ void PhysicsSystem::ParsePotentialContactsPrimitive()
 {
 	for (unsigned int i = 0; i < m_potentialContactPrimitiveCount; ++i)
 	{
+		const Rigidbody* first = GetRigidbody(m_potentialContactPrimitive[i].primitives[0]->body);
+		const Rigidbody* second = GetRigidbody(m_potentialContactPrimitive[i].primitives[1]->body);
+		if (first == nullptr || second == nullptr)
+			continue;
+
 		std::cout << "Contact " << i << std::endl;
-		std::cout << "Rigidbody 1: " << m_potentialContactPrimitive[i].primitives[0]->rigidbody->name << std::endl;
-		std::cout << "Rigidbody 2: " << m_potentialContactPrimitive[i].primitives[1]->rigidbody->name << std::endl;
+		std::cout << "Rigidbody 1: " << first->name << std::endl;
+		std::cout << "Rigidbody 2: " << second->name << std::endl;
 	}
 }
 
-std::vector<std::shared_ptr<Contact>> PhysicsSystem::GetContactsArray()
+Contact* PhysicsSystem::GetContactsArray() const
 {
 	return m_contactGenerator->GetContacts();
 }
 
-int PhysicsSystem::GetContactCount()
+int PhysicsSystem::GetContactCount() const
 {
 	return m_contactGenerator->GetCurrentContacts();
+}
+
+void PhysicsSystem::SetMaxContacts(unsigned int maxContacts)
+{
+	m_contactGenerator->SetMaxContacts(maxContacts);
+}
+
+unsigned int PhysicsSystem::GetMaxContacts() const
+{
+	return m_contactGenerator->GetMaxContacts();
+}
+
+bool PhysicsSystem::IsContactTruncated() const
+{
+	return m_isContactTruncated;
+}
+
+std::size_t PhysicsSystem::GetStepAllocationCount() const
+{
+	return m_stepAllocationCount;
 }
\ No newline at end of file
@@ -1,314 +1,519 @@
+#include <algorithm>
 #include "Rigidbody.hpp"
 #include "Constants/PhysicConstants.hpp"
 #include "Constants/MathConstants.hpp"
 #include "Collision/BoundingSphere.hpp"
 #include "Collision/BoundingBox.hpp"
 
+namespace
+{
+	// A body without mass is static, the integrator and the contacts leave it where it is
+	float CalculateInverseMass(float mass)
+	{
+		return mass > 0.0f ? 1.0f / std::max(mass, MIN_MASS) : 0.0f;
+	}
+
+	Matrix3f CalculateInverseInertiaTensor(const Matrix3f& inertiaTensor, float mass)
+	{
+		return mass > 0.0f ? inertiaTensor.Inverse() : Matrix3f(std::array<float, 3 * 3>{});
+	}
+}
+
 Rigidbody::Rigidbody() :
 	name("Rigidbody"),
 	type(SPHERE),
-	position(Vector3f::Zero),
-	rotation(Quaternionf()),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	inertiaTensor(GetSphereInertiaTensorLocal()),
-	mass(MIN_MASS),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(MIN_MASS),
+	m_state(Vector3f::Zero, Quaternionf(), CalculateInverseMass(m_mass))
 {
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_inertiaTensor = GetSphereInertiaTensorLocal();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name) :
 	name(name),
 	type(SPHERE),
-	position(Vector3f::Zero),
-	rotation(Quaternionf()),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	inertiaTensor(GetSphereInertiaTensorLocal()),
-	mass(MIN_MASS),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(MIN_MASS),
+	m_state(Vector3f::Zero, Quaternionf(), CalculateInverseMass(m_mass))
 {
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_inertiaTensor = GetSphereInertiaTensorLocal();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name, Vector3f position) :
 	name(name),
 	type(SPHERE),
-	position(position),
-	rotation(Quaternionf()),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	inertiaTensor(GetSphereInertiaTensorLocal()),
-	mass(MIN_MASS),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(MIN_MASS),
+	m_state(position, Quaternionf(), CalculateInverseMass(m_mass))
 {
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_inertiaTensor = GetSphereInertiaTensorLocal();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name, Vector3f position, float mass) :
 	name(name),
 	type(SPHERE),
-	position(position),
-	rotation(Quaternionf()),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	inertiaTensor(GetSphereInertiaTensorLocal()),
-	mass(mass),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(mass),
+	m_state(position, Quaternionf(), CalculateInverseMass(m_mass))
 {
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_inertiaTensor = GetSphereInertiaTensorLocal();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name, RigidbodyType type) :
 	name(name),
 	type(type),
-	position(Vector3f::Zero),
-	rotation(Quaternionf()),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	mass(MIN_MASS),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(MIN_MASS),
+	m_state(Vector3f::Zero, Quaternionf(), CalculateInverseMass(m_mass))
 {
 	switch (type)
 	{
 	case CUBE:
-		inertiaTensor = GetBoxInertiaTensorLocal();
+		m_inertiaTensor = GetBoxInertiaTensorLocal();
 		break;
 	case SPHERE:
-		inertiaTensor = GetSphereInertiaTensorLocal();
+		m_inertiaTensor = GetSphereInertiaTensorLocal();
 		break;
 	case TETRAHEDRON:
-		inertiaTensor = GetTetrahedronInertiaTensorLocal();
+		m_inertiaTensor = GetTetrahedronInertiaTensorLocal();
 		break;
 	}
 
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name, RigidbodyType type, Vector3f position) :
 	name(name),
 	type(type),
-	position(position),
-	rotation(Quaternionf()),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	mass(MIN_MASS),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(MIN_MASS),
+	m_state(position, Quaternionf(), CalculateInverseMass(m_mass))
 {
 	switch (type)
 	{
 	case CUBE:
-		inertiaTensor = GetBoxInertiaTensorLocal();
+		m_inertiaTensor = GetBoxInertiaTensorLocal();
 		break;
 	case SPHERE:
-		inertiaTensor = GetSphereInertiaTensorLocal();
+		m_inertiaTensor = GetSphereInertiaTensorLocal();
 		break;
 	case TETRAHEDRON:
-		inertiaTensor = GetTetrahedronInertiaTensorLocal();
+		m_inertiaTensor = GetTetrahedronInertiaTensorLocal();
 		break;
 	}
 
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name, RigidbodyType type, Vector3f position, float mass) :
 	name(name),
 	type(type),
-	position(position),
-	rotation(Quaternionf()),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	mass(mass),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(mass),
+	m_state(position, Quaternionf(), CalculateInverseMass(m_mass))
 {
 	switch (type)
 	{
 	case CUBE:
-		inertiaTensor = GetBoxInertiaTensorLocal();
+		m_inertiaTensor = GetBoxInertiaTensorLocal();
 		break;
 	case SPHERE:
-		inertiaTensor = GetSphereInertiaTensorLocal();
+		m_inertiaTensor = GetSphereInertiaTensorLocal();
 		break;
 	case TETRAHEDRON:
-		inertiaTensor = GetTetrahedronInertiaTensorLocal();
+		m_inertiaTensor = GetTetrahedronInertiaTensorLocal();
 		break;
 	}
 
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name, RigidbodyType type, Vector3f position, Vector3f scale, float mass) :
 	name(name),
 	type(type),
-	position(position),
-	rotation(Quaternionf()),
 	scale(scale),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	mass(mass),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(mass),
+	m_state(position, Quaternionf(), CalculateInverseMass(m_mass))
 {
 	switch (type)
 	{
 	case CUBE:
-		inertiaTensor = GetBoxInertiaTensorLocal();
+		m_inertiaTensor = GetBoxInertiaTensorLocal();
 		break;
 	case SPHERE:
-		inertiaTensor = GetSphereInertiaTensorLocal();
+		m_inertiaTensor = GetSphereInertiaTensorLocal();
 		break;
 	case TETRAHEDRON:
-		inertiaTensor = GetTetrahedronInertiaTensorLocal();
+		m_inertiaTensor = GetTetrahedronInertiaTensorLocal();
 		break;
 	}
 
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
 Rigidbody::Rigidbody(std::string name, RigidbodyType type, Vector3f position, Quaternionf rotation, float mass) :
 	name(name),
 	type(type),
-	position(position),
-	rotation(rotation),
 	scale(Vector3f::One),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	mass(mass),
-	inverseMass(1.0f / MIN_MASS),
-	isAwake(true)
+	m_mass(mass),
+	m_state(position, rotation, CalculateInverseMass(m_mass))
 {
 	switch (type)
 	{
 	case CUBE:
-		inertiaTensor = GetBoxInertiaTensorLocal();
+		m_inertiaTensor = GetBoxInertiaTensorLocal();
 		break;
 	case SPHERE:
-		inertiaTensor = GetSphereInertiaTensorLocal();
+		m_inertiaTensor = GetSphereInertiaTensorLocal();
 		break;
 	case TETRAHEDRON:
-		inertiaTensor = GetTetrahedronInertiaTensorLocal();
+		m_inertiaTensor = GetTetrahedronInertiaTensorLocal();
 		break;
 	}
 
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
-Rigidbody::Rigidbody(std::string name, RigidbodyType, Vector3f position, Quaternionf rotation, Vector3f scale, float mass, float linearDamping, float angularDamping) :
+Rigidbody::Rigidbody(std::string name, RigidbodyType type, Vector3f position, Quaternionf rotation, Vector3f scale, float mass, float linearDamping, float angularDamping) :
 	name(name),
 	type(type),
-	position(position),
-	rotation(rotation),
 	scale(scale),
-	velocity(Vector3f::Zero),
 	m_acceleration(Vector3f::Zero),
-	force(Vector3f::Zero),
-	angularVelocity(Vector3f::Zero),
 	m_angularAcceleration(Vector3f::Zero),
-	mass(mass),
-	inverseMass(1.0f / MIN_MASS),
-	linearDamping(linearDamping),
-	angularDamping(angularDamping),
-	isAwake(true)
+	m_mass(mass),
+	m_state(position, rotation, CalculateInverseMass(m_mass))
 {
 	switch (type)
 	{
 	case CUBE:
-		inertiaTensor = GetBoxInertiaTensorLocal();
+		m_inertiaTensor = GetBoxInertiaTensorLocal();
 		break;
 	case SPHERE:
-		inertiaTensor = GetSphereInertiaTensorLocal();
+		m_inertiaTensor = GetSphereInertiaTensorLocal();
 		break;
 	case TETRAHEDRON:
-		inertiaTensor = GetTetrahedronInertiaTensorLocal();
+		m_inertiaTensor = GetTetrahedronInertiaTensorLocal();
 		break;
 	}
 
-	inverseInertiaTensor = inertiaTensor.Inverse();
+	m_state.linearDamping = linearDamping;
+	m_state.angularDamping = angularDamping;
+	m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
 	CalculateDerivedData();
 }
 
+Rigidbody::Rigidbody(const Rigidbody& rigidbody) :
+	name(rigidbody.name),
+	type(rigidbody.type),
+	scale(rigidbody.scale),
+	centerOfMass(rigidbody.centerOfMass),
+	m_boundingSphere(rigidbody.m_boundingSphere),
+	m_acceleration(rigidbody.m_acceleration),
+	m_angularAcceleration(rigidbody.m_angularAcceleration),
+	m_mass(rigidbody.GetMass()),
+	m_inertiaTensor(rigidbody.m_inertiaTensor)
+{
+	// The copy is never part of a storage, it starts with its own snapshot of the state
+	m_state.position = rigidbody.GetPosition();
+	m_state.rotation = rigidbody.GetRotation();
+	m_state.velocity = rigidbody.GetVelocity();
+	m_state.angularVelocity = rigidbody.GetAngularVelocity();
+	m_state.force = rigidbody.GetForce();
+	m_state.torque = rigidbody.GetTorque();
+	m_state.inverseMass = rigidbody.GetInverseMass();
+	m_state.inverseInertiaTensorWorld = rigidbody.GetInverseInertiaTensorWorld();
+	m_state.linearDamping = rigidbody.GetLinearDamping();
+	m_state.angularDamping = rigidbody.GetAngularDamping();
+	m_state.isAwake = rigidbody.IsAwake();
+	m_state.motion = rigidbody.IsAwake() ? SLEEP_MOTION * 2.0f : 0.0f;
+	m_state.inverseInertiaTensorLocal = rigidbody.GetInverseInertiaTensor();
+	m_state.transformMatrix = rigidbody.GetTransformMatrix();
+}
+
+Rigidbody::~Rigidbody()
+{
+	if (m_storage != nullptr)
+		m_storage->Remove(m_handle);
+}
+
+Vector3f& Rigidbody::GetPosition()
+{
+	return m_storage ? m_storage->positions[m_storageIndex] : m_state.position;
+}
+
+const Vector3f& Rigidbody::GetPosition() const
+{
+	return m_storage ? m_storage->positions[m_storageIndex] : m_state.position;
+}
+
+void Rigidbody::SetPosition(const Vector3f& position)
+{
+	GetPosition() = position;
+}
+
+Quaternionf& Rigidbody::GetRotation()
+{
+	return m_storage ? m_storage->rotations[m_storageIndex] : m_state.rotation;
+}
+
+const Quaternionf& Rigidbody::GetRotation() const
+{
+	return m_storage ? m_storage->rotations[m_storageIndex] : m_state.rotation;
+}
+
+void Rigidbody::SetRotation(const Quaternionf& rotation)
+{
+	GetRotation() = rotation;
+}
+
+Vector3f& Rigidbody::GetVelocity()
+{
+	return m_storage ? m_storage->velocities[m_storageIndex] : m_state.velocity;
+}
+
+const Vector3f& Rigidbody::GetVelocity() const
+{
+	return m_storage ? m_storage->velocities[m_storageIndex] : m_state.velocity;
+}
+
+void Rigidbody::SetVelocity(const Vector3f& velocity)
+{
+	GetVelocity() = velocity;
+}
+
+Vector3f& Rigidbody::GetAngularVelocity()
+{
+	return m_storage ? m_storage->angularVelocities[m_storageIndex] : m_state.angularVelocity;
+}
+
+const Vector3f& Rigidbody::GetAngularVelocity() const
+{
+	return m_storage ? m_storage->angularVelocities[m_storageIndex] : m_state.angularVelocity;
+}
+
+void Rigidbody::SetAngularVelocity(const Vector3f& angularVelocity)
+{
+	GetAngularVelocity() = angularVelocity;
+}
+
+Vector3f& Rigidbody::GetForce()
+{
+	return m_storage ? m_storage->forces[m_storageIndex] : m_state.force;
+}
+
+const Vector3f& Rigidbody::GetForce() const
+{
+	return m_storage ? m_storage->forces[m_storageIndex] : m_state.force;
+}
+
+Vector3f& Rigidbody::GetTorque()
+{
+	return m_storage ? m_storage->torques[m_storageIndex] : m_state.torque;
+}
+
+const Vector3f& Rigidbody::GetTorque() const
+{
+	return m_storage ? m_storage->torques[m_storageIndex] : m_state.torque;
+}
+
+float Rigidbody::GetMass() const
+{
+	return m_storage ? m_storage->masses[m_storageIndex] : m_mass;
+}
+
+void Rigidbody::SetMass(float mass)
+{
+	const bool wasStatic = m_mass <= 0.0f;
+	m_mass = mass;
+
+	// The tensor of a static body was computed without mass, inverting it would give infinities
+	if (wasStatic)
+		m_inertiaTensor = GetInertiaTensorLocal();
+
+	if (m_storage)
+	{
+		m_storage->masses[m_storageIndex] = m_mass;
+		m_storage->inverseMasses[m_storageIndex] = CalculateInverseMass(m_mass);
+		m_storage->inverseInertiaTensorsLocal[m_storageIndex] = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
+	}
+	else
+	{
+		m_state.inverseMass = CalculateInverseMass(m_mass);
+		m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(m_inertiaTensor, m_mass);
+	}
+}
+
+bool Rigidbody::IsStatic() const
+{
+	return GetInverseMass() == 0.0f;
+}
+
+float Rigidbody::GetInverseMass() const
+{
+	return m_storage ? m_storage->inverseMasses[m_storageIndex] : m_state.inverseMass;
+}
+
+const Matrix3f& Rigidbody::GetInverseInertiaTensorWorld() const
+{
+	return m_storage ? m_storage->inverseInertiaTensorsWorld[m_storageIndex] : m_state.inverseInertiaTensorWorld;
+}
+
+const Matrix3f& Rigidbody::GetInverseInertiaTensor() const
+{
+	return m_storage ? m_storage->inverseInertiaTensorsLocal[m_storageIndex] : m_state.inverseInertiaTensorLocal;
+}
+
+const Matrix3f& Rigidbody::GetInertiaTensor() const
+{
+	return m_inertiaTensor;
+}
+
+void Rigidbody::SetInertiaTensor(const Matrix3f& inertiaTensor)
+{
+	m_inertiaTensor = inertiaTensor;
+
+	if (m_storage)
+		m_storage->inverseInertiaTensorsLocal[m_storageIndex] = CalculateInverseInertiaTensor(inertiaTensor, GetMass());
+	else
+		m_state.inverseInertiaTensorLocal = CalculateInverseInertiaTensor(inertiaTensor, GetMass());
+}
+
+const Matrix4f& Rigidbody::GetTransformMatrix() const
+{
+	return m_storage ? m_storage->transformMatrices[m_storageIndex] : m_state.transformMatrix;
+}
+
+float Rigidbody::GetLinearDamping() const
+{
+	return m_storage ? m_storage->linearDampings[m_storageIndex] : m_state.linearDamping;
+}
+
+void Rigidbody::SetLinearDamping(float linearDamping)
+{
+	if (m_storage)
+		m_storage->linearDampings[m_storageIndex] = linearDamping;
+	else
+		m_state.linearDamping = linearDamping;
+}
+
+float Rigidbody::GetAngularDamping() const
+{
+	return m_storage ? m_storage->angularDampings[m_storageIndex] : m_state.angularDamping;
+}
+
+void Rigidbody::SetAngularDamping(float angularDamping)
+{
+	if (m_storage)
+		m_storage->angularDampings[m_storageIndex] = angularDamping;
+	else
+		m_state.angularDamping = angularDamping;
+}
+
+bool Rigidbody::IsAwake() const
+{
+	return m_storage ? m_storage->awake[m_storageIndex] != 0 : m_state.isAwake;
+}
+
+void Rigidbody::SetAwake(bool isAwake)
+{
+	// A body woken up starts above the sleep threshold so it is not put back to sleep on the next step
+	const float motion = isAwake ? SLEEP_MOTION * 2.0f : 0.0f;
+
+	if (m_storage)
+	{
+		m_storage->awake[m_storageIndex] = isAwake;
+		m_storage->motions[m_storageIndex] = motion;
+	}
+	else
+	{
+		m_state.isAwake = isAwake;
+		m_state.motion = motion;
+	}
+
+	if (!isAwake)
+	{
+		GetVelocity() = Vector3f::Zero;
+		GetAngularVelocity() = Vector3f::Zero;
+	}
+}
+
+bool Rigidbody::IsInStorage() const
+{
+	return m_storage != nullptr;
+}
+
+unsigned int Rigidbody::GetStorageIndex() const
+{
+	return m_storageIndex;
+}
+
+BodyHandle Rigidbody::GetHandle() const
+{
+	return m_handle;
+}
+
 void Rigidbody::ClearForce()
 {
-	force = Vector3f::Zero;
+	GetForce() = Vector3f::Zero;
 }
 
 void Rigidbody::ClearTorque()
 {
-	torque = Vector3f::Zero;
+	GetTorque() = Vector3f::Zero;
 }
 
 void Rigidbody::AddForce(const Vector3f& f)
 {
-	force += f;
+	GetForce() += f;
 }
 
 Vector3f Rigidbody::GetPointInWorldSpace(const Vector3f& point)
 {
-	return transformMatrix * point;
+	return GetTransformMatrix() * point;
 }
 
 Vector3f Rigidbody::GetPointInLocalSpace(const Vector3f& point)
 {
-	return transformMatrix.Inverse() * point;
+	return GetTransformMatrix().Inverse() * point;
 }
 
 void Rigidbody::AddForceAtPoint(const Vector3f& f, const Vector3f& point)
 {
 	Vector3f pt = point;
-	pt -= position;
-	force += f;
-	torque += pt.Cross(f);
+	pt -= GetPosition();
+	GetForce() += f;
+	GetTorque() += pt.Cross(f);
 }
 
 void Rigidbody::AddForceAtBodyPoint(const Vector3f& f, const Vector3f& point)
@@ -319,45 +524,47 @@ void Rigidbody::AddForceAtBodyPoint(const Vector3f& f, const Vector3f& point)
 
 Vector3f const Rigidbody::GetAcceleration()
 {
-	m_acceleration = force / mass;
+	m_acceleration = GetForce() * GetInverseMass();
 	return m_acceleration;
 }
 
 Vector3f const Rigidbody::GetAngularAcceleration()
 {
-	m_angularAcceleration = inverseInertiaTensorWorld * torque;
+	m_angularAcceleration = GetInverseInertiaTensorWorld() * GetTorque();
 	return m_angularAcceleration;
 }
 
-void Rigidbody::CalculateTransformMatrix()
+void Rigidbody::CalculateDerivedData()
 {
-	float x = rotation.GetX();
-	float y = rotation.GetY();
-	float z = rotation.GetZ();
-	float s = rotation.GetS();
-	float posX = position.x;
-	float posY = position.y;
-	float posZ = position.z;
+	if (m_storage)
+	{
+		m_storage->CalculateDerivedData(m_storageIndex);
+		return;
+	}
 
-	transformMatrix = Matrix4f({
-		1.0f - 2.0f * y * y - 2.0f * z * z,     2.0f * x * y - 2.0f * s * z,			2.0f * x * z + 2.0f * s * y,			posX,
-		2.0f * x * y + 2.0f * s * z,			1.0f - 2.0f * x * x - 2.0f * z * z,		2.0f * y * z - 2.0f * s * x,			posY,
-		2.0f * x * z - 2.0f * s * y,			2.0f * y * z + 2.0f * s * x,			1.0f - 2.0f * x * x - 2.0f * y * y,		posZ,
-		0.0f,									0.0f,									0.0f,									1.0f
-		}
-	);
+	m_state.rotation.Normalize();
+	m_state.transformMatrix = RigidbodyStorage::CalculateTransformMatrix(m_state.position, m_state.rotation);
+	m_state.inverseInertiaTensorWorld = RigidbodyStorage::CalculateInverseInertiaTensorWorld(m_state.inverseInertiaTensorLocal, m_state.transformMatrix);
 }
 
-void Rigidbody::CalculateDerivedData()
+Matrix3f Rigidbody::GetInertiaTensorLocal()
 {
-	rotation.Normalize();
-	CalculateTransformMatrix();
-	inverseInertiaTensorWorld = GetInverseInertiaTensorWorld();
+	switch (type)
+	{
+	case CUBE:
+		return GetBoxInertiaTensorLocal();
+	case TETRAHEDRON:
+		return GetTetrahedronInertiaTensorLocal();
+	case SPHERE:
+		break;
+	}
+
+	return GetSphereInertiaTensorLocal();
 }
 
 Matrix3f Rigidbody::GetBoxInertiaTensorLocal()
 {
-	float mass = this->mass;
+	float mass = m_mass;
 
 	float Ixx = (mass / 12.0f) * (scale.y * scale.y + scale.z * scale.z);
 	float Iyy = (mass / 12.0f) * (scale.x * scale.x + scale.z * scale.z);
@@ -374,7 +581,7 @@ Matrix3f Rigidbody::GetSphereInertiaTensorLocal()
 {
 	float radius = scale.x;
 
-	float I = (2.0f / 5.0f) * (mass * radius * radius);
+	float I = (2.0f / 5.0f) * (m_mass * radius * radius);
 
 	return Matrix3f({
 		I, 0.0f, 0.0f,
@@ -386,7 +593,7 @@ Matrix3f Rigidbody::GetSphereInertiaTensorLocal()
 Matrix3f Rigidbody::GetTetrahedronInertiaTensorLocal()
 {
 	float s = scale.x;
-	float I = (1.0f / 20.0f) * mass * s * s;
+	float I = (1.0f / 20.0f) * m_mass * s * s;
 
 	return Matrix3f({
 		I, 0.0f, 0.0f,
@@ -395,61 +602,16 @@ Matrix3f Rigidbody::GetTetrahedronInertiaTensorLocal()
 		});
 }
 
-Matrix3f Rigidbody::GetInverseInertiaTensorWorld()
-{
-	Matrix3f iitLocal = inverseInertiaTensor;
-	Quaternion q = rotation;
-	Matrix4f rotM = transformMatrix;
-
-	float t4 = rotM.Value(0, 0) * iitLocal.Value(0, 0) +
-		rotM.Value(0, 1) * iitLocal.Value(1, 0) +
-		rotM.Value(0, 2) * iitLocal.Value(2, 0);
-	float t9 = rotM.Value(0, 0) * iitLocal.Value(0, 1) +
-		rotM.Value(0, 1) * iitLocal.Value(1, 1) +
-		rotM.Value(0, 2) * iitLocal.Value(2, 1);
-	float t14 = rotM.Value(0, 0) * iitLocal.Value(0, 2) +
-		rotM.Value(0, 1) * iitLocal.Value(1, 2) +
-		rotM.Value(0, 2) * iitLocal.Value(2, 2);
-	float t28 = rotM.Value(1, 0) * iitLocal.Value(0, 0) +
-		rotM.Value(1, 1) * iitLocal.Value(1, 0) +
-		rotM.Value(1, 2) * iitLocal.Value(2, 0);
-	float t33 = rotM.Value(1, 0) * iitLocal.Value(0, 1) +
-		rotM.Value(1, 1) * iitLocal.Value(1, 1) +
-		rotM.Value(1, 2) * iitLocal.Value(2, 1);
-	float t38 = rotM.Value(1, 0) * iitLocal.Value(0, 2) +
-		rotM.Value(1, 1) * iitLocal.Value(1, 2) +
-		rotM.Value(1, 2) * iitLocal.Value(2, 2);
-	float t52 = rotM.Value(2, 0) * iitLocal.Value(0, 0) +
-		rotM.Value(2, 1) * iitLocal.Value(1, 0) +
-		rotM.Value(2, 2) * iitLocal.Value(2, 0);
-	float t57 = rotM.Value(2, 0) * iitLocal.Value(0, 1) +
-		rotM.Value(2, 1) * iitLocal.Value(1, 1) +
-		rotM.Value(2, 2) * iitLocal.Value(2, 1);
-	float t62 = rotM.Value(2, 0) * iitLocal.Value(0, 2) +
-		rotM.Value(2, 1) * iitLocal.Value(1, 2) +
-		rotM.Value(2, 2) * iitLocal.Value(2, 2);
-
-	Matrix3f iitWorld = Matrix3f({
-		t4 * rotM.Value(0, 0) + t9 * rotM.Value(0, 1) + t14 * rotM.Value(0, 2),
-		t4 * rotM.Value(1, 0) + t9 * rotM.Value(1, 1) + t14 * rotM.Value(1, 2),
-		t4 * rotM.Value(2, 0) + t9 * rotM.Value(2, 1) + t14 * rotM.Value(2, 2),
-		t28 * rotM.Value(0, 0) + t33 * rotM.Value(0, 1) + t38 * rotM.Value(0, 2),
-		t28 * rotM.Value(1, 0) + t33 * rotM.Value(1, 1) + t38 * rotM.Value(1, 2),
-		t28 * rotM.Value(2, 0) + t33 * rotM.Value(2, 1) + t38 * rotM.Value(2, 2),
-		t52 * rotM.Value(0, 0) + t57 * rotM.Value(0, 1) + t62 * rotM.Value(0, 2),
-		t52 * rotM.Value(1, 0) + t57 * rotM.Value(1, 1) + t62 * rotM.Value(1, 2),
-		t52 * rotM.Value(2, 0) + t57 * rotM.Value(2, 1) + t62 * rotM.Value(2, 2)
-		});
-
-	return iitWorld;
-}
-
 std::shared_ptr<BoundingSphere> Rigidbody::GetBoundingSphere()
 {
+	// The integrator no longer touches the sphere, it follows the body when it is asked for
+	if (m_boundingSphere != nullptr)
+		m_boundingSphere->m_center = GetPosition();
+
 	return m_boundingSphere;
 }
 
 BoundingBox Rigidbody::GetBoundingBox()
 {
-	return BoundingBox(position, scale);
+	return BoundingBox(GetPosition(), scale);
 }
\ No newline at end of file
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include "RigidbodyStorage.hpp"
+#include "Rigidbody.hpp"
+#include "Constants/PhysicConstants.hpp"
+
+RigidbodyState::RigidbodyState(const Vector3f& position, const Quaternionf& rotation, float inverseMass) :
+	position(position),
+	rotation(rotation),
+	velocity(Vector3f::Zero),
+	angularVelocity(Vector3f::Zero),
+	force(Vector3f::Zero),
+	torque(Vector3f::Zero),
+	inverseMass(inverseMass),
+	inverseInertiaTensorWorld(Matrix3f::Identity()),
+	linearDamping(0.0f),
+	angularDamping(0.0f),
+	isAwake(true),
+	motion(SLEEP_MOTION * 2.0f),
+	inverseInertiaTensorLocal(Matrix3f::Identity()),
+	transformMatrix(Matrix4f::Identity())
+{
+}
+
+RigidbodyStorage::~RigidbodyStorage()
+{
+	Clear();
+}
+
+BodyHandle RigidbodyStorage::Add(Rigidbody* rigidbody)
+{
+	unsigned int index = static_cast<unsigned int>(m_rigidbodies.size());
+	BodyHandle handle = m_handleTable.Create(index);
+	const RigidbodyState& state = rigidbody->m_state;
+
+	positions.push_back(state.position);
+	rotations.push_back(state.rotation);
+	velocities.push_back(state.velocity);
+	angularVelocities.push_back(state.angularVelocity);
+	forces.push_back(state.force);
+	torques.push_back(state.torque);
+	inverseMasses.push_back(state.inverseMass);
+	masses.push_back(rigidbody->m_mass);
+	inverseInertiaTensorsWorld.push_back(state.inverseInertiaTensorWorld);
+	linearDampings.push_back(state.linearDamping);
+	angularDampings.push_back(state.angularDamping);
+	awake.push_back(state.isAwake);
+	motions.push_back(state.motion);
+	inverseInertiaTensorsLocal.push_back(state.inverseInertiaTensorLocal);
+	transformMatrices.push_back(state.transformMatrix);
+	m_rigidbodies.push_back(rigidbody);
+	m_handles.push_back(handle);
+
+	rigidbody->m_storage = this;
+	rigidbody->m_storageIndex = index;
+	rigidbody->m_handle = handle;
+
+	return handle;
+}
+
+void RigidbodyStorage::Remove(const BodyHandle& handle)
+{
+	unsigned int index = m_handleTable.GetDenseIndex(handle);
+	if (index == BodyHandle::InvalidIndex)
+		return;
+
+	Detach(index);
+	m_handleTable.Destroy(handle);
+
+	SwapRemove(positions, index);
+	SwapRemove(rotations, index);
+	SwapRemove(velocities, index);
+	SwapRemove(angularVelocities, index);
+	SwapRemove(forces, index);
+	SwapRemove(torques, index);
+	SwapRemove(inverseMasses, index);
+	SwapRemove(masses, index);
+	SwapRemove(inverseInertiaTensorsWorld, index);
+	SwapRemove(linearDampings, index);
+	SwapRemove(angularDampings, index);
+	SwapRemove(awake, index);
+	SwapRemove(motions, index);
+	SwapRemove(inverseInertiaTensorsLocal, index);
+	SwapRemove(transformMatrices, index);
+	SwapRemove(m_rigidbodies, index);
+	SwapRemove(m_handles, index);
+
+	// The last body took the slot of the removed one
+	if (index < m_rigidbodies.size())
+	{
+		m_rigidbodies[index]->m_storageIndex = index;
+		m_handleTable.SetDenseIndex(m_handles[index], index);
+	}
+}
+
+void RigidbodyStorage::Remove(const BodyHandle* handles, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		Remove(handles[i]);
+}
+
+void RigidbodyStorage::Clear()
+{
+	for (unsigned int i = 0; i < m_rigidbodies.size(); ++i)
+		Detach(i);
+
+	positions.clear();
+	rotations.clear();
+	velocities.clear();
+	angularVelocities.clear();
+	forces.clear();
+	torques.clear();
+	inverseMasses.clear();
+	masses.clear();
+	inverseInertiaTensorsWorld.clear();
+	linearDampings.clear();
+	angularDampings.clear();
+	awake.clear();
+	motions.clear();
+	inverseInertiaTensorsLocal.clear();
+	transformMatrices.clear();
+	m_rigidbodies.clear();
+	m_handles.clear();
+	m_handleTable.Clear();
+}
+
+void RigidbodyStorage::Reserve(std::size_t capacity)
+{
+	positions.reserve(capacity);
+	rotations.reserve(capacity);
+	velocities.reserve(capacity);
+	angularVelocities.reserve(capacity);
+	forces.reserve(capacity);
+	torques.reserve(capacity);
+	inverseMasses.reserve(capacity);
+	masses.reserve(capacity);
+	inverseInertiaTensorsWorld.reserve(capacity);
+	linearDampings.reserve(capacity);
+	angularDampings.reserve(capacity);
+	awake.reserve(capacity);
+	motions.reserve(capacity);
+	inverseInertiaTensorsLocal.reserve(capacity);
+	transformMatrices.reserve(capacity);
+	m_rigidbodies.reserve(capacity);
+	m_handles.reserve(capacity);
+	m_handleTable.Reserve(capacity);
+}
+
+std::size_t RigidbodyStorage::GetSize() const
+{
+	return m_rigidbodies.size();
+}
+
+bool RigidbodyStorage::IsValid(const BodyHandle& handle) const
+{
+	return m_handleTable.IsAlive(handle);
+}
+
+unsigned int RigidbodyStorage::GetIndex(const BodyHandle& handle) const
+{
+	return m_handleTable.GetDenseIndex(handle);
+}
+
+BodyHandle RigidbodyStorage::GetHandle(unsigned int index) const
+{
+	return m_handles[index];
+}
+
+Rigidbody* RigidbodyStorage::GetRigidbody(const BodyHandle& handle) const
+{
+	unsigned int index = m_handleTable.GetDenseIndex(handle);
+	return index != BodyHandle::InvalidIndex ? m_rigidbodies[index] : nullptr;
+}
+
+Rigidbody* RigidbodyStorage::GetRigidbody(unsigned int index) const
+{
+	return m_rigidbodies[index];
+}
+
+void RigidbodyStorage::ClearAccumulators()
+{
+	std::fill(forces.begin(), forces.end(), Vector3f::Zero);
+	std::fill(torques.begin(), torques.end(), Vector3f::Zero);
+}
+
+void RigidbodyStorage::CalculateDerivedData(unsigned int index)
+{
+	rotations[index].Normalize();
+	transformMatrices[index] = CalculateTransformMatrix(positions[index], rotations[index]);
+	inverseInertiaTensorsWorld[index] = CalculateInverseInertiaTensorWorld(inverseInertiaTensorsLocal[index], transformMatrices[index]);
+}
+
+Matrix4f RigidbodyStorage::CalculateTransformMatrix(const Vector3f& position, const Quaternionf& rotation)
+{
+	Quaternionf q = rotation;
+
+	float x = q.GetX();
+	float y = q.GetY();
+	float z = q.GetZ();
+	float s = q.GetS();
+	float posX = position.x;
+	float posY = position.y;
+	float posZ = position.z;
+
+	return Matrix4f({
+		1.0f - 2.0f * y * y - 2.0f * z * z,     2.0f * x * y - 2.0f * s * z,			2.0f * x * z + 2.0f * s * y,			posX,
+		2.0f * x * y + 2.0f * s * z,			1.0f - 2.0f * x * x - 2.0f * z * z,		2.0f * y * z - 2.0f * s * x,			posY,
+		2.0f * x * z - 2.0f * s * y,			2.0f * y * z + 2.0f * s * x,			1.0f - 2.0f * x * x - 2.0f * y * y,		posZ,
+		0.0f,									0.0f,									0.0f,									1.0f
+		}
+	);
+}
+
+Matrix3f RigidbodyStorage::CalculateInverseInertiaTensorWorld(const Matrix3f& inverseInertiaTensorLocal, const Matrix4f& transformMatrix)
+{
+	const Matrix3f& iitLocal = inverseInertiaTensorLocal;
+	const Matrix4f& rotM = transformMatrix;
+
+	float t4 = rotM.Value(0, 0) * iitLocal.Value(0, 0) +
+		rotM.Value(0, 1) * iitLocal.Value(1, 0) +
+		rotM.Value(0, 2) * iitLocal.Value(2, 0);
+	float t9 = rotM.Value(0, 0) * iitLocal.Value(0, 1) +
+		rotM.Value(0, 1) * iitLocal.Value(1, 1) +
+		rotM.Value(0, 2) * iitLocal.Value(2, 1);
+	float t14 = rotM.Value(0, 0) * iitLocal.Value(0, 2) +
+		rotM.Value(0, 1) * iitLocal.Value(1, 2) +
+		rotM.Value(0, 2) * iitLocal.Value(2, 2);
+	float t28 = rotM.Value(1, 0) * iitLocal.Value(0, 0) +
+		rotM.Value(1, 1) * iitLocal.Value(1, 0) +
+		rotM.Value(1, 2) * iitLocal.Value(2, 0);
+	float t33 = rotM.Value(1, 0) * iitLocal.Value(0, 1) +
+		rotM.Value(1, 1) * iitLocal.Value(1, 1) +
+		rotM.Value(1, 2) * iitLocal.Value(2, 1);
+	float t38 = rotM.Value(1, 0) * iitLocal.Value(0, 2) +
+		rotM.Value(1, 1) * iitLocal.Value(1, 2) +
+		rotM.Value(1, 2) * iitLocal.Value(2, 2);
+	float t52 = rotM.Value(2, 0) * iitLocal.Value(0, 0) +
+		rotM.Value(2, 1) * iitLocal.Value(1, 0) +
+		rotM.Value(2, 2) * iitLocal.Value(2, 0);
+	float t57 = rotM.Value(2, 0) * iitLocal.Value(0, 1) +
+		rotM.Value(2, 1) * iitLocal.Value(1, 1) +
+		rotM.Value(2, 2) * iitLocal.Value(2, 1);
+	float t62 = rotM.Value(2, 0) * iitLocal.Value(0, 2) +
+		rotM.Value(2, 1) * iitLocal.Value(1, 2) +
+		rotM.Value(2, 2) * iitLocal.Value(2, 2);
+
+	Matrix3f iitWorld = Matrix3f({
+		t4 * rotM.Value(0, 0) + t9 * rotM.Value(0, 1) + t14 * rotM.Value(0, 2),
+		t4 * rotM.Value(1, 0) + t9 * rotM.Value(1, 1) + t14 * rotM.Value(1, 2),
+		t4 * rotM.Value(2, 0) + t9 * rotM.Value(2, 1) + t14 * rotM.Value(2, 2),
+		t28 * rotM.Value(0, 0) + t33 * rotM.Value(0, 1) + t38 * rotM.Value(0, 2),
+		t28 * rotM.Value(1, 0) + t33 * rotM.Value(1, 1) + t38 * rotM.Value(1, 2),
+		t28 * rotM.Value(2, 0) + t33 * rotM.Value(2, 1) + t38 * rotM.Value(2, 2),
+		t52 * rotM.Value(0, 0) + t57 * rotM.Value(0, 1) + t62 * rotM.Value(0, 2),
+		t52 * rotM.Value(1, 0) + t57 * rotM.Value(1, 1) + t62 * rotM.Value(1, 2),
+		t52 * rotM.Value(2, 0) + t57 * rotM.Value(2, 1) + t62 * rotM.Value(2, 2)
+		});
+
+	return iitWorld;
+}
+
+void RigidbodyStorage::Detach(unsigned int index)
+{
+	// Give the body back its own copy of the state so it stays usable outside of the storage
+	Rigidbody* rigidbody = m_rigidbodies[index];
+	RigidbodyState& state = rigidbody->m_state;
+
+	state.position = positions[index];
+	state.rotation = rotations[index];
+	state.velocity = velocities[index];
+	state.angularVelocity = angularVelocities[index];
+	state.force = forces[index];
+	state.torque = torques[index];
+	state.inverseMass = inverseMasses[index];
+	state.inverseInertiaTensorWorld = inverseInertiaTensorsWorld[index];
+	state.linearDamping = linearDampings[index];
+	state.angularDamping = angularDampings[index];
+	state.isAwake = awake[index] != 0;
+	state.motion = motions[index];
+	state.inverseInertiaTensorLocal = inverseInertiaTensorsLocal[index];
+	state.transformMatrix = transformMatrices[index];
+
+	rigidbody->m_storage = nullptr;
+	rigidbody->m_storageIndex = 0;
+	rigidbody->m_handle = BodyHandle();
+}
@@ -0,0 +1,101 @@
+#include <algorithm>
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(unsigned int threadCount) :
+	m_stop(false),
+	m_jobId(0),
+	m_busyWorkers(0),
+	m_task(nullptr),
+	m_context(nullptr),
+	m_count(0),
+	m_chunkSize(1),
+	m_nextChunk(0)
+{
+	for (unsigned int i = 1; i < threadCount; ++i)
+		m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+
+	m_jobReady.notify_all();
+	for (std::thread& worker : m_workers)
+		worker.join();
+}
+
+unsigned int ThreadPool::GetThreadCount() const
+{
+	return static_cast<unsigned int>(m_workers.size()) + 1;
+}
+
+void ThreadPool::Run(Task task, const void* context, std::size_t count, std::size_t chunkSize)
+{
+	if (count == 0)
+		return;
+
+	chunkSize = std::max<std::size_t>(chunkSize, 1);
+
+	// Not worth waking the workers for a single chunk
+	if (m_workers.empty() || count <= chunkSize)
+	{
+		task(context, 0, count);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = task;
+		m_context = context;
+		m_count = count;
+		m_chunkSize = chunkSize;
+		m_nextChunk = 0;
+		m_busyWorkers = static_cast<unsigned int>(m_workers.size());
+		++m_jobId;
+	}
+
+	m_jobReady.notify_all();
+	RunChunks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_jobDone.wait(lock, [this]() { return m_busyWorkers == 0; });
+}
+
+void ThreadPool::RunChunks()
+{
+	const std::size_t chunkCount = (m_count + m_chunkSize - 1) / m_chunkSize;
+
+	for (std::size_t chunk = m_nextChunk++; chunk < chunkCount; chunk = m_nextChunk++)
+	{
+		std::size_t begin = chunk * m_chunkSize;
+		std::size_t end = std::min(begin + m_chunkSize, m_count);
+		m_task(m_context, begin, end);
+	}
+}
+
+void ThreadPool::WorkerLoop()
+{
+	unsigned long long lastJobId = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobReady.wait(lock, [this, lastJobId]() { return m_stop || m_jobId != lastJobId; });
+
+			if (m_stop)
+				return;
+
+			lastJobId = m_jobId;
+		}
+
+		RunChunks();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (--m_busyWorkers == 0)
+			m_jobDone.notify_one();
+	}
+}
\ No newline at end of file
@@ -37,7 +37,7 @@
 #include "Contact/ParticleCable.hpp"
 #include "Contact/ParticleRod.hpp"
 
-#include "Collision/BVHNode.hpp"
+#include "Collision/BVH.hpp"
 
 #include "Collision/Primitives/Sphere.hpp"
 #include "Collision/Primitives/Plane.hpp"
@@ -84,10 +84,10 @@ void CreateSphere(std::vector<glm::vec3>& sphereVertices, float radius, int slic
 void LoadTexture(unsigned int& texture, const std::string& texturePath);
 
 void ImGuiCameraPanel();
-void ImGuiStatsPanel(float deltaTime);
+void ImGuiStatsPanel(const PhysicsSystem& physics, float deltaTime);
 void ImGuiSceneSelectionPanel(Scene& currentScene);
-void ImGuiBroadPhasePanel(PotentialContact* potentialContact, unsigned int potentialContactsCount, PotentialContactPrimitive* potentialContactPrimitive, unsigned int potentialContactPrimitiveCount);
-void ImGuiNarrowPhasePanel(std::vector<std::shared_ptr<Contact>> contacts, int contactCount);
+void ImGuiBroadPhasePanel(const PhysicsSystem& physics, const PotentialContact* potentialContact, unsigned int potentialContactsCount, const PotentialContactPrimitive* potentialContactPrimitive, unsigned int potentialContactPrimitiveCount);
+void ImGuiNarrowPhasePanel(const PhysicsSystem& physics, const Contact* contacts, int contactCount);
 
 void Scene1(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene);
 void ImGuiScene1Panel(const std::vector<std::shared_ptr<Particle>>& particles, const std::vector<glm::vec3> cubePositions);
@@ -212,12 +212,12 @@ void Scene1(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateSphere(sphereVertices, 1.f, 50, 50);
 
     std::vector<glm::vec3> spherePositions;
-    spherePositions.push_back(glm::vec3(particle1->position.x, particle1->position.y, particle1->position.z));
-    spherePositions.push_back(glm::vec3(particle2->position.x, particle2->position.y, particle2->position.z));
-    spherePositions.push_back(glm::vec3(particle3a->position.x, particle3a->position.y, particle3a->position.z));
-    spherePositions.push_back(glm::vec3(particle3b->position.x, particle3b->position.y, particle3b->position.z));
-    spherePositions.push_back(glm::vec3(particle4->position.x, particle4->position.y, particle4->position.z));
-    spherePositions.push_back(glm::vec3(particle5->position.x, particle5->position.y, particle5->position.z));
+    spherePositions.push_back(glm::vec3(particle1->GetPosition().x, particle1->GetPosition().y, particle1->GetPosition().z));
+    spherePositions.push_back(glm::vec3(particle2->GetPosition().x, particle2->GetPosition().y, particle2->GetPosition().z));
+    spherePositions.push_back(glm::vec3(particle3a->GetPosition().x, particle3a->GetPosition().y, particle3a->GetPosition().z));
+    spherePositions.push_back(glm::vec3(particle3b->GetPosition().x, particle3b->GetPosition().y, particle3b->GetPosition().z));
+    spherePositions.push_back(glm::vec3(particle4->GetPosition().x, particle4->GetPosition().y, particle4->GetPosition().z));
+    spherePositions.push_back(glm::vec3(particle5->GetPosition().x, particle5->GetPosition().y, particle5->GetPosition().z));
 
     GLuint VAO1, VBO1;
     glGenVertexArrays(1, &VAO1);
@@ -266,8 +266,8 @@ void Scene1(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     double currentTime = HiresTimeInSeconds();
     double accumulator = 0.0;
 
-    State previous;
-    State current;
+    StateBuffer states;
+    State state;
 #pragma endregion
 
     glm::mat4 model = glm::mat4(1.0f);
@@ -286,14 +286,14 @@ void Scene1(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
         while (accumulator >= dt)
         {
-            previous = current;
-            physics.Update(current, dt, true, false);
+            states.Swap();
+            physics.Update(states.GetCurrent(), dt, true, false);
             accumulator -= dt;
             t += dt;
         }
 
         const double alpha = accumulator / dt;
-        State state = current * alpha + previous * (1.0 - alpha);
+        states.Interpolate(static_cast<float>(alpha), state);
 
         ProcessCameraInput(window.GetHandle(), dt);
         ProcessSceneInput(window.GetHandle(), currentScene);
@@ -309,12 +309,12 @@ void Scene1(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         ourShader.SetMat4("view", view);
 
         // Update Spheres Positions
-        spherePositions[0] = glm::vec3(particle1->position.x, particle1->position.y, particle1->position.z);
-        spherePositions[1] = glm::vec3(particle2->position.x, particle2->position.y, particle2->position.z);
-        spherePositions[2] = glm::vec3(particle3a->position.x, particle3a->position.y, particle3a->position.z);
-        spherePositions[3] = glm::vec3(particle3b->position.x, particle3b->position.y, particle3b->position.z);
-        spherePositions[4] = glm::vec3(particle4->position.x, particle4->position.y, particle4->position.z);
-        spherePositions[5] = glm::vec3(particle5->position.x, particle5->position.y, particle5->position.z);
+        spherePositions[0] = glm::vec3(particle1->GetPosition().x, particle1->GetPosition().y, particle1->GetPosition().z);
+        spherePositions[1] = glm::vec3(particle2->GetPosition().x, particle2->GetPosition().y, particle2->GetPosition().z);
+        spherePositions[2] = glm::vec3(particle3a->GetPosition().x, particle3a->GetPosition().y, particle3a->GetPosition().z);
+        spherePositions[3] = glm::vec3(particle3b->GetPosition().x, particle3b->GetPosition().y, particle3b->GetPosition().z);
+        spherePositions[4] = glm::vec3(particle4->GetPosition().x, particle4->GetPosition().y, particle4->GetPosition().z);
+        spherePositions[5] = glm::vec3(particle5->GetPosition().x, particle5->GetPosition().y, particle5->GetPosition().z);
 
         // Render Spheres
         for (int i = 0; i < spherePositions.size(); ++i)
@@ -339,7 +339,7 @@ void Scene1(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         imguiCpp.NewFrame();
         // Add imgui panels here
         ImGuiCameraPanel();
-        ImGuiStatsPanel(dt);
+        ImGuiStatsPanel(physics, dt);
         ImGuiSceneSelectionPanel(currentScene);
         ImGuiScene1Panel(physics.GetParticles(), cubePositions);
         imguiCpp.Render();
@@ -363,10 +363,10 @@ void ImGuiScene1Panel(const std::vector<std::shared_ptr<Particle>>& particles, c
     for (auto& particle : particles)
     {
         ImGui::Text("%s", particle->name.c_str());
-        ImGui::Text("Position: %f, %f, %f", particle->position.x, particle->position.y, particle->position.z);
-        ImGui::Text("Velocity: %f, %f, %f", particle->velocity.x, particle->velocity.y, particle->velocity.z);
+        ImGui::Text("Position: %f, %f, %f", particle->GetPosition().x, particle->GetPosition().y, particle->GetPosition().z);
+        ImGui::Text("Velocity: %f, %f, %f", particle->GetVelocity().x, particle->GetVelocity().y, particle->GetVelocity().z);
         ImGui::Text("Acceleration: %f, %f, %f", particle->GetAcceleration().x, particle->GetAcceleration().y, particle->GetAcceleration().z);
-        ImGui::Text("Mass: %f", particle->mass);
+        ImGui::Text("Mass: %f", particle->GetMass());
         ImGui::Separator();
     }
     ImGui::End();
@@ -449,15 +449,15 @@ void Scene2(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateSphere(sphereVertices, 1.f, 50, 50);
 
     std::vector<glm::vec3> spherePositions;
-    spherePositions.push_back(glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody3a->position.x, rigidbody3a->position.y, rigidbody3a->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody3b->position.x, rigidbody3b->position.y, rigidbody3b->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody3c->position.x, rigidbody3c->position.y, rigidbody3c->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody3d->position.x, rigidbody3d->position.y, rigidbody3d->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody4->position.x, rigidbody4->position.y, rigidbody4->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody4b->position.x, rigidbody4b->position.y, rigidbody4b->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody5->position.x, rigidbody5->position.y, rigidbody5->position.z));
+    spherePositions.push_back(glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody3a->GetPosition().x, rigidbody3a->GetPosition().y, rigidbody3a->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody3b->GetPosition().x, rigidbody3b->GetPosition().y, rigidbody3b->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody3c->GetPosition().x, rigidbody3c->GetPosition().y, rigidbody3c->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody3d->GetPosition().x, rigidbody3d->GetPosition().y, rigidbody3d->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody4->GetPosition().x, rigidbody4->GetPosition().y, rigidbody4->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody4b->GetPosition().x, rigidbody4b->GetPosition().y, rigidbody4b->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody5->GetPosition().x, rigidbody5->GetPosition().y, rigidbody5->GetPosition().z));
 
     GLuint VAO1, VBO1;
     glGenVertexArrays(1, &VAO1);
@@ -510,8 +510,8 @@ void Scene2(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     double currentTime = HiresTimeInSeconds();
     double accumulator = 0.0;
 
-    State previous;
-    State current;
+    StateBuffer states;
+    State state;
 #pragma endregion
 
     glm::mat4 model = glm::mat4(1.0f);
@@ -530,14 +530,14 @@ void Scene2(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
         while (accumulator >= dt)
         {
-            previous = current;
-            physics.Update(current, dt, true, false);
+            states.Swap();
+            physics.Update(states.GetCurrent(), dt, true, false);
             accumulator -= dt;
             t += dt;
         }
 
         const double alpha = accumulator / dt;
-        State state = current * alpha + previous * (1.0 - alpha);
+        states.Interpolate(static_cast<float>(alpha), state);
 
         ProcessCameraInput(window.GetHandle(), dt);
         ProcessSceneInput(window.GetHandle(), currentScene);
@@ -553,15 +553,15 @@ void Scene2(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         ourShader.SetMat4("view", view);
 
         // Update Spheres Positions
-        spherePositions[0] = glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z);
-        spherePositions[1] = glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z);
-        spherePositions[2] = glm::vec3(rigidbody3a->position.x, rigidbody3a->position.y, rigidbody3a->position.z);
-        spherePositions[3] = glm::vec3(rigidbody3b->position.x, rigidbody3b->position.y, rigidbody3b->position.z);
-        spherePositions[4] = glm::vec3(rigidbody3c->position.x, rigidbody3c->position.y, rigidbody3c->position.z);
-        spherePositions[5] = glm::vec3(rigidbody3d->position.x, rigidbody3d->position.y, rigidbody3d->position.z);
-        spherePositions[6] = glm::vec3(rigidbody4->position.x, rigidbody4->position.y, rigidbody4->position.z);
-        spherePositions[7] = glm::vec3(rigidbody4b->position.x, rigidbody4b->position.y, rigidbody4b->position.z);
-        spherePositions[8] = glm::vec3(rigidbody5->position.x, rigidbody5->position.y, rigidbody5->position.z);
+        spherePositions[0] = glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z);
+        spherePositions[1] = glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z);
+        spherePositions[2] = glm::vec3(rigidbody3a->GetPosition().x, rigidbody3a->GetPosition().y, rigidbody3a->GetPosition().z);
+        spherePositions[3] = glm::vec3(rigidbody3b->GetPosition().x, rigidbody3b->GetPosition().y, rigidbody3b->GetPosition().z);
+        spherePositions[4] = glm::vec3(rigidbody3c->GetPosition().x, rigidbody3c->GetPosition().y, rigidbody3c->GetPosition().z);
+        spherePositions[5] = glm::vec3(rigidbody3d->GetPosition().x, rigidbody3d->GetPosition().y, rigidbody3d->GetPosition().z);
+        spherePositions[6] = glm::vec3(rigidbody4->GetPosition().x, rigidbody4->GetPosition().y, rigidbody4->GetPosition().z);
+        spherePositions[7] = glm::vec3(rigidbody4b->GetPosition().x, rigidbody4b->GetPosition().y, rigidbody4b->GetPosition().z);
+        spherePositions[8] = glm::vec3(rigidbody5->GetPosition().x, rigidbody5->GetPosition().y, rigidbody5->GetPosition().z);
 
         // Render Spheres
         for (int i = 0; i < spherePositions.size(); ++i)
@@ -594,7 +594,7 @@ void Scene2(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         imguiCpp.NewFrame();
         // Add imgui panels here
         ImGuiCameraPanel();
-        ImGuiStatsPanel(dt);
+        ImGuiStatsPanel(physics, dt);
         ImGuiSceneSelectionPanel(currentScene);
         ImGuiScene2Panel(physics.GetRigidbodies(), cubePositions);
         imguiCpp.Render();
@@ -618,21 +618,21 @@ void ImGuiScene2Panel(const std::vector<std::shared_ptr<Rigidbody>>& rigidbodies
     for (auto& rigidbody : rigidbodies)
     {
         ImGui::Text("%s", rigidbody->name.c_str());
-        ImGui::Text("Position: %f, %f, %f", rigidbody->position.x, rigidbody->position.y, rigidbody->position.z);
-        ImGui::Text("Rotation: %f, %f, %f", rigidbody->rotation.GetX(), rigidbody->rotation.GetY(), rigidbody->rotation.GetZ());
+        ImGui::Text("Position: %f, %f, %f", rigidbody->GetPosition().x, rigidbody->GetPosition().y, rigidbody->GetPosition().z);
+        ImGui::Text("Rotation: %f, %f, %f", rigidbody->GetRotation().GetX(), rigidbody->GetRotation().GetY(), rigidbody->GetRotation().GetZ());
         ImGui::Text("Scale: %f, %f, %f", rigidbody->scale.x, rigidbody->scale.y, rigidbody->scale.z);
-        ImGui::Text("Velocity: %f, %f, %f", rigidbody->velocity.x, rigidbody->velocity.y, rigidbody->velocity.z);
+        ImGui::Text("Velocity: %f, %f, %f", rigidbody->GetVelocity().x, rigidbody->GetVelocity().y, rigidbody->GetVelocity().z);
         ImGui::Text("Acceleration: %f, %f, %f", rigidbody->GetAcceleration().x, rigidbody->GetAcceleration().y, rigidbody->GetAcceleration().z);
-        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->angularVelocity.x, rigidbody->angularVelocity.y, rigidbody->angularVelocity.z);
+        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->GetAngularVelocity().x, rigidbody->GetAngularVelocity().y, rigidbody->GetAngularVelocity().z);
         ImGui::Text("AngularAcceleration: %f, %f, %f", rigidbody->GetAngularAcceleration().x, rigidbody->GetAngularAcceleration().y, rigidbody->GetAngularAcceleration().z);
-        ImGui::Text("Mass: %f", rigidbody->mass);
-        ImGui::Text("Inverse Mass: %f", rigidbody->inverseMass);
+        ImGui::Text("Mass: %f", rigidbody->GetMass());
+        ImGui::Text("Inverse Mass: %f", rigidbody->GetInverseMass());
         ImGui::Text("%s transformMatrix:\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f",
             rigidbody->name.c_str(),
-            rigidbody->transformMatrix.Value(0, 0), rigidbody->transformMatrix.Value(0, 1), rigidbody->transformMatrix.Value(0, 2), rigidbody->transformMatrix.Value(0, 3),
-            rigidbody->transformMatrix.Value(1, 0), rigidbody->transformMatrix.Value(1, 1), rigidbody->transformMatrix.Value(1, 2), rigidbody->transformMatrix.Value(1, 3),
-            rigidbody->transformMatrix.Value(2, 0), rigidbody->transformMatrix.Value(2, 1), rigidbody->transformMatrix.Value(2, 2), rigidbody->transformMatrix.Value(2, 3),
-            rigidbody->transformMatrix.Value(3, 0), rigidbody->transformMatrix.Value(3, 1), rigidbody->transformMatrix.Value(3, 2), rigidbody->transformMatrix.Value(3, 3));
+            rigidbody->GetTransformMatrix().Value(0, 0), rigidbody->GetTransformMatrix().Value(0, 1), rigidbody->GetTransformMatrix().Value(0, 2), rigidbody->GetTransformMatrix().Value(0, 3),
+            rigidbody->GetTransformMatrix().Value(1, 0), rigidbody->GetTransformMatrix().Value(1, 1), rigidbody->GetTransformMatrix().Value(1, 2), rigidbody->GetTransformMatrix().Value(1, 3),
+            rigidbody->GetTransformMatrix().Value(2, 0), rigidbody->GetTransformMatrix().Value(2, 1), rigidbody->GetTransformMatrix().Value(2, 2), rigidbody->GetTransformMatrix().Value(2, 3),
+            rigidbody->GetTransformMatrix().Value(3, 0), rigidbody->GetTransformMatrix().Value(3, 1), rigidbody->GetTransformMatrix().Value(3, 2), rigidbody->GetTransformMatrix().Value(3, 3));
         ImGui::Separator();
     }
     ImGui::End();
@@ -679,13 +679,13 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     rigidbody3->m_boundingSphere = boundingSphere3;
 
 
-    std::shared_ptr<BVHNode> bvhRoot = std::make_shared<BVHNode>(sphere);
-    bvhRoot->Insert(box, boundingSphere2);
-    bvhRoot->Insert(sphere2, boundingSphere3);
+    std::shared_ptr<Primitive> primitives[] = { sphere, box, sphere2 };
+    BoundingSphere volumes[] = { *boundingSphere1, *boundingSphere2, *boundingSphere3 };
 
-    physics.AddRootBVHNode(bvhRoot);
-    PotentialContact* potentialContacts = new PotentialContact;
-    PotentialContactPrimitive* potentialContactsPrimitive = new PotentialContactPrimitive;
+    std::shared_ptr<BVH<BoundingSphere>> bvh = std::make_shared<BVH<BoundingSphere>>();
+    bvh->Build(primitives, volumes, 3);
+
+    physics.SetBroadPhase(bvh);
 #pragma endregion
 
 #pragma region Shader
@@ -702,9 +702,9 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateSphere(sphereVertices, 1.f, 50, 50);
 
     std::vector<glm::vec3> spherePositions;
-    spherePositions.push_back(glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z));
-    spherePositions.push_back(glm::vec3(rigidbody3->position.x, rigidbody3->position.y, rigidbody3->position.z));
+    spherePositions.push_back(glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody3->GetPosition().x, rigidbody3->GetPosition().y, rigidbody3->GetPosition().z));
 
     GLuint VAO1, VBO1;
     glGenVertexArrays(1, &VAO1);
@@ -723,7 +723,7 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateCube(cubeVertices, cubeTexCoords, 1.0f);
 
     std::vector<glm::vec3> cubePositions;
-    cubePositions.push_back(glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z));
+    cubePositions.push_back(glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z));
 
     GLuint VAO2, VBO2;
     glGenVertexArrays(1, &VAO2);
@@ -759,8 +759,8 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     double currentTime = HiresTimeInSeconds();
     double accumulator = 0.0;
 
-    State previous;
-    State current;
+    StateBuffer states;
+    State state;
 #pragma endregion
 
     glm::mat4 model = glm::mat4(1.0f);
@@ -779,14 +779,14 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
         while (accumulator >= dt)
         {
-            previous = current;
-            physics.Update(current, dt, true, true);
+            states.Swap();
+            physics.Update(states.GetCurrent(), dt, true, true);
             accumulator -= dt;
             t += dt;
         }
 
         const double alpha = accumulator / dt;
-        State state = current * alpha + previous * (1.0 - alpha);
+        states.Interpolate(static_cast<float>(alpha), state);
 
         ProcessCameraInput(window.GetHandle(), dt);
         ProcessSceneInput(window.GetHandle(), currentScene);
@@ -798,10 +798,10 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
         // Render Bounding 
         //std::vector<glm::vec3> boundingSphereVertices;
-        //CreateSphere(boundingSphereVertices, bvhRoot->m_volume->GetRadius() * 2.0f + 0.5f, 30, 30);
+        //CreateSphere(boundingSphereVertices, bvh->GetVolume(bvh->GetRoot()).GetRadius() * 2.0f + 0.5f, 30, 30);
 
         //std::vector<glm::vec3> boundingSpherePositions;
-        //boundingSpherePositions.push_back(glm::vec3(bvhRoot->m_volume->GetCenter().x, bvhRoot->m_volume->GetCenter().y, bvhRoot->m_volume->GetCenter().z));
+        //boundingSpherePositions.push_back(glm::vec3(bvh->GetVolume(bvh->GetRoot()).GetCenter().x, bvh->GetVolume(bvh->GetRoot()).GetCenter().y, bvh->GetVolume(bvh->GetRoot()).GetCenter().z));
 
         //glBindVertexArray(VAO3);
         //glBufferData(GL_ARRAY_BUFFER, boundingSphereVertices.size() * sizeof(glm::vec3), boundingSphereVertices.data(), GL_STATIC_DRAW);
@@ -815,9 +815,9 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         ourShader.SetMat4("view", view);
 
         // Update Spheres Positions
-        spherePositions[0] = glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z);
-        spherePositions[1] = glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z);
-        spherePositions[2] = glm::vec3(rigidbody3->position.x, rigidbody3->position.y, rigidbody3->position.z);
+        spherePositions[0] = glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z);
+        spherePositions[1] = glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z);
+        spherePositions[2] = glm::vec3(rigidbody3->GetPosition().x, rigidbody3->GetPosition().y, rigidbody3->GetPosition().z);
 
         // Render Spheres 
         for (int i = 0; i < spherePositions.size(); ++i)
@@ -852,10 +852,10 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         imguiCpp.NewFrame();
         // Add imgui panels here
         ImGuiCameraPanel();
-        ImGuiStatsPanel(dt);
+        ImGuiStatsPanel(physics, dt);
         ImGuiSceneSelectionPanel(currentScene);
         ImGuiScene3Panel(physics.GetRigidbodies(), cubePositions);
-        ImGuiBroadPhasePanel(physics.GetPotentialContactArray(), physics.GetPotentialContactCount(), physics.GetPotentialContactPrimitiveArray(), physics.GetPotentialContactPrimitiveCount());
+        ImGuiBroadPhasePanel(physics, physics.GetPotentialContactArray(), physics.GetPotentialContactCount(), physics.GetPotentialContactPrimitiveArray(), physics.GetPotentialContactPrimitiveCount());
         imguiCpp.Render();
 
         glfwSwapBuffers(window.GetHandle());
@@ -868,9 +868,6 @@ void Scene3(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     glDeleteBuffers(1, &VBO2);
     glDeleteVertexArrays(1, &VAO3);
     glDeleteBuffers(1, &VBO3);
-
-    delete(potentialContacts);
-    delete(potentialContactsPrimitive);
 }
 
 void ImGuiScene3Panel(const std::vector<std::shared_ptr<Rigidbody>>& rigidbodies, const std::vector<glm::vec3> cubesPositions)
@@ -882,21 +879,21 @@ void ImGuiScene3Panel(const std::vector<std::shared_ptr<Rigidbody>>& rigidbodies
     for (auto& rigidbody : rigidbodies)
     {
         ImGui::Text("%s", rigidbody->name.c_str());
-        ImGui::Text("Position: %f, %f, %f", rigidbody->position.x, rigidbody->position.y, rigidbody->position.z);
-        ImGui::Text("Rotation: %f, %f, %f", rigidbody->rotation.GetX(), rigidbody->rotation.GetY(), rigidbody->rotation.GetZ());
+        ImGui::Text("Position: %f, %f, %f", rigidbody->GetPosition().x, rigidbody->GetPosition().y, rigidbody->GetPosition().z);
+        ImGui::Text("Rotation: %f, %f, %f", rigidbody->GetRotation().GetX(), rigidbody->GetRotation().GetY(), rigidbody->GetRotation().GetZ());
         ImGui::Text("Scale: %f, %f, %f", rigidbody->scale.x, rigidbody->scale.y, rigidbody->scale.z);
-        ImGui::Text("Velocity: %f, %f, %f", rigidbody->velocity.x, rigidbody->velocity.y, rigidbody->velocity.z);
+        ImGui::Text("Velocity: %f, %f, %f", rigidbody->GetVelocity().x, rigidbody->GetVelocity().y, rigidbody->GetVelocity().z);
         ImGui::Text("Acceleration: %f, %f, %f", rigidbody->GetAcceleration().x, rigidbody->GetAcceleration().y, rigidbody->GetAcceleration().z);
-        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->angularVelocity.x, rigidbody->angularVelocity.y, rigidbody->angularVelocity.z);
+        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->GetAngularVelocity().x, rigidbody->GetAngularVelocity().y, rigidbody->GetAngularVelocity().z);
         ImGui::Text("AngularAcceleration: %f, %f, %f", rigidbody->GetAngularAcceleration().x, rigidbody->GetAngularAcceleration().y, rigidbody->GetAngularAcceleration().z);
-        ImGui::Text("Mass: %f", rigidbody->mass);
-        ImGui::Text("Inverse Mass: %f", rigidbody->inverseMass);
+        ImGui::Text("Mass: %f", rigidbody->GetMass());
+        ImGui::Text("Inverse Mass: %f", rigidbody->GetInverseMass());
         ImGui::Text("%s transformMatrix:\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f",
             rigidbody->name.c_str(),
-            rigidbody->transformMatrix.Value(0, 0), rigidbody->transformMatrix.Value(0, 1), rigidbody->transformMatrix.Value(0, 2), rigidbody->transformMatrix.Value(0, 3),
-            rigidbody->transformMatrix.Value(1, 0), rigidbody->transformMatrix.Value(1, 1), rigidbody->transformMatrix.Value(1, 2), rigidbody->transformMatrix.Value(1, 3),
-            rigidbody->transformMatrix.Value(2, 0), rigidbody->transformMatrix.Value(2, 1), rigidbody->transformMatrix.Value(2, 2), rigidbody->transformMatrix.Value(2, 3),
-            rigidbody->transformMatrix.Value(3, 0), rigidbody->transformMatrix.Value(3, 1), rigidbody->transformMatrix.Value(3, 2), rigidbody->transformMatrix.Value(3, 3));
+            rigidbody->GetTransformMatrix().Value(0, 0), rigidbody->GetTransformMatrix().Value(0, 1), rigidbody->GetTransformMatrix().Value(0, 2), rigidbody->GetTransformMatrix().Value(0, 3),
+            rigidbody->GetTransformMatrix().Value(1, 0), rigidbody->GetTransformMatrix().Value(1, 1), rigidbody->GetTransformMatrix().Value(1, 2), rigidbody->GetTransformMatrix().Value(1, 3),
+            rigidbody->GetTransformMatrix().Value(2, 0), rigidbody->GetTransformMatrix().Value(2, 1), rigidbody->GetTransformMatrix().Value(2, 2), rigidbody->GetTransformMatrix().Value(2, 3),
+            rigidbody->GetTransformMatrix().Value(3, 0), rigidbody->GetTransformMatrix().Value(3, 1), rigidbody->GetTransformMatrix().Value(3, 2), rigidbody->GetTransformMatrix().Value(3, 3));
         ImGui::Separator();
     }
     ImGui::End();
@@ -924,8 +921,8 @@ void Scene4(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
 #pragma region Narrow Phase
 
-    ContactGenerator contactGenerator = ContactGenerator(50);
-    ContactResolver contactResolver = ContactResolver(50);
+    ContactGenerator contactGenerator = ContactGenerator(50, physics.GetRigidbodyStorage());
+    ContactResolver contactResolver = ContactResolver(50, physics.GetRigidbodyStorage());
 
     Plane plane = Plane(nullptr, Matrix4f(), Vector3f(0, 1, 0), 0.f);
 
@@ -949,7 +946,7 @@ void Scene4(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateSphere(sphereVertices, 1.f, 50, 50);
 
     std::vector<glm::vec3> spherePositions;
-    spherePositions.push_back(glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z));
+    spherePositions.push_back(glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z));
 
     GLuint VAO1, VBO1;
     glGenVertexArrays(1, &VAO1);
@@ -968,7 +965,7 @@ void Scene4(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateCube(cubeVertices, cubeTexCoords, 1.0f);
 
     std::vector<glm::vec3> cubePositions;
-    cubePositions.push_back(glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z));
+    cubePositions.push_back(glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z));
 
     GLuint VAO2, VBO2;
     glGenVertexArrays(1, &VAO2);
@@ -998,8 +995,8 @@ void Scene4(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     double currentTime = HiresTimeInSeconds();
     double accumulator = 0.0;
 
-    State previous;
-    State current;
+    StateBuffer states;
+    State state;
 #pragma endregion
 
     glm::mat4 model = glm::mat4(1.0f);
@@ -1018,20 +1015,21 @@ void Scene4(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
         while (accumulator >= dt)
         {
-            previous = current;
-            physics.Update(current, dt, true);
+            states.Swap();
+            physics.Update(states.GetCurrent(), dt, true);
             accumulator -= dt;
             t += dt;
         }
 
         const double alpha = accumulator / dt;
-        State state = current * alpha + previous * (1.0 - alpha);
+        states.Interpolate(static_cast<float>(alpha), state);
 
         //contactGenerator.DetectSandHS(sphere, plane);
         //contactGenerator.DetectBandP(box, plane);
         //contactGenerator.DetectSandB(sphere, box);
         contactGenerator.DetectSandHS(sphere, plane);
-        contactResolver.ResolveContacts(contactGenerator.GetContacts(), dt, state);
+        contactResolver.ResolveContacts(contactGenerator.GetContacts(), contactGenerator.GetCurrentContacts(), dt, state);
+        contactGenerator.Reset();
 
         ProcessCameraInput(window.GetHandle(), dt);
         ProcessSceneInput(window.GetHandle(), currentScene);
@@ -1047,8 +1045,8 @@ void Scene4(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         ourShader.SetMat4("view", view);
 
         // Update Spheres Positions
-        spherePositions[0] = glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z);
-        spherePositions[1] = glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z);
+        spherePositions[0] = glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z);
+        spherePositions[1] = glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z);
 
         // Render Spheres 
         for (int i = 0; i < spherePositions.size(); ++i)
@@ -1074,10 +1072,10 @@ void Scene4(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         imguiCpp.NewFrame();
         // Add imgui panels here
         ImGuiCameraPanel();
-        ImGuiStatsPanel(dt);
+        ImGuiStatsPanel(physics, dt);
         ImGuiSceneSelectionPanel(currentScene);
         ImGuiScene4Panel(physics.GetRigidbodies(), cubePositions);
-        //ImGuiNarrowPhasePanel(physics.GetContactsArray(), physics.GetContactCount());
+        //ImGuiNarrowPhasePanel(physics, physics.GetContactsArray(), physics.GetContactCount());
         imguiCpp.Render();
 
         glfwSwapBuffers(window.GetHandle());
@@ -1099,21 +1097,21 @@ void ImGuiScene4Panel(const std::vector<std::shared_ptr<Rigidbody>>& rigidbodies
     for (auto& rigidbody : rigidbodies)
     {
         ImGui::Text("%s", rigidbody->name.c_str());
-        ImGui::Text("Position: %f, %f, %f", rigidbody->position.x, rigidbody->position.y, rigidbody->position.z);
-        ImGui::Text("Rotation: %f, %f, %f", rigidbody->rotation.GetX(), rigidbody->rotation.GetY(), rigidbody->rotation.GetZ());
+        ImGui::Text("Position: %f, %f, %f", rigidbody->GetPosition().x, rigidbody->GetPosition().y, rigidbody->GetPosition().z);
+        ImGui::Text("Rotation: %f, %f, %f", rigidbody->GetRotation().GetX(), rigidbody->GetRotation().GetY(), rigidbody->GetRotation().GetZ());
         ImGui::Text("Scale: %f, %f, %f", rigidbody->scale.x, rigidbody->scale.y, rigidbody->scale.z);
-        ImGui::Text("Velocity: %f, %f, %f", rigidbody->velocity.x, rigidbody->velocity.y, rigidbody->velocity.z);
+        ImGui::Text("Velocity: %f, %f, %f", rigidbody->GetVelocity().x, rigidbody->GetVelocity().y, rigidbody->GetVelocity().z);
         ImGui::Text("Acceleration: %f, %f, %f", rigidbody->GetAcceleration().x, rigidbody->GetAcceleration().y, rigidbody->GetAcceleration().z);
-        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->angularVelocity.x, rigidbody->angularVelocity.y, rigidbody->angularVelocity.z);
+        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->GetAngularVelocity().x, rigidbody->GetAngularVelocity().y, rigidbody->GetAngularVelocity().z);
         ImGui::Text("AngularAcceleration: %f, %f, %f", rigidbody->GetAngularAcceleration().x, rigidbody->GetAngularAcceleration().y, rigidbody->GetAngularAcceleration().z);
-        ImGui::Text("Mass: %f", rigidbody->mass);
-        ImGui::Text("Inverse Mass: %f", rigidbody->inverseMass);
+        ImGui::Text("Mass: %f", rigidbody->GetMass());
+        ImGui::Text("Inverse Mass: %f", rigidbody->GetInverseMass());
         ImGui::Text("%s transformMatrix:\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f",
             rigidbody->name.c_str(),
-            rigidbody->transformMatrix.Value(0, 0), rigidbody->transformMatrix.Value(0, 1), rigidbody->transformMatrix.Value(0, 2), rigidbody->transformMatrix.Value(0, 3),
-            rigidbody->transformMatrix.Value(1, 0), rigidbody->transformMatrix.Value(1, 1), rigidbody->transformMatrix.Value(1, 2), rigidbody->transformMatrix.Value(1, 3),
-            rigidbody->transformMatrix.Value(2, 0), rigidbody->transformMatrix.Value(2, 1), rigidbody->transformMatrix.Value(2, 2), rigidbody->transformMatrix.Value(2, 3),
-            rigidbody->transformMatrix.Value(3, 0), rigidbody->transformMatrix.Value(3, 1), rigidbody->transformMatrix.Value(3, 2), rigidbody->transformMatrix.Value(3, 3));
+            rigidbody->GetTransformMatrix().Value(0, 0), rigidbody->GetTransformMatrix().Value(0, 1), rigidbody->GetTransformMatrix().Value(0, 2), rigidbody->GetTransformMatrix().Value(0, 3),
+            rigidbody->GetTransformMatrix().Value(1, 0), rigidbody->GetTransformMatrix().Value(1, 1), rigidbody->GetTransformMatrix().Value(1, 2), rigidbody->GetTransformMatrix().Value(1, 3),
+            rigidbody->GetTransformMatrix().Value(2, 0), rigidbody->GetTransformMatrix().Value(2, 1), rigidbody->GetTransformMatrix().Value(2, 2), rigidbody->GetTransformMatrix().Value(2, 3),
+            rigidbody->GetTransformMatrix().Value(3, 0), rigidbody->GetTransformMatrix().Value(3, 1), rigidbody->GetTransformMatrix().Value(3, 2), rigidbody->GetTransformMatrix().Value(3, 3));
         ImGui::Separator();
     }
     ImGui::End();
@@ -1128,13 +1126,22 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
 #pragma region Rigidbodies
     std::shared_ptr<Rigidbody> rigidbody1 = std::make_shared<Rigidbody>("Rigidbody 1 Sphere", Vector3f::Up * 13.0f);
-    std::shared_ptr<Rigidbody> rigidbody2 = std::make_shared<Rigidbody>("Rigidbody 2 Plane", RigidbodyType::CUBE, Vector3f::Zero, Vector3f(2.0f, .0f, 2.0f), 1.0f);
+    // Without mass the ground is static, neither gravity nor the sphere moves it
+    std::shared_ptr<Rigidbody> rigidbody2 = std::make_shared<Rigidbody>("Rigidbody 2 Plane", RigidbodyType::CUBE, Vector3f::Zero, Vector3f(2.0f, .0f, 2.0f), 0.0f);
+
+    // A second sphere falls on a static box, which never moves and goes to the static tree of the BVH
+    std::shared_ptr<Rigidbody> rigidbody3 = std::make_shared<Rigidbody>("Rigidbody 3 Sphere", Vector3f(4.0f, 10.0f, 0.0f));
+    std::shared_ptr<Rigidbody> rigidbody4 = std::make_shared<Rigidbody>("Rigidbody 4 Static Box", RigidbodyType::CUBE, Vector3f(4.0f, 1.0f, 0.0f), 0.0f);
 
     physics.AddRigidbody(rigidbody1);
     physics.AddRigidbody(rigidbody2);
+    physics.AddRigidbody(rigidbody3);
+    physics.AddRigidbody(rigidbody4);
 
     std::shared_ptr<Sphere> sphere = std::make_shared<Sphere>(rigidbody1, Matrix4f(), 1.f);
     std::shared_ptr<Plane> plane = std::make_shared<Plane>(rigidbody2, Matrix4f(), Vector3f(0, 1, 0), 0.f);
+    std::shared_ptr<Sphere> sphere2 = std::make_shared<Sphere>(rigidbody3, Matrix4f(), 1.f);
+    std::shared_ptr<Box> box = std::make_shared<Box>(rigidbody4, Matrix4f(), Vector3f(1.0f, 1.0f, 1.0f));
 #pragma endregion
 
 #pragma region Forces
@@ -1143,6 +1150,8 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
     forceRegistry->Add(rigidbody1, gravity);
     forceRegistry->Add(rigidbody1, drag);
+    forceRegistry->Add(rigidbody3, gravity);
+    forceRegistry->Add(rigidbody3, drag);
 #pragma endregion
 
 #pragma region BroadPhase
@@ -1153,12 +1162,19 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     std::shared_ptr<BoundingSphere> boundingSphere2 = std::make_shared<BoundingSphere>(rigidbody2);
     rigidbody2->m_boundingSphere = boundingSphere2;
 
-    std::shared_ptr<BVHNode> bvhRoot = std::make_shared<BVHNode>(sphere);
-    bvhRoot->Insert(plane, boundingSphere2);
+    // The plane is static and tested from its equation, only the spheres and the box need a volume
+    std::shared_ptr<Primitive> primitives[] = { sphere, sphere2 };
+    BoundingBox volumes[] = { rigidbody1->GetBoundingBox(), rigidbody3->GetBoundingBox() };
 
-    physics.AddRootBVHNode(bvhRoot);
-    PotentialContact* potentialContacts = new PotentialContact;
-    PotentialContactPrimitive* potentialContactsPrimitive = new PotentialContactPrimitive;
+    std::shared_ptr<Primitive> staticPrimitives[] = { box };
+    BoundingBox staticVolumes[] = { rigidbody4->GetBoundingBox() };
+
+    std::shared_ptr<BVH<BoundingBox>> bvh = std::make_shared<BVH<BoundingBox>>();
+    bvh->Build(primitives, volumes, 2);
+    bvh->BuildStatic(staticPrimitives, staticVolumes, 1, physics.GetRigidbodyStorage());
+    bvh->AddStaticPlane(plane);
+
+    physics.SetBroadPhase(bvh);
 #pragma endregion
 
 #pragma region Shader
@@ -1175,7 +1191,8 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateSphere(sphereVertices, 1.f, 50, 50);
 
     std::vector<glm::vec3> spherePositions;
-    spherePositions.push_back(glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z));
+    spherePositions.push_back(glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z));
+    spherePositions.push_back(glm::vec3(rigidbody3->GetPosition().x, rigidbody3->GetPosition().y, rigidbody3->GetPosition().z));
 
     GLuint VAO1, VBO1;
     glGenVertexArrays(1, &VAO1);
@@ -1194,7 +1211,10 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     CreateCube(cubeVertices, cubeTexCoords, 1.0f);
 
     std::vector<glm::vec3> cubePositions;
-    cubePositions.push_back(glm::vec3(rigidbody2->position.x, rigidbody2->position.y, rigidbody2->position.z));
+    cubePositions.push_back(glm::vec3(rigidbody2->GetPosition().x, rigidbody2->GetPosition().y, rigidbody2->GetPosition().z));
+
+    // The static box never moves
+    const glm::vec3 staticBoxPosition(rigidbody4->GetPosition().x, rigidbody4->GetPosition().y, rigidbody4->GetPosition().z);
 
     GLuint VAO2, VBO2;
     glGenVertexArrays(1, &VAO2);
@@ -1230,8 +1250,8 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     double currentTime = HiresTimeInSeconds();
     double accumulator = 0.0;
 
-    State previous;
-    State current;
+    StateBuffer states;
+    State state;
 #pragma endregion
 
     glm::mat4 model = glm::mat4(1.0f);
@@ -1250,16 +1270,14 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
 
         while (accumulator >= dt)
         {
-            previous = current;
-            physics.Update(current, dt, true, true, true, true);
+            states.Swap();
+            physics.Update(states.GetCurrent(), dt, true, true, true, true);
             accumulator -= dt;
             t += dt;
         }
 
         const double alpha = accumulator / dt;
-        State state = current * alpha + previous * (1.0 - alpha);
-        physics.m_contactGenerator->DetectSandHS(*sphere, *plane);
-        physics.m_contactResolver->ResolveContacts(physics.m_contactGenerator->GetContacts(), dt, state);
+        states.Interpolate(static_cast<float>(alpha), state);
         ProcessCameraInput(window.GetHandle(), dt);
         ProcessSceneInput(window.GetHandle(), currentScene);
 
@@ -1274,7 +1292,8 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
         ourShader.SetMat4("view", view);
 
         // Update Spheres Positions
-        spherePositions[0] = glm::vec3(rigidbody1->position.x, rigidbody1->position.y, rigidbody1->position.z);
+        spherePositions[0] = glm::vec3(rigidbody1->GetPosition().x, rigidbody1->GetPosition().y, rigidbody1->GetPosition().z);
+        spherePositions[1] = glm::vec3(rigidbody3->GetPosition().x, rigidbody3->GetPosition().y, rigidbody3->GetPosition().z);
 
         // Render Spheres 
         for (int i = 0; i < spherePositions.size(); ++i)
@@ -1297,15 +1316,23 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
             glDrawArrays(GL_TRIANGLES, 0, cubeVertices.size());
         }
 
+        // Render Static Box, twice the unit cube for its half size of 1
+        model = glm::mat4(1.0f);
+        model = glm::translate(model, staticBoxPosition);
+        model = glm::scale(model, glm::vec3(2.f, 2.f, 2.f));
+        ourShader.SetMat4("model", model);
+        glBindVertexArray(VAO2);
+        glDrawArrays(GL_TRIANGLES, 0, cubeVertices.size());
+
         imguiCpp.NewFrame();
         // Add imgui panels here
         ImGuiCameraPanel();
-        ImGuiStatsPanel(dt);
+        ImGuiStatsPanel(physics, dt);
         ImGuiSceneSelectionPanel(currentScene);
         ImGuiScene5Panel(physics.GetRigidbodies(), cubePositions);
-        ImGuiBroadPhasePanel(physics.GetPotentialContactArray(), physics.GetPotentialContactCount(), physics.GetPotentialContactPrimitiveArray(), physics.GetPotentialContactPrimitiveCount());
+        ImGuiBroadPhasePanel(physics, physics.GetPotentialContactArray(), physics.GetPotentialContactCount(), physics.GetPotentialContactPrimitiveArray(), physics.GetPotentialContactPrimitiveCount());
         // contacts get clear during physics update
-        //ImGuiNarrowPhasePanel(physics.GetContactsArray(), physics.GetContactCount());
+        //ImGuiNarrowPhasePanel(physics, physics.GetContactsArray(), physics.GetContactCount());
         imguiCpp.Render();
 
         glfwSwapBuffers(window.GetHandle());
@@ -1318,9 +1345,6 @@ void Scene5(cppGLFWwindow& window, ImguiCpp& imguiCpp, Scene& currentScene)
     glDeleteBuffers(1, &VBO2);
     glDeleteVertexArrays(1, &VAO3);
     glDeleteBuffers(1, &VBO3);
-
-    delete(potentialContacts);
-    delete(potentialContactsPrimitive);
 }
 
 void ImGuiScene5Panel(const std::vector<std::shared_ptr<Rigidbody>>& rigidbodies, const std::vector<glm::vec3> cubesPositions)
@@ -1332,21 +1356,21 @@ void ImGuiScene5Panel(const std::vector<std::shared_ptr<Rigidbody>>& rigidbodies
     for (auto& rigidbody : rigidbodies)
     {
         ImGui::Text("%s", rigidbody->name.c_str());
-        ImGui::Text("Position: %f, %f, %f", rigidbody->position.x, rigidbody->position.y, rigidbody->position.z);
-        ImGui::Text("Rotation: %f, %f, %f", rigidbody->rotation.GetX(), rigidbody->rotation.GetY(), rigidbody->rotation.GetZ());
+        ImGui::Text("Position: %f, %f, %f", rigidbody->GetPosition().x, rigidbody->GetPosition().y, rigidbody->GetPosition().z);
+        ImGui::Text("Rotation: %f, %f, %f", rigidbody->GetRotation().GetX(), rigidbody->GetRotation().GetY(), rigidbody->GetRotation().GetZ());
         ImGui::Text("Scale: %f, %f, %f", rigidbody->scale.x, rigidbody->scale.y, rigidbody->scale.z);
-        ImGui::Text("Velocity: %f, %f, %f", rigidbody->velocity.x, rigidbody->velocity.y, rigidbody->velocity.z);
+        ImGui::Text("Velocity: %f, %f, %f", rigidbody->GetVelocity().x, rigidbody->GetVelocity().y, rigidbody->GetVelocity().z);
         ImGui::Text("Acceleration: %f, %f, %f", rigidbody->GetAcceleration().x, rigidbody->GetAcceleration().y, rigidbody->GetAcceleration().z);
-        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->angularVelocity.x, rigidbody->angularVelocity.y, rigidbody->angularVelocity.z);
+        ImGui::Text("AngularVelocity: %f, %f, %f", rigidbody->GetAngularVelocity().x, rigidbody->GetAngularVelocity().y, rigidbody->GetAngularVelocity().z);
         ImGui::Text("AngularAcceleration: %f, %f, %f", rigidbody->GetAngularAcceleration().x, rigidbody->GetAngularAcceleration().y, rigidbody->GetAngularAcceleration().z);
-        ImGui::Text("Mass: %f", rigidbody->mass);
-        ImGui::Text("Inverse Mass: %f", rigidbody->inverseMass);
+        ImGui::Text("Mass: %f", rigidbody->GetMass());
+        ImGui::Text("Inverse Mass: %f", rigidbody->GetInverseMass());
         ImGui::Text("%s transformMatrix:\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f\n%f\t%f\t%f\t%f",
             rigidbody->name.c_str(),
-            rigidbody->transformMatrix.Value(0, 0), rigidbody->transformMatrix.Value(0, 1), rigidbody->transformMatrix.Value(0, 2), rigidbody->transformMatrix.Value(0, 3),
-            rigidbody->transformMatrix.Value(1, 0), rigidbody->transformMatrix.Value(1, 1), rigidbody->transformMatrix.Value(1, 2), rigidbody->transformMatrix.Value(1, 3),
-            rigidbody->transformMatrix.Value(2, 0), rigidbody->transformMatrix.Value(2, 1), rigidbody->transformMatrix.Value(2, 2), rigidbody->transformMatrix.Value(2, 3),
-            rigidbody->transformMatrix.Value(3, 0), rigidbody->transformMatrix.Value(3, 1), rigidbody->transformMatrix.Value(3, 2), rigidbody->transformMatrix.Value(3, 3));
+            rigidbody->GetTransformMatrix().Value(0, 0), rigidbody->GetTransformMatrix().Value(0, 1), rigidbody->GetTransformMatrix().Value(0, 2), rigidbody->GetTransformMatrix().Value(0, 3),
+            rigidbody->GetTransformMatrix().Value(1, 0), rigidbody->GetTransformMatrix().Value(1, 1), rigidbody->GetTransformMatrix().Value(1, 2), rigidbody->GetTransformMatrix().Value(1, 3),
+            rigidbody->GetTransformMatrix().Value(2, 0), rigidbody->GetTransformMatrix().Value(2, 1), rigidbody->GetTransformMatrix().Value(2, 2), rigidbody->GetTransformMatrix().Value(2, 3),
+            rigidbody->GetTransformMatrix().Value(3, 0), rigidbody->GetTransformMatrix().Value(3, 1), rigidbody->GetTransformMatrix().Value(3, 2), rigidbody->GetTransformMatrix().Value(3, 3));
         ImGui::Separator();
     }
     ImGui::End();
@@ -1591,11 +1615,12 @@ void ImGuiCameraPanel()
     ImGui::End();
 }
 
-void ImGuiStatsPanel(float deltaTime)
+void ImGuiStatsPanel(const PhysicsSystem& physics, float deltaTime)
 {
     ImGui::Begin("Stats Panel");
     ImGui::Text("Delta Time: %f", deltaTime);
     ImGui::Text("FPS: %.f", std::clamp(1000 / (deltaTime * 1000), 0.f, 60.f));
+    ImGui::Text("Allocations last step: %zu", physics.GetStepAllocationCount());
     ImGui::End();
 }
 
@@ -1616,7 +1641,7 @@ void ImGuiSceneSelectionPanel(Scene& currentScene)
 	ImGui::End();
 }
 
-void ImGuiBroadPhasePanel(PotentialContact* potentialContact, unsigned int potentialContactsCount, PotentialContactPrimitive* potentialContactPrimitive, unsigned int potentialContactPrimitiveCount)
+void ImGuiBroadPhasePanel(const PhysicsSystem& physics, const PotentialContact* potentialContact, unsigned int potentialContactsCount, const PotentialContactPrimitive* potentialContactPrimitive, unsigned int potentialContactPrimitiveCount)
 {
     ImGui::Begin("Broad Phase");
     //ImGui::Text("Potential Contacts: %d", potentialContactsCount);
@@ -1624,38 +1649,43 @@ void ImGuiBroadPhasePanel(PotentialContact* potentialContact, unsigned int poten
     //{
     //    for (unsigned int i = 0; i < potentialContactsCount; i++)
     //    {
-    //        ImGui::Text("Potential contacts: %s", potentialContact->rigidbodies[0]->name.c_str());
-    //        ImGui::Text("Potential contacts: %s", potentialContact->rigidbodies[1]->name.c_str());
+    //        ImGui::Text("Potential contacts: %s", physics.GetRigidbody(potentialContact->bodies[0])->name.c_str());
+    //        ImGui::Text("Potential contacts: %s", physics.GetRigidbody(potentialContact->bodies[1])->name.c_str());
     //        ImGui::Separator();
     //    }
     //}
     //ImGui::Separator();
     //ImGui::Separator();
-    ImGui::Text("Potential Contacts Primitive: %d", potentialContactPrimitiveCount);
+    ImGui::Text("Potential Contacts Primitive: %d / %d", potentialContactPrimitiveCount, physics.GetPotentialContactPrimitiveCapacity());
+    if (physics.IsPotentialContactPrimitiveTruncated())
+        ImGui::Text("Pairs truncated, the maximum is %d", physics.GetMaxPotentialContacts());
     if (potentialContactPrimitiveCount > 0)
     {
         for (unsigned int i = 0; i < potentialContactPrimitiveCount; i++)
         {
-            ImGui::Text("Potential contacts primitive: %s", potentialContactPrimitive->primitives[0]->rigidbody->name.c_str());
-            ImGui::Text("Potential contacts primitive: %s", potentialContactPrimitive->primitives[1]->rigidbody->name.c_str());
+            ImGui::Text("Potential contacts primitive: %s", physics.GetRigidbody(potentialContactPrimitive[i].primitives[0]->body)->name.c_str());
+            ImGui::Text("Potential contacts primitive: %s", physics.GetRigidbody(potentialContactPrimitive[i].primitives[1]->body)->name.c_str());
             ImGui::Separator();
         }
     }
     ImGui::End();
 }
 
-void ImGuiNarrowPhasePanel(std::vector<std::shared_ptr<Contact>> contacts, int contactCount)
+void ImGuiNarrowPhasePanel(const PhysicsSystem& physics, const Contact* contacts, int contactCount)
 {
     ImGui::Begin("Narrow Phase");
-    ImGui::Text("Contacts: %d", contactCount);
+    ImGui::Text("Contacts: %d / %d", contactCount, physics.GetMaxContacts());
+    if (physics.IsContactTruncated())
+        ImGui::Text("Contacts truncated, raise the maximum with SetMaxContacts");
     if (contactCount > 0)
     {
-        for (auto& contact : contacts)
+        for (int i = 0; i < contactCount; ++i)
         {
             ImGui::Text("Contact");
-            for (auto& rigibody : contact->rigidbodies)
+            for (auto& body : contacts[i].bodies)
             {
-                ImGui::Text("%s", rigibody->name.c_str());
+                if (body.IsValid())
+                    ImGui::Text("%s", physics.GetRigidbody(body)->name.c_str());
             }
             ImGui::Separator();
         }
@@ -22,6 +22,7 @@ target("uqac-physic-engine")
     add_headerfiles("include/**.h", "include/**.hpp", "include/**.inl")
     add_includedirs("include", { public = true })
     add_files("src/**.cpp")
+    add_vectorexts("avx2")
     add_packages("imgui", "opengl", "glfw", "glad", "glm", "stb", { public = true })
 
 --